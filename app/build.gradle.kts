@@ -51,6 +51,10 @@ android {
     buildFeatures {
         viewBinding = true
     }
+    androidResources {
+        // Stored uncompressed so AndroidAssetSource maps them straight from the APK
+        noCompress += listOf("obj", "xml")
+    }
 }
 
 dependencies {
@@ -0,0 +1,205 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "AllocationTracker.h"
+
+#if defined(VPB_TRACK_ALLOCATIONS)
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+/* フックはmalloc内から呼ばれるので、ここではヒープを使わない(TLSも定数初期化できる型だけ) */
+thread_local AllocationCounts tThreadCounts;
+thread_local AllocationScope* tCurrentScope = nullptr;
+
+std::atomic<uint64_t> gTagAllocations[static_cast<int>(AllocationTag::NUM_TAGS)];
+std::atomic<uint64_t> gTagBytes[static_cast<int>(AllocationTag::NUM_TAGS)];
+}
+
+
+/// Called by the allocator hooks below for every allocation
+void
+recordAllocation(size_t size)
+{
+    tThreadCounts.allocations++;
+    tThreadCounts.bytes += size;
+
+    /* 入れ子のスコープは抜けるときに親へ足し込む */
+    if (AllocationScope* scope = tCurrentScope)
+    {
+        scope->mCounts.allocations++;
+        scope->mCounts.bytes += size;
+    }
+}
+
+
+AllocationScope::AllocationScope(AllocationTag tag) : mParent(tCurrentScope), mTag(tag)
+{
+    tCurrentScope = this;
+}
+
+
+AllocationScope::~AllocationScope()
+{
+    tCurrentScope = mParent;
+    if (mParent != nullptr)
+    {
+        mParent->mCounts.allocations += mCounts.allocations;
+        mParent->mCounts.bytes += mCounts.bytes;
+    }
+
+    const int tag = static_cast<int>(mTag);
+    gTagAllocations[tag].fetch_add(mCounts.allocations, std::memory_order_relaxed);
+    gTagBytes[tag].fetch_add(mCounts.bytes, std::memory_order_relaxed);
+}
+
+
+AllocationCounts
+getThreadAllocationCounts()
+{
+    return tThreadCounts;
+}
+
+
+AllocationCounts
+getTagAllocationCounts(AllocationTag tag)
+{
+    AllocationCounts counts;
+    counts.allocations = gTagAllocations[static_cast<int>(tag)].load(std::memory_order_relaxed);
+    counts.bytes = gTagBytes[static_cast<int>(tag)].load(std::memory_order_relaxed);
+    return counts;
+}
+
+
+#if defined(__GLIBC__)
+// glibc host: interpose the C allocator, which also sees operator new and every other library
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void*
+malloc(size_t size)
+{
+    recordAllocation(size);
+    return __libc_malloc(size);
+}
+
+void*
+calloc(size_t count, size_t size)
+{
+    recordAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void*
+realloc(void* ptr, size_t size)
+{
+    recordAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+void
+free(void* ptr)
+{
+    __libc_free(ptr);
+}
+
+/* 境界指定の確保(aligned operator newもaligned_allocを通る)。glibcが公開しているのは__libc_memalignだけ */
+void*
+memalign(size_t alignment, size_t size)
+{
+    recordAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void*
+aligned_alloc(size_t alignment, size_t size)
+{
+    recordAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int
+posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0 || alignment == 0)
+    {
+        return EINVAL;
+    }
+    recordAllocation(size);
+    void* result = __libc_memalign(alignment, size);
+    if (result == nullptr)
+    {
+        return ENOMEM;
+    }
+    *ptr = result;
+    return 0;
+}
+}
+
+#else
+// Android and other platforms: replace the global operator new of this library
+void*
+operator new(size_t size)
+{
+    recordAllocation(size);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void*
+operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void*
+operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    recordAllocation(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void*
+operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void
+operator delete[](void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+#endif // VPB_TRACK_ALLOCATIONS
@@ -0,0 +1,83 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __ALLOCATIONTRACKER_H__
+#define __ALLOCATIONTRACKER_H__
+
+#include <cstddef>
+#include <cstdint>
+
+/// Opt-in heap allocation counting (configure with -DVPB_TRACK_ALLOCATIONS=ON)
+/**
+ * With VPB_TRACK_ALLOCATIONS the allocator is hooked (malloc/calloc/realloc and memalign/posix_memalign/
+ * aligned_alloc on glibc hosts, so C and C++ allocations of every library in the process are seen, only the
+ * obsolete valloc/pvalloc are not; the non-aligned operator new elsewhere) and every
+ * allocation is counted for the calling thread and, inside an AllocationScope, for the scope and its
+ * subsystem tag. Without it AllocationScope is an empty class and all counts are zero, so the
+ * brackets on the render path cost nothing in release builds.
+ */
+
+/// Subsystem an allocation is attributed to
+enum class AllocationTag
+{
+    RENDER_FRAME,
+    CHECK_HIT,
+    NUM_TAGS
+};
+
+/// Number of allocations and requested bytes
+struct AllocationCounts
+{
+    uint64_t allocations{ 0 };
+    uint64_t bytes{ 0 };
+};
+
+#if defined(VPB_TRACK_ALLOCATIONS)
+
+/// Counts the allocations of the current thread while it is alive (scopes nest)
+class AllocationScope
+{
+public:
+    explicit AllocationScope(AllocationTag tag);
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+    /// Allocations made on this thread since the scope was entered
+    const AllocationCounts& getCounts() const { return mCounts; }
+
+private:
+    friend void recordAllocation(size_t size);
+
+    AllocationCounts mCounts;
+    AllocationScope* mParent;
+    AllocationTag mTag;
+};
+
+/// Whether allocation tracking is compiled in
+constexpr bool isAllocationTrackingEnabled() { return true; }
+
+/// Allocations made so far by the calling thread
+AllocationCounts getThreadAllocationCounts();
+
+/// Allocations made so far inside scopes with the given tag, on all threads
+AllocationCounts getTagAllocationCounts(AllocationTag tag);
+
+#else
+
+class AllocationScope
+{
+public:
+    explicit AllocationScope(AllocationTag) {}
+    AllocationCounts getCounts() const { return {}; }
+};
+
+constexpr bool isAllocationTrackingEnabled() { return false; }
+inline AllocationCounts getThreadAllocationCounts() { return {}; }
+inline AllocationCounts getTagAllocationCounts(AllocationTag) { return {}; }
+
+#endif
+
+#endif // __ALLOCATIONTRACKER_H__
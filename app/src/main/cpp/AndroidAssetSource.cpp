@@ -0,0 +1,29 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "AndroidAssetSource.h"
+#include "Log.h"
+
+
+AssetBuffer
+AndroidAssetSource::open(const char* path)
+{
+    AAsset* asset = AAssetManager_open(mAssetManager, path, AASSET_MODE_BUFFER);
+    if (asset == nullptr)
+    {
+        LOG("Error opening asset file %s", path);
+        return AssetBuffer();
+    }
+    /* 圧縮されていないエントリはAPKのマッピングを指す。圧縮されていれば展開済みのバッファ */
+    const void* data = AAsset_getBuffer(asset);
+    if (data == nullptr)
+    {
+        LOG("Error mapping asset file %s", path);
+        AAsset_close(asset);
+        return AssetBuffer();
+    }
+    const size_t size = static_cast<size_t>(AAsset_getLength64(asset));
+    std::shared_ptr<const void> owner(asset, [](const void* handle) { AAsset_close(static_cast<AAsset*>(const_cast<void*>(handle))); });
+    return AssetBuffer(std::move(owner), static_cast<const char*>(data), size);
+}
@@ -0,0 +1,31 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __ANDROIDASSETSOURCE_H__
+#define __ANDROIDASSETSOURCE_H__
+
+#include "AssetSource.h"
+
+#include <android/asset_manager.h>
+
+/// AssetSource on the APK assets, without copying them
+/**
+ * Assets are opened with AASSET_MODE_BUFFER and exposed through AAsset_getBuffer(): an entry stored
+ * uncompressed in the APK (noCompress in build.gradle.kts, and formats like PNG and JPEG) is mapped
+ * directly from the APK, a compressed one is inflated once by the framework into a buffer owned by the
+ * AAsset. The AAsset is closed with the last AssetBuffer referring to it.
+ */
+class AndroidAssetSource : public AssetSource
+{
+public:
+    /// assetManager must outlive the source (the one of the Activity, held by Kotlin)
+    explicit AndroidAssetSource(AAssetManager* assetManager) : mAssetManager(assetManager) {}
+
+    AssetBuffer open(const char* path) override;
+
+private:
+    AAssetManager* mAssetManager;
+};
+
+#endif // __ANDROIDASSETSOURCE_H__
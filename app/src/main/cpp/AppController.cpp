@@ -8,6 +8,8 @@ countries.
 #include "AppController.h"
 
 #include "Log.h"
+#include "Tracer.h"
+#include "VuforiaMath.h"
 
 #include <algorithm>
 #include <cassert>
@@ -30,6 +32,36 @@ constexpr char licenseKey[] = "";
 
 constexpr float NEAR_PLANE = 0.01f;
 constexpr float FAR_PLANE = 5.f;
+
+/// Viewport (x, y, width, height, near, far) of a render state
+void
+getViewport(const VuRenderState& renderState, double* viewport)
+{
+    viewport[0] = renderState.viewport.data[0];
+    viewport[1] = renderState.viewport.data[1];
+    viewport[2] = renderState.viewport.data[2];
+    viewport[3] = renderState.viewport.data[3];
+    viewport[4] = 0.0f;
+    viewport[5] = 1.0f;
+}
+
+/// Scale from the unit quad to the size of a marker, z is set to the larger dimension so that
+/// a 3D augmentation can be shown on a planar target
+VuVector3F
+getMarkerScale(const VuVector2F& markerSize)
+{
+    VuVector3F scale;
+    scale.data[0] = markerSize.data[0];
+    scale.data[1] = markerSize.data[1];
+    scale.data[2] = std::max(scale.data[0], scale.data[1]);
+    return scale;
+}
+
+int64_t
+getSteadyTimeNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 }
 
 
@@ -49,6 +81,7 @@ constexpr float FAR_PLANE = 5.f;
 void
 AppController::initAR(const InitConfig& initConfig, int target)
 {
+    VPB_TRACE_SCOPE("AppController::initAR");
     mVbRenderBackend = initConfig.vbRenderBackend;
     mErrorMessageCallback = initConfig.errorMessageCallback;
     mVuforeEngineErrorCallback = initConfig.vuforiaEngineErrorCallback;
@@ -57,12 +90,21 @@ AppController::initAR(const InitConfig& initConfig, int target)
 
     mGuideViewModelTarget = nullptr;
 
-    if (!initVuforiaInternal(initConfig.appData))
+    StartupTimeline* timeline = initConfig.timeline;
+    int phase = timeline != nullptr ? timeline->begin("create engine") : StartupTimeline::NO_PHASE;
+    const bool engineCreated = initVuforiaInternal(initConfig.appData);
+    if (timeline != nullptr)
+        timeline->end(phase);
+    if (!engineCreated)
     {
         return;
     }
 
-    if (!createObservers())
+    phase = timeline != nullptr ? timeline->begin("create observers") : StartupTimeline::NO_PHASE;
+    const bool observersCreated = createObservers();
+    if (timeline != nullptr)
+        timeline->end(phase);
+    if (!observersCreated)
     {
         return;
     }
@@ -286,51 +328,176 @@ AppController::getVideoBackgroundTextureSize(VuVector2I& textureSize)
 
 
 bool
-AppController::prepareToRender(double* viewport, VuRenderVideoBackgroundData* renderData)
+AppController::updateTrackingFrame(TrackingFrame& frame)
 {
-    if (vuEngineAcquireLatestState(mEngine, &mVuforiaState) != VU_SUCCESS)
+    VPB_TRACE_SCOPE("AppController::updateTrackingFrame");
+    releaseTrackingFrame(frame);
+
+    VuState* state = nullptr;
+    if (vuEngineAcquireLatestState(mEngine, &state) != VU_SUCCESS)
     {
         LOG("Error getting state");
         return false;
     }
+    return fillTrackingFrame(state, getSteadyTimeNs(), frame);
+}
+
 
-    if (vuStateHasCameraFrame(mVuforiaState) != VU_TRUE)
+bool
+AppController::updateTrackingFrameIfNew(TrackingFrame& frame, int64_t lastCameraFrameIndex)
+{
+    VuState* state = nullptr;
+    if (vuEngineAcquireLatestState(mEngine, &state) != VU_SUCCESS)
     {
+        LOG("Error getting state");
         return false;
     }
+    const int64_t acquireTime = getSteadyTimeNs();
 
-    if (vuStateGetRenderState(mVuforiaState, &mCurrentRenderState) != VU_SUCCESS)
+    /* 同じカメラフレームなら姿勢の計算をせず、すぐに手放す */
+    VuCameraFrame* cameraFrame = nullptr;
+    int64_t cameraFrameIndex = -1;
+    if (vuStateGetCameraFrame(state, &cameraFrame) != VU_SUCCESS || vuCameraFrameGetIndex(cameraFrame, &cameraFrameIndex) != VU_SUCCESS ||
+        cameraFrameIndex == lastCameraFrameIndex)
     {
-        LOG("Error getting render state");
+        vuStateRelease(state);
         return false;
     }
 
-    if (!mCurrentRenderState.vbMesh)
+    VPB_TRACE_SCOPE("AppController::updateTrackingFrameIfNew");
+    releaseTrackingFrame(frame);
+    return fillTrackingFrame(state, acquireTime, frame);
+}
+
+
+bool
+AppController::fillTrackingFrame(VuState* state, int64_t acquireTime, TrackingFrame& frame)
+{
+    frame.acquireTime = acquireTime;
+
+    VuCameraFrame* cameraFrame = nullptr;
+    if (vuStateGetCameraFrame(state, &cameraFrame) != VU_SUCCESS ||
+        vuCameraFrameGetIndex(cameraFrame, &frame.cameraFrameIndex) != VU_SUCCESS ||
+        vuCameraFrameGetTimestamp(cameraFrame, &frame.cameraTimestamp) != VU_SUCCESS ||
+        vuStateGetRenderState(state, &frame.renderState) != VU_SUCCESS || !frame.renderState.vbMesh)
     {
+        vuStateRelease(state);
         return false;
     }
+    frame.state = state;
 
-    viewport[0] = mCurrentRenderState.viewport.data[0];
-    viewport[1] = mCurrentRenderState.viewport.data[1];
-    viewport[2] = mCurrentRenderState.viewport.data[2];
-    viewport[3] = mCurrentRenderState.viewport.data[3];
-    viewport[4] = 0.0f;
-    viewport[5] = 1.0f;
+    updateDevicePose(state);
+    checkRelocalization();
+
+    /* 予測しない間は履歴も取らない(再開時に古い姿勢から速度を出さないため) */
+    const bool predict = mPosePredictionEnabled.load(std::memory_order_relaxed);
+    /* 描画がカメラより速いと同じカメラフレームを何度も受け取る。履歴に足すのは新しいフレームだけ */
+    const bool newCameraFrame = frame.cameraFrameIndex != mLastPredictedCameraFrameIndex || frame.cameraTimestamp != mLastPredictedCameraTimestamp;
+    mLastPredictedCameraFrameIndex = frame.cameraFrameIndex;
+    mLastPredictedCameraTimestamp = frame.cameraTimestamp;
+    frame.devicePose = mLatestDevicePoseData.pose;
 
-    if (vuRenderControllerUpdateVideoBackgroundTexture(mRenderController, mVuforiaState, renderData) != VU_SUCCESS)
+    if (mTarget != IMAGE_TARGET_ID || mImageTargetObservations == nullptr ||
+        vuStateGetImageTargetObservations(state, mImageTargetObservations) != VU_SUCCESS)
+    {
+        return true;
+    }
+
+    int numObservations = 0;
+    REQUIRE_SUCCESS(vuObservationListGetSize(mImageTargetObservations, &numObservations));
+    for (int idx = 0; idx < numObservations && frame.numTargets < TargetRegistry::MAX_TARGETS; idx++)
+    {
+        VuObservation* observation = nullptr;
+        if (vuObservationListGetElement(mImageTargetObservations, idx, &observation) != VU_SUCCESS)
+            continue;
+
+        int targetId = getTargetId(observation);
+        if (targetId == TargetRegistry::INVALID_ID)
+            continue;
+
+        TrackingFrame::Target& target = frame.targets[frame.numTargets];
+        const glm::vec2& targetSize = mTargets.targetSize(targetId);
+        target.targetId = targetId;
+        target.markerSize = VuVector2F{ .data{ targetSize.x, targetSize.y } };
+        if (computeImageTargetPose(frame.renderState, observation, target.markerSize, target.modelView, target.scaledModelView))
+        {
+            if (!predict)
+                target.motion = PoseMotion{};
+            else if (newCameraFrame)
+                target.motion = mPosePredictor.update(targetId, target.modelView.data, frame.cameraTimestamp);
+            else
+                target.motion = mPosePredictor.getMotion(targetId);
+            frame.numTargets++;
+        }
+    }
+    return true;
+}
+
+
+void
+AppController::releaseTrackingFrame(TrackingFrame& frame)
+{
+    if (frame.state != nullptr && vuStateRelease(frame.state) != VU_SUCCESS)
+    {
+        LOG("Error releasing the Vuforia state");
+    }
+    frame.state = nullptr;
+    frame.cameraFrameIndex = -1;
+    frame.numTargets = 0;
+}
+
+
+void
+AppController::setPosePrediction(bool enabled, int displayLatencyMs)
+{
+    mDisplayLatencyNs.store(static_cast<int64_t>(std::max(displayLatencyMs, 0)) * 1000000, std::memory_order_relaxed);
+    mPosePredictionEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+float
+AppController::getPredictionHorizon(const TrackingFrame& frame) const
+{
+    if (!mPosePredictionEnabled.load(std::memory_order_relaxed) || frame.state == nullptr)
+        return 0.0f;
+
+    /* カメラの時刻はsteady_clockと同じ時計とは限らないので、取得からの経過時間だけ実測する */
+    const int64_t horizonNs = getSteadyTimeNs() - frame.acquireTime + mDisplayLatencyNs.load(std::memory_order_relaxed);
+    return static_cast<float>(horizonNs) * 1e-9f;
+}
+
+
+void
+AppController::predictTargetPose(const TrackingFrame::Target& target, float horizon, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix)
+{
+    PosePredictor::extrapolate(target.modelView.data, target.motion, horizon, modelViewMatrix.data);
+    scaledModelViewMatrix = scaleMatrix(getMarkerScale(target.markerSize), modelViewMatrix);
+}
+
+
+bool
+AppController::prepareToRender(const TrackingFrame& frame, double* viewport, VuRenderVideoBackgroundData* renderData)
+{
+    VPB_TRACE_SCOPE("AppController::prepareToRender");
+    if (frame.state == nullptr)
     {
-        LOG("Error updating video background texture");
         return false;
     }
 
-    updateDevicePose();
+    getViewport(frame.renderState, viewport);
+
+    if (vuRenderControllerUpdateVideoBackgroundTexture(mRenderController, frame.state, renderData) != VU_SUCCESS)
+    {
+        LOG("Error updating video background texture");
+        return false;
+    }
 
     return true;
 }
 
 
 void
-AppController::finishRender()
+AppController::checkRelocalization()
 {
     // Check for device tracker relocalizing for too long and reset if needed
     if (mLatestDevicePoseData.poseStatus == VU_OBSERVATION_POSE_STATUS_LIMITED &&
@@ -358,80 +525,39 @@ AppController::finishRender()
     {
         mTimingRelocalizingState = false;
     }
-
-    // Clean up and release the Vuforia state
-    if (mVuforiaState != nullptr && vuStateRelease(mVuforiaState) != VU_SUCCESS)
-    {
-        LOG("Error releasing the Vuforia state");
-    }
-    mVuforiaState = nullptr;
-}
-
-
-bool
-AppController::getOrigin(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix)
-{
-    if (mLatestDevicePoseData.poseStatus != VU_OBSERVATION_POSE_STATUS_NO_POSE)
-    {
-        projectionMatrix = mCurrentRenderState.projectionMatrix;
-        modelViewMatrix = mCurrentRenderState.viewMatrix;
-        return true;
-    }
-
-    return false;
 }
 
-std::pair<std::unique_ptr<VuObservationList, decltype(&vuObservationListDestroy)>, int>
-AppController::createImageTargetList() {
-    VuObservationList* observationList = nullptr;
-    REQUIRE_SUCCESS(vuObservationListCreate(&observationList));
-
-    if (vuStateGetImageTargetObservations(mVuforiaState, observationList) != VU_SUCCESS) {
-        LOG("Error getting image target observations");
-        REQUIRE_SUCCESS(vuObservationListDestroy(observationList));
-        std::unique_ptr<VuObservationList, decltype(&vuObservationListDestroy)> _null_ptr_(nullptr, &vuObservationListDestroy);
-        return std::make_pair(std::move(_null_ptr_), 0);
-    }
-
-    int numObservations = 0;
-    REQUIRE_SUCCESS(vuObservationListGetSize(observationList, &numObservations));
-
-    std::unique_ptr<VuObservationList, decltype(&vuObservationListDestroy)> retptr(observationList, &vuObservationListDestroy);
-    return std::make_pair(std::move(retptr), numObservations);
-}
 
 bool
-AppController::getImageTargetResult(const VuObservation* observation, const VuVector2F& markerSize, VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix)
+AppController::computeImageTargetPose(const VuRenderState& renderState, const VuObservation* observation, const VuVector2F& markerSize,
+                                      VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix)
 {
-    if (mTarget != IMAGE_TARGET_ID)
-        return false;
-
     VuPoseInfo poseInfo;
     REQUIRE_SUCCESS(vuObservationGetPoseInfo(observation, &poseInfo));
 
     if (poseInfo.poseStatus == VU_OBSERVATION_POSE_STATUS_NO_POSE)
         return false;
 
-    projectionMatrix = mCurrentRenderState.projectionMatrix;
-
     // Compute model-view matrix
     auto modelMatrix = poseInfo.pose;
-    modelViewMatrix = vuMatrix44FMultiplyMatrix(mCurrentRenderState.viewMatrix, modelMatrix);
+    modelViewMatrix = multiplyMatrix(renderState.viewMatrix, modelMatrix);
 
     // Calculate a scaled modelViewMatrix for rendering a unit bounding box
-    // z-dimension will be zero for planar target
-    // set it here to the larger dimension so that
-    // a 3D augmentation can be shown
-    VuVector3F scale;
-    scale.data[0] = markerSize.data[0];
-    scale.data[1] = markerSize.data[1];
-    scale.data[2] = std::max(scale.data[0], scale.data[1]);
-    scaledModelViewMatrix = vuMatrix44FScale(scale, modelViewMatrix);
+    scaledModelViewMatrix = scaleMatrix(getMarkerScale(markerSize), modelViewMatrix);
 
     return true;
 }
 
 
+const char*
+AppController::getTargetName(int targetId) const
+{
+    if (targetId < 0 || targetId >= getTargetCount())
+        return nullptr;
+    return mTargets.name(targetId).c_str();
+}
+
+
 /*===============================================================================
  AppController private methods
  ===============================================================================*/
@@ -710,6 +836,11 @@ AppController::initErrorToString(VuErrorCode error)
 bool
 AppController::createObservers()
 {
+    VPB_TRACE_SCOPE("AppController::createObservers");
+    // Observation lists filled every frame by updateTrackingFrame and updateDevicePose
+    REQUIRE_SUCCESS(vuObservationListCreate(&mImageTargetObservations));
+    REQUIRE_SUCCESS(vuObservationListCreate(&mDevicePoseObservations));
+
     auto devicePoseConfig = vuDevicePoseConfigDefault();
     VuDevicePoseCreationError devicePoseCreationError;
     if (vuEngineCreateDevicePoseObserver(mEngine, &mDevicePoseObserver, &devicePoseConfig, &devicePoseCreationError) != VU_SUCCESS)
@@ -748,6 +879,19 @@ AppController::createObservers()
             vuObserverActivate(observer);
 
             mObjectObservers.push_back(observer);
+
+            /* ターゲットIDを登録(名前・サイズは毎フレーム問い合わせずにここで控えておく) */
+            const char* uniqueId = nullptr;
+            VuVector2F targetSize{};
+            REQUIRE_SUCCESS(vuImageTargetObserverGetTargetUniqueId(observer, &uniqueId));
+            REQUIRE_SUCCESS(vuImageTargetObserverGetTargetSize(observer, &targetSize));
+            if (mTargets.add(imageTargetConfig.targetName, uniqueId, vuObserverGetId(observer),
+                             glm::vec2(targetSize.data[0], targetSize.data[1])) != static_cast<int>(mObjectObservers.size()) - 1)
+            {
+                LOG("Error registering image target %s", imageTargetConfig.targetName);
+                mErrorMessageCallback("Error registering image target");
+                return false;
+            }
         }
     }
     else
@@ -782,26 +926,34 @@ AppController::destroyObservers()
         }
     }
     mObjectObservers.clear();
+    mTargets.clear();
 
     if (mDevicePoseObserver != nullptr && vuObserverDestroy(mDevicePoseObserver) != VU_SUCCESS)
     {
         LOG("Error destroying object observer");
     }
     mDevicePoseObserver = nullptr;
+
+    for (auto observationList : { &mImageTargetObservations, &mDevicePoseObservations })
+    {
+        if (*observationList != nullptr && vuObservationListDestroy(*observationList) != VU_SUCCESS)
+        {
+            LOG("Error destroying observation list");
+        }
+        *observationList = nullptr;
+    }
 }
 
 
 void
-AppController::updateDevicePose()
+AppController::updateDevicePose(const VuState* state)
 {
     mLatestDevicePoseData.pose = vuIdentityMatrix44F();
     mLatestDevicePoseData.poseStatus = VU_OBSERVATION_POSE_STATUS_NO_POSE;
     mLatestDevicePoseData.poseStatusInfo = VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_NORMAL;
 
-    VuObservationList* observationList = nullptr;
-    REQUIRE_SUCCESS(vuObservationListCreate(&observationList));
-
-    if (vuStateGetDevicePoseObservations(mVuforiaState, observationList) == VU_SUCCESS)
+    VuObservationList* observationList = mDevicePoseObservations;
+    if (observationList != nullptr && vuStateGetDevicePoseObservations(state, observationList) == VU_SUCCESS)
     {
         int numObservations = 0;
         REQUIRE_SUCCESS(vuObservationListGetSize(observationList, &numObservations));
@@ -834,6 +986,4 @@ AppController::updateDevicePose()
     {
         LOG("Error getting device pose observations");
     }
-
-    REQUIRE_SUCCESS(vuObservationListDestroy(observationList));
 }
@@ -8,8 +8,13 @@ countries.
 #ifndef __APPCONTROLLER_H__
 #define __APPCONTROLLER_H__
 
+#include "PosePredictor.h"
+#include "StartupTimeline.h"
+#include "TargetRegistry.h"
+
 #include <VuforiaEngine/VuforiaEngine.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdio>
 #include <functional>
@@ -32,6 +37,42 @@ public:
     using VuforiaEngineErrorCallback = std::function<void(VuErrorCode errorCode)>;
     using InitDoneCallback = std::function<void()>;
 
+    /// Device pose and poses of the tracked Image Targets in one Vuforia state, filled by updateTrackingFrame
+    /**
+     * Lifecycle of a frame: updateTrackingFrame acquires the latest state into it (on the render thread
+     * or the TrackingThread), prepareToRender updates the video background from the same camera frame on
+     * the render thread, and releaseTrackingFrame (or the next updateTrackingFrame) releases the state.
+     * All targets use renderState.projectionMatrix. The motions are only valid while pose prediction is
+     * enabled (see setPosePrediction).
+     */
+    struct TrackingFrame
+    {
+        struct Target
+        {
+            int32_t targetId{ 0 };
+            VuVector2F markerSize{};
+            VuMatrix44F modelView{};
+            VuMatrix44F scaledModelView{};
+            /// Velocity of modelView in camera space
+            PoseMotion motion{};
+        };
+
+        /// State the frame was computed from, nullptr if it holds none
+        VuState* state{ nullptr };
+        /// Index of the camera frame in state
+        int64_t cameraFrameIndex{ -1 };
+        /// Capture time of the camera frame in state (ns, camera clock)
+        int64_t cameraTimestamp{ 0 };
+        /// steady_clock time when state was acquired (ns)
+        int64_t acquireTime{ 0 };
+        /// Device pose of the camera frame (identity if there is none)
+        VuMatrix44F devicePose{};
+        /// Render state of state, vbMesh is owned by state
+        VuRenderState renderState{};
+        int numTargets{ 0 };
+        Target targets[TargetRegistry::MAX_TARGETS]{};
+    };
+
     /// Struct to group initialization parameters passed to initAR
     class InitConfig
     {
@@ -41,6 +82,8 @@ public:
         ErrorMessageCallback errorMessageCallback{};
         VuforiaEngineErrorCallback vuforiaEngineErrorCallback{};
         InitDoneCallback initDoneCallback{};
+        /// Records the engine creation and observer phases if set
+        StartupTimeline* timeline{ nullptr };
     };
 
 
@@ -80,27 +123,48 @@ public:
     /// Query whether the camera is currently started
     bool isARStarted() { return mARStarted; }
 
-    /// Call this method at the start of Vuforia rendering.
-    /// Gets the latest video background texture from Vuforia.
-    /// Whatever the result of this call finishRender must be called before rendering completes.
-    bool prepareToRender(double* viewport, VuRenderVideoBackgroundData* renderData);
+    /// Acquire the latest Vuforia state and compute the device pose and the Image Target poses into frame.
+    /// Releases the state previously held by frame and updates the relocalization timer.
+    /// Returns false (and frame holds no state) if there is no camera frame to render.
+    /// May run on a thread other than the render thread, but only on one thread at a time.
+    bool updateTrackingFrame(TrackingFrame& frame);
+
+    /// updateTrackingFrame for a poller: if the latest camera frame is still lastCameraFrameIndex, release the
+    /// state right after reading its index and return false, leaving frame untouched.
+    /// Returns true if frame was refilled with a new camera frame.
+    bool updateTrackingFrameIfNew(TrackingFrame& frame, int64_t lastCameraFrameIndex);
+
+    /// Release the state held by frame, once the frame has been rendered or is replaced
+    void releaseTrackingFrame(TrackingFrame& frame);
+
+    /// Render thread counterpart of updateTrackingFrame: get the viewport and update the video
+    /// background texture from the camera frame in frame. frame keeps holding its state until it
+    /// is released or refilled by updateTrackingFrame.
+    bool prepareToRender(const TrackingFrame& frame, double* viewport, VuRenderVideoBackgroundData* renderData);
+
+    /// Extrapolate the poses of the following frames to the time they are expected on the display.
+    /// displayLatencyMs is the part of the motion-to-photon latency that cannot be measured here
+    /// (camera exposure to acquire, and swap to photon). May be called from any thread.
+    void setPosePrediction(bool enabled, int displayLatencyMs);
 
-    /// Call this method when Vuforia rendering is complete, this should be near the end of the
-    /// platform render callback.
-    void finishRender();
+    /// How far ahead (s) the poses of frame should be drawn if it is rendered now: the time since
+    /// it was acquired plus the configured display latency, 0 if pose prediction is disabled
+    float getPredictionHorizon(const TrackingFrame& frame) const;
 
-    /// Get the current RenderState
-    /// The returned object is only valid after prepareToRender has been called
-    const VuRenderState& getRenderState() { return mCurrentRenderState; }
+    /// Extrapolate the model-view matrices of target by horizon seconds (see getPredictionHorizon)
+    static void predictTargetPose(const TrackingFrame::Target& target, float horizon, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix);
 
-    /// Get rendering information for the world origin position.
-    /// Returns false if the world origin position is not currently available.
-    bool getOrigin(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix);
+    /// Number of Image Targets. Target IDs are 0..getTargetCount()-1 in the order the observers were created.
+    int getTargetCount() const { return mTargets.size(); }
 
-    /// Get rendering information for the Image Target.
-    /// Returns false if Vuforia isn't currently tracking the Image Target.
-    std::pair<std::unique_ptr<VuObservationList, decltype(&vuObservationListDestroy)>, int> createImageTargetList();
-    bool getImageTargetResult(const VuObservation* observation, const VuVector2F& markerSize, VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix);
+    /// Get the name of the Image Target with the given ID, nullptr if the ID is out of range
+    const char* getTargetName(int targetId) const;
+
+    /// Get the target ID of an Image Target observation, -1 if the observer is unknown
+    int getTargetId(const VuObservation* observation) const { return mTargets.findByObserverId(vuObservationGetObserverId(observation)); }
+
+    /// Get the registry of the Image Targets, built in createObservers
+    const TargetRegistry& getTargetRegistry() const { return mTargets; }
 
     /// Get the PlatformController handle.
     /// The result is only valid after initAR is called and before deinitAR is called.
@@ -128,8 +192,18 @@ private: // methods
     /// Clean up Observers created by createObservers
     void destroyObservers();
 
-    /// Called in prepareToRender to update the cached device pose information
-    void updateDevicePose();
+    /// Fill frame (holding no state) from state, acquired at acquireTime. Takes over state, released on failure.
+    bool fillTrackingFrame(VuState* state, int64_t acquireTime, TrackingFrame& frame);
+
+    /// Called in updateTrackingFrame to update the cached device pose information
+    void updateDevicePose(const VuState* state);
+
+    /// Called in updateTrackingFrame to reset world tracking after relocalizing for too long
+    void checkRelocalization();
+
+    /// Compute the model-view matrices of an Image Target observation, false if it has no pose
+    bool computeImageTargetPose(const VuRenderState& renderState, const VuObservation* observation, const VuVector2F& markerSize,
+                                VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix);
 
 private: // data members
     /// Callback to inform the user of synchronous Vuforia Engine creation errors
@@ -160,14 +234,16 @@ private: // data members
     /// Flag that is true when Vuforia is running
     bool mARStarted = false;
 
-    /// Local copy of current RenderState
-    VuRenderState mCurrentRenderState;
     /// Remember the display aspect ratio for later configuration of Guide View rendering
     float mDisplayAspectRatio;
 
     /// The observer for device poses
     VuObserver* mDevicePoseObserver = nullptr;
 
+    /// Observation lists reused every frame, created with the observers
+    VuObservationList* mImageTargetObservations = nullptr;
+    VuObservationList* mDevicePoseObservations = nullptr;
+
     /// Data structure with information about the last known device pose
     struct DevicePoseData
     {
@@ -182,6 +258,15 @@ private: // data members
     };
     DevicePoseData mLatestDevicePoseData{};
 
+    /// Pose history of the targets, only used by updateTrackingFrame
+    PosePredictor mPosePredictor;
+    /// Camera frame last seen by updateTrackingFrame, repeated frames are not added to mPosePredictor
+    int64_t mLastPredictedCameraFrameIndex{ -1 };
+    int64_t mLastPredictedCameraTimestamp{ 0 };
+    /// Set by setPosePrediction
+    std::atomic<bool> mPosePredictionEnabled{ false };
+    std::atomic<int64_t> mDisplayLatencyNs{ 0 };
+
     /// Flag set when the tracker is relocalizing
     bool mTimingRelocalizingState{ false };
     /// The time when the tracker entered the relocalizing state
@@ -192,8 +277,8 @@ private: // data members
     /// The observer for either the Image or Model target depending on which target was specified
     std::vector<VuObserver*> mObjectObservers;
 
-    /// Between calls to prepareToRender and finishRender this holds a copy of the Vuforia state.
-    VuState* mVuforiaState = nullptr;
+    /// Dense IDs, names and sizes of the Image Targets in mObjectObservers
+    TargetRegistry mTargets;
 
     /// If a Model Target Guide View should be displayed this points to the object providing
     /// details of what the App should render.
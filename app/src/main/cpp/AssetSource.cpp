@@ -0,0 +1,65 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "AssetSource.h"
+
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+/// Stands in for the data of empty assets, mmap cannot map 0 bytes
+constexpr char EMPTY_DATA[1] = {};
+}
+
+
+AssetBuffer
+AssetBuffer::subBuffer(size_t offset, size_t length) const
+{
+    offset = std::min(offset, mSize);
+    return AssetBuffer(mOwner, mData + offset, std::min(length, mSize - offset));
+}
+
+
+AssetBuffer
+PosixAssetSource::open(const char* path)
+{
+    return mapFile((mRootDirectory + "/" + path).c_str());
+}
+
+
+AssetBuffer
+PosixAssetSource::mapFile(const char* path)
+{
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return AssetBuffer();
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        close(fd);
+        return AssetBuffer();
+    }
+    const size_t size = static_cast<size_t>(status.st_size);
+    if (size == 0)
+    {
+        close(fd);
+        return AssetBuffer(std::shared_ptr<const void>(EMPTY_DATA, [](const void*) {}), EMPTY_DATA, 0);
+    }
+
+    /* マッピングはfdを閉じても残る。解放は最後のAssetBufferが消えたとき */
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return AssetBuffer();
+
+    std::shared_ptr<const void> owner(mapping, [size](const void* address) { munmap(const_cast<void*>(address), size); });
+    return AssetBuffer(std::move(owner), static_cast<const char*>(mapping), size);
+}
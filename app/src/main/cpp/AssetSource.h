@@ -0,0 +1,68 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __ASSETSOURCE_H__
+#define __ASSETSOURCE_H__
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/// Read-only view of the bytes of an opened asset, valid as long as any copy of it exists
+/**
+ * The bytes are not copied: they stay in the mapping (or the buffer of the platform) that owns them,
+ * and the last AssetBuffer referring to it releases it. Copies and subBuffer() views are cheap, they
+ * only share the owner. A default constructed buffer is invalid, an empty asset is valid with size 0.
+ */
+class AssetBuffer
+{
+public:
+    AssetBuffer() = default;
+
+    /// View of size bytes at data, owner keeps them alive (its deleter unmaps / closes)
+    AssetBuffer(std::shared_ptr<const void> owner, const char* data, size_t size) : mOwner(std::move(owner)), mData(data), mSize(size) {}
+
+    bool isValid() const { return mOwner != nullptr; }
+
+    const char* data() const { return mData; }
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    const char* begin() const { return mData; }
+    const char* end() const { return mData + mSize; }
+
+    /// View of [offset, offset + length) of this buffer sharing its owner, clamped to the buffer
+    AssetBuffer subBuffer(size_t offset, size_t length) const;
+
+private:
+    std::shared_ptr<const void> mOwner;
+    const char* mData{ nullptr };
+    size_t mSize{ 0 };
+};
+
+/// Opens assets by their path relative to the asset root, from any thread
+class AssetSource
+{
+public:
+    virtual ~AssetSource() = default;
+
+    /// The whole asset, an invalid buffer if it does not exist or cannot be mapped
+    virtual AssetBuffer open(const char* path) = 0;
+};
+
+/// AssetSource on a directory, files are mapped read-only with mmap (Linux host tools)
+class PosixAssetSource : public AssetSource
+{
+public:
+    explicit PosixAssetSource(std::string rootDirectory) : mRootDirectory(std::move(rootDirectory)) {}
+
+    AssetBuffer open(const char* path) override;
+
+    /// Map a file by its full path
+    static AssetBuffer mapFile(const char* path);
+
+private:
+    std::string mRootDirectory;
+};
+
+#endif // __ASSETSOURCE_H__
@@ -0,0 +1,73 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "CpuTopology.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <unistd.h>
+
+
+namespace
+{
+/// cpuinfo_max_freq of cpu in kHz, 0 if there is no cpufreq
+uint32_t
+readMaxFrequency(int cpu)
+{
+    char path[96];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+        return 0;
+    unsigned int frequency = 0;
+    if (fscanf(file, "%u", &frequency) != 1)
+        frequency = 0;
+    fclose(file);
+    return frequency;
+}
+}
+
+
+const CpuTopology&
+CpuTopology::get()
+{
+    static const CpuTopology topology = detect();
+    return topology;
+}
+
+
+CpuTopology
+CpuTopology::detect()
+{
+    CpuTopology topology;
+    topology.numCpus = std::clamp(static_cast<int>(sysconf(_SC_NPROCESSORS_CONF)), 1, MAX_CPUS);
+
+    /* オフラインのコアもcpufreqは読めるので、構成上の全コアで分類する */
+    uint32_t lowestFrequency = UINT32_MAX;
+    for (int cpu = 0; cpu < topology.numCpus; cpu++)
+    {
+        topology.maxFrequencyKHz[cpu] = readMaxFrequency(cpu);
+        if (topology.maxFrequencyKHz[cpu] != 0)
+            lowestFrequency = std::min(lowestFrequency, topology.maxFrequencyKHz[cpu]);
+    }
+    const bool singleCluster = std::all_of(topology.maxFrequencyKHz, topology.maxFrequencyKHz + topology.numCpus,
+                                           [lowestFrequency](uint32_t frequency) { return frequency == 0 || frequency == lowestFrequency; });
+
+    for (int cpu = 0; cpu < topology.numCpus; cpu++)
+    {
+        const bool little = !singleCluster && topology.maxFrequencyKHz[cpu] == lowestFrequency;
+        if (little)
+        {
+            topology.littleCpuMask |= 1ULL << cpu;
+            topology.numLittleCpus++;
+        }
+        else
+        {
+            topology.bigCpuMask |= 1ULL << cpu;
+            topology.numBigCpus++;
+        }
+    }
+    return topology;
+}
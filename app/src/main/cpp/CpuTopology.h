@@ -0,0 +1,37 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __CPUTOPOLOGY_H__
+#define __CPUTOPOLOGY_H__
+
+#include <cstdint>
+
+/// CPU cores of the device split into big and little cores (big.LITTLE / DynamIQ clusters)
+/**
+ * Read from /sys/devices/system/cpu: a core is little when its maximum frequency is the lowest of
+ * the device, every faster cluster (big and prime) counts as big. Without cpufreq (most Linux hosts,
+ * emulators) or with a single cluster all cores are big.
+ */
+struct CpuTopology
+{
+    /// Cores beyond this are ignored, the masks are 64 bit
+    static constexpr int MAX_CPUS = 64;
+
+    int numCpus{ 0 };
+    int numBigCpus{ 0 };
+    int numLittleCpus{ 0 };
+    /// Bit n set for CPU n
+    uint64_t bigCpuMask{ 0 };
+    uint64_t littleCpuMask{ 0 };
+    /// cpuinfo_max_freq of each CPU (kHz), 0 when unknown
+    uint32_t maxFrequencyKHz[MAX_CPUS]{};
+
+    /// Topology of the device, read once
+    static const CpuTopology& get();
+
+    /// Read the topology from sysfs
+    static CpuTopology detect();
+};
+
+#endif // __CPUTOPOLOGY_H__
@@ -0,0 +1,32 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+
+FrameArena::FrameArena(size_t capacity) : mBuffer(new unsigned char[capacity]), mCapacity(capacity)
+{
+}
+
+
+void*
+FrameArena::allocate(size_t size, size_t alignment)
+{
+    /* alignmentは2のべき乗 */
+    const uintptr_t base = reinterpret_cast<uintptr_t>(mBuffer.get());
+    const uintptr_t aligned = (base + mOffset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    const size_t offset = aligned - base;
+    if (offset > mCapacity || size > mCapacity - offset)
+    {
+        mFailedAllocations++;
+        return nullptr;
+    }
+
+    mOffset = offset + size;
+    mHighWater = std::max(mHighWater, mOffset);
+    return mBuffer.get() + offset;
+}
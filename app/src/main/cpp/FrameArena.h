@@ -0,0 +1,55 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __FRAMEARENA_H__
+#define __FRAMEARENA_H__
+
+#include <cstddef>
+#include <memory>
+
+/// Bump allocator for transient data that only lives for one frame
+/**
+ * The buffer is allocated once in the constructor. allocate() just advances an offset and reset()
+ * (called once per frame, at the end of the frame) releases everything at once, so the render path
+ * does no heap allocations in the steady state. Destructors are never run: only use it for trivially
+ * destructible data.
+ */
+class FrameArena
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// Allocate size bytes, nullptr if the arena is full (counted in getFailedAllocations)
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    /// Allocate an uninitialized array of count elements, nullptr if the arena is full
+    template<typename T>
+    T* allocateArray(size_t count)
+    {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /// Release every allocation of the frame
+    void reset() { mOffset = 0; }
+
+    size_t getCapacity() const { return mCapacity; }
+    size_t getUsed() const { return mOffset; }
+    /// Largest getUsed() seen so far, to size the arena
+    size_t getHighWater() const { return mHighWater; }
+    size_t getFailedAllocations() const { return mFailedAllocations; }
+
+private:
+    std::unique_ptr<unsigned char[]> mBuffer;
+    size_t mCapacity;
+    size_t mOffset{ 0 };
+    size_t mHighWater{ 0 };
+    size_t mFailedAllocations{ 0 };
+};
+
+#endif // __FRAMEARENA_H__
@@ -0,0 +1,145 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "FrameLoop.h"
+#include "Log.h"
+#include "QuadGeometry.h"
+#include "Tracer.h"
+
+
+int32_t
+FrameLoop::renderFrame(FrameRenderer& renderer, int32_t nowPlayingId, FrameResult& result)
+{
+    VPB_TRACE_SCOPE("FrameLoop::renderFrame");
+    /* 定常状態のフレームではヒープ確保しない(VPB_TRACK_ALLOCATIONSビルドで確認) */
+    AllocationScope allocationScope(AllocationTag::RENDER_FRAME);
+    LatencyStats::FrameTimer latencyTimer;
+    FrameMetricsRecorder::FrameSample metricsSample;
+    metricsSample.startTime = LatencyStats::now();
+    int32_t playingId = NO_TARGET_ID;
+    result.numTracked = 0;
+
+    /* UIスレッドから届いた設定変更をフレームの頭で反映 */
+    renderer.beginFrame();
+
+    /* トラッキングスレッドが動いていれば最新の姿勢を受け取るだけ、なければこのスレッドで計算する */
+    TrackingThread::Reader trackingReader(mTrackingThread);
+    const AppController::TrackingFrame* frame = trackingReader.frame();
+    if (frame == nullptr)
+    {
+        mController.updateTrackingFrame(mTrackingFrame);
+        frame = &mTrackingFrame;
+    }
+
+    int vbTextureUnit = 0;
+    VuRenderVideoBackgroundData renderVideoBackgroundData;
+    renderVideoBackgroundData.renderData = nullptr;
+    renderVideoBackgroundData.textureData = nullptr;
+    renderVideoBackgroundData.textureUnitData = &vbTextureUnit;
+    double viewport[6];
+    const bool prepared = mController.prepareToRender(*frame, viewport, &renderVideoBackgroundData);
+    const int64_t cameraTimestamp = frame->cameraTimestamp;
+    const int64_t acquireTime = frame->acquireTime;
+    metricsSample.cameraFrameIndex = prepared ? frame->cameraFrameIndex : -1;
+    latencyTimer.mark(LatencyStats::Stage::PREPARE);
+    if (prepared)
+    {
+        renderer.renderVideoBackground(*frame, viewport, vbTextureUnit);
+
+        const VuMatrix44F& trackableProjection = frame->renderState.projectionMatrix;
+        /* 姿勢予測が有効なら、カメラフレームの姿勢を表示される時刻まで進めて描画する */
+        const float predictionHorizon = mFixedPredictionHorizon >= 0.0f ? mFixedPredictionHorizon : mController.getPredictionHorizon(*frame);
+        for (int idx = 0; idx < frame->numTargets; idx++)
+        {
+            const AppController::TrackingFrame::Target& target = frame->targets[idx];
+            const int32_t targetId = target.targetId;
+            VuMatrix44F modelView = target.modelView;
+            VuMatrix44F scaledModelView = target.scaledModelView;
+            if (predictionHorizon > 0.0f)
+                AppController::predictTargetPose(target, predictionHorizon, modelView, scaledModelView);
+
+            if (result.numTracked < FrameResult::MAX_TRACKED)
+                result.trackedIds[result.numTracked++] = targetId;
+
+            /* 再生するターゲットが決まっていなければ、最初に見つかったターゲットで再生する */
+            if (nowPlayingId == NO_TARGET_ID)
+                nowPlayingId = targetId;
+            if (nowPlayingId == targetId)
+            {
+                playingId = targetId;
+                const FrameRenderer::VideoQuad quad = renderer.renderVideoPlayback(target, trackableProjection, modelView, scaledModelView);
+                queueHitQuad(targetId, trackableProjection, scaledModelView, quad);
+            }
+            else
+            {
+                renderer.queuePause(target, trackableProjection, modelView, scaledModelView);
+                queueHitQuad(targetId, trackableProjection, scaledModelView, FrameRenderer::VideoQuad{ glm::vec2(PAUSE_QUAD_HALF_EXTENT), false });
+            }
+        }
+        latencyTimer.mark(LatencyStats::Stage::OBSERVATIONS);
+
+        /* 再生中以外のターゲットのpause.pngはまとめて1回で描画 */
+        renderer.renderPauses();
+
+        /* HUDは前のフレームまでの値を表示する(HUD自身の描画時間はDRAWに入る) */
+        renderer.renderHud(mHud);
+        latencyTimer.mark(LatencyStats::Stage::DRAW);
+    }
+
+    if (frame == &mTrackingFrame)
+        mController.releaseTrackingFrame(mTrackingFrame);
+
+    /* このフレームのターゲット面をUIスレッド(checkHit)向けに公開 */
+    mHitTester.publish();
+
+    /* カメラフレームを描けなかったフレームは遅延に数えない */
+    const FrameRenderer::Counters counters = renderer.getCounters();
+    if (prepared)
+    {
+        latencyTimer.mark(LatencyStats::Stage::FINISH);
+        mLatencyStats.record(latencyTimer, cameraTimestamp, acquireTime);
+        metricsSample.trackedTargets = result.numTracked;
+        metricsSample.drawCalls = counters.drawCalls;
+    }
+    metricsSample.glCallsIssued = counters.glCallsIssued;
+    metricsSample.glCallsAvoided = counters.glCallsAvoided;
+    mMetricsRecorder.recordFrame(metricsSample);
+
+    result.playingId = playingId;
+    result.frameCount++;
+    if (prepared)
+        mHud.addFrame(latencyTimer, result);
+
+    /* カメラ画像を描いた最初のフレームで起動完了とし、タイムラインをログに出す */
+    if (prepared && !mFirstFrameRendered)
+    {
+        mFirstFrameRendered = true;
+        if (mStartupTimeline != nullptr)
+        {
+            mStartupTimeline->record("first frame", metricsSample.startTime, LatencyStats::now());
+            LOG("Startup timeline:\n%s", mStartupTimeline->format().c_str());
+        }
+    }
+
+    /* このフレームの一時データを解放 */
+    mFrameArena.reset();
+
+    mFrameAllocations = allocationScope.getCounts();
+    return playingId;
+}
+
+
+void
+FrameLoop::queueHitQuad(int32_t targetId, const VuMatrix44F& projectionMatrix, const VuMatrix44F& scaledModelViewMatrix,
+                        const FrameRenderer::VideoQuad& quad)
+{
+    /* 全画面表示は単位行列で描くので、当たり判定もNDCのまま行う */
+    if (quad.fullscreen)
+    {
+        mHitTester.setFullscreenTarget(targetId, quad.halfExtent);
+        return;
+    }
+    mHitTester.setProjection(projectionMatrix.data);
+    mHitTester.addTarget(targetId, scaledModelViewMatrix.data, quad.halfExtent);
+}
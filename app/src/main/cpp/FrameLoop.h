@@ -0,0 +1,143 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __FRAMELOOP_H__
+#define __FRAMELOOP_H__
+
+#include "AllocationTracker.h"
+#include "AppController.h"
+#include "FrameArena.h"
+#include "FrameMetrics.h"
+#include "FrameResult.h"
+#include "HudOverlay.h"
+#include "LatencyStats.h"
+#include "RayHitTester.h"
+#include "StartupTimeline.h"
+#include "TrackingThread.h"
+
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+/// Drawing side of a frame rendered by FrameLoop: GLESRenderer on the device, a renderer without GL in vpb_replay
+class FrameRenderer
+{
+public:
+    /// Quad the video was drawn on, added to the hit test set by FrameLoop
+    struct VideoQuad
+    {
+        /// Half size of the quad in marker units, in NDC if fullscreen
+        glm::vec2 halfExtent{ 0.0f };
+        /// Drawn over the whole screen instead of on the target
+        bool fullscreen{ false };
+    };
+
+    /// GL work of the frame, for the metrics block
+    struct Counters
+    {
+        int32_t drawCalls{ 0 };
+        /// GLESStateCache counters, see FrameMetricsRecorder::FrameSample
+        uint64_t glCallsIssued{ 0 };
+        uint64_t glCallsAvoided{ 0 };
+    };
+
+    virtual ~FrameRenderer() = default;
+
+    /// Start of every frame, before the poses are read: apply the settings posted by the UI thread, clear the screen
+    virtual void beginFrame() = 0;
+
+    /// The camera frame of frame is drawn: set the viewport and draw the video background
+    virtual void renderVideoBackground(const AppController::TrackingFrame& frame, const double* viewport, int textureUnit) = 0;
+
+    /// Draw the video on target at the given (possibly predicted) pose
+    virtual VideoQuad renderVideoPlayback(const AppController::TrackingFrame::Target& target, const VuMatrix44F& projectionMatrix,
+                                          const VuMatrix44F& modelViewMatrix, const VuMatrix44F& scaledModelViewMatrix) = 0;
+
+    /// Queue the pause image of target at the given pose, drawn for all targets by renderPauses()
+    virtual void queuePause(const AppController::TrackingFrame::Target& target, const VuMatrix44F& projectionMatrix,
+                            const VuMatrix44F& modelViewMatrix, const VuMatrix44F& scaledModelViewMatrix) = 0;
+
+    virtual void renderPauses() = 0;
+
+    /// Draw hud over the frame if the HUD is enabled, false if it is not
+    virtual bool renderHud(HudOverlay& hud) = 0;
+
+    virtual Counters getCounters() const = 0;
+};
+
+/// The GL-free part of rendering a frame, shared by the renderFrame JNI entries and vpb_replay
+/**
+ * renderFrame() takes the latest TrackingFrame (from the TrackingThread if it runs, computed on the
+ * calling thread otherwise), updates the video background from it, picks the target the video plays on,
+ * extrapolates the target poses (AppController::getPredictionHorizon), hands the draws to a
+ * FrameRenderer, publishes the quads drawn for hit testing and records the latency stages, the metrics
+ * block and the HUD. The frame arena is reset at the end of the frame.
+ *
+ * Steady-state frames must not allocate on the heap: getFrameAllocations() returns what the last frame
+ * allocated (only counted with VPB_TRACK_ALLOCATIONS), which vpb_replay -z checks.
+ *
+ * Render thread only, except for getHitTester() whose hitTest() may run on the UI thread.
+ */
+class FrameLoop
+{
+public:
+    /// startupTimeline gets the first frame that shows the camera image as phase "first frame", nullptr for none
+    FrameLoop(AppController& controller, TrackingThread& trackingThread, FrameMetricsRecorder& metricsRecorder,
+              StartupTimeline* startupTimeline = nullptr)
+        : mController(controller), mTrackingThread(trackingThread), mMetricsRecorder(metricsRecorder), mStartupTimeline(startupTimeline)
+    {
+    }
+
+    FrameLoop(const FrameLoop&) = delete;
+    FrameLoop& operator=(const FrameLoop&) = delete;
+
+    /// Render one frame: video background, then the video on the playing target and the pause image on the others
+    /**
+     * nowPlayingId is the target the video is played on, NO_TARGET_ID to start playing on the first tracked target.
+     * The tracked targets are written to result.
+     * @return the target the video was rendered on, NO_TARGET_ID if it is not tracked.
+     */
+    int32_t renderFrame(FrameRenderer& renderer, int32_t nowPlayingId, FrameResult& result);
+
+    /// Extrapolate the poses by a fixed horizon (s) instead of the measured one, negative to measure it again
+    /**
+     * Makes the drawn poses reproducible (vpb_replay -p).
+     */
+    void setFixedPredictionHorizon(float seconds) { mFixedPredictionHorizon = seconds; }
+
+    /// Heap allocations of the last renderFrame()
+    const AllocationCounts& getFrameAllocations() const { return mFrameAllocations; }
+
+    LatencyStats& getLatencyStats() { return mLatencyStats; }
+    HudOverlay& getHud() { return mHud; }
+    FrameArena& getFrameArena() { return mFrameArena; }
+    /// The quads drawn by the last frame, for checkHit
+    RayHitTester& getHitTester() { return mHitTester; }
+
+private:
+    /// Add the quad of target to the hit test set published at the end of the frame
+    void queueHitQuad(int32_t targetId, const VuMatrix44F& projectionMatrix, const VuMatrix44F& scaledModelViewMatrix,
+                      const FrameRenderer::VideoQuad& quad);
+
+    AppController& mController;
+    TrackingThread& mTrackingThread;
+    FrameMetricsRecorder& mMetricsRecorder;
+    StartupTimeline* mStartupTimeline;
+    float mFixedPredictionHorizon{ -1.0f };
+
+    /// Poses computed on the render thread when the tracking thread is not running
+    AppController::TrackingFrame mTrackingFrame;
+    /// Rolling stage and camera-to-display latencies of the rendered frames
+    LatencyStats mLatencyStats;
+    /// Performance HUD, drawn while enabled with RenderCommand::hud
+    HudOverlay mHud;
+    /// Transient allocations of the render thread, released at the end of every frame
+    FrameArena mFrameArena;
+    /* タッチ判定用のターゲット面(カメラ座標系の逆行列で持つ) */
+    RayHitTester mHitTester;
+    AllocationCounts mFrameAllocations{};
+    bool mFirstFrameRendered{ false };
+};
+
+#endif // __FRAMELOOP_H__
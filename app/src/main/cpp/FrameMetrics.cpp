@@ -0,0 +1,87 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "FrameMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+
+namespace
+{
+int32_t
+clampToInt32(int64_t value)
+{
+    return static_cast<int32_t>(std::min<int64_t>(value, std::numeric_limits<int32_t>::max()));
+}
+
+/// Difference of a counter that may have been reset since the last frame
+int32_t
+counterDelta(uint64_t current, uint64_t last)
+{
+    return clampToInt32(static_cast<int64_t>(current >= last ? current - last : current));
+}
+}
+
+
+FrameMetricsRecorder::FrameMetricsRecorder(FrameMetrics& metrics) : mMetrics(metrics)
+{
+    mMetrics = FrameMetrics{};
+    mMetrics.version = FrameMetrics::VERSION;
+}
+
+
+void
+FrameMetricsRecorder::recordFrame(const FrameSample& sample)
+{
+    /* 奇数の間は更新中 (Kotlin側は前後で同じ偶数を読めたら採用する) */
+    const int32_t sequence = mMetrics.sequence;
+    mMetrics.sequence = sequence + 1;
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const bool newCameraFrame = sample.cameraFrameIndex >= 0 && sample.cameraFrameIndex != mLastCameraFrameIndex;
+    if (!newCameraFrame)
+    {
+        mMetrics.skippedFrames++;
+    }
+    else
+    {
+        if (mLastCameraFrameIndex >= 0 && sample.cameraFrameIndex > mLastCameraFrameIndex + 1)
+            mMetrics.droppedFrames += clampToInt32(sample.cameraFrameIndex - mLastCameraFrameIndex - 1);
+        mLastCameraFrameIndex = sample.cameraFrameIndex;
+
+        if (mLastFrameStart != 0)
+        {
+            const int32_t frameTimeUs = clampToInt32((sample.startTime - mLastFrameStart) / 1000);
+            mMetrics.lastFrameTimeUs = frameTimeUs;
+            mMetrics.frameTimeHistogram[std::clamp(frameTimeUs / FrameMetrics::FRAME_TIME_BUCKET_US, 0, FrameMetrics::FRAME_TIME_BUCKETS - 1)]++;
+        }
+        mLastFrameStart = sample.startTime;
+        mMetrics.frameCount++;
+        mMetrics.trackedTargets = sample.trackedTargets;
+        mMetrics.trackedTargetsTotal += sample.trackedTargets;
+    }
+
+    /* 描画呼び出しとGLステートの数は、カメラフレームがなくても描いた分を数える */
+    mMetrics.drawCalls = sample.drawCalls;
+    mMetrics.glCallsIssued = counterDelta(sample.glCallsIssued, mLastGlCallsIssued);
+    mMetrics.glCallsAvoided = counterDelta(sample.glCallsAvoided, mLastGlCallsAvoided);
+    mMetrics.glCallsAvoidedTotal += mMetrics.glCallsAvoided;
+    mLastGlCallsIssued = sample.glCallsIssued;
+    mLastGlCallsAvoided = sample.glCallsAvoided;
+
+    std::atomic_thread_fence(std::memory_order_release);
+    mMetrics.sequence = sequence + 2;
+}
+
+
+void
+FrameMetricsRecorder::recordHitTest(int64_t durationNs)
+{
+    const int32_t duration = clampToInt32(durationNs);
+    mMetrics.hitTestLastNs = duration;
+    mMetrics.hitTestMaxNs = std::max(mMetrics.hitTestMaxNs, duration);
+    mMetrics.hitTestCount++;
+}
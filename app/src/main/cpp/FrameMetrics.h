@@ -0,0 +1,93 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __FRAMEMETRICS_H__
+#define __FRAMEMETRICS_H__
+
+#include <cstdint>
+
+/// Rendering metrics kept in native memory and read by Kotlin through a direct ByteBuffer
+/**
+ * All fields are int32 in native byte order at fixed offsets (see FRAME_METRICS_* in VuforiaWrapper.kt),
+ * keep both in sync. The block is mapped once (getMetricsBuffer) and polled without JNI calls.
+ *
+ * The render thread updates the frame fields between two increments of sequence: a reader that sees
+ * the same even sequence before and after copying the fields has a consistent frame. The hit test
+ * fields are written by the UI thread and are only consistent field by field.
+ */
+struct FrameMetrics
+{
+    static constexpr int32_t VERSION = 1;
+    /// Frame time histogram: bucket i counts intervals in [i, i + 1) * FRAME_TIME_BUCKET_US, the last one everything above
+    static constexpr int32_t FRAME_TIME_BUCKETS = 16;
+    static constexpr int32_t FRAME_TIME_BUCKET_US = 2000;
+
+    /// VERSION of the layout
+    int32_t version;
+    /// Odd while the render thread is updating the frame fields
+    int32_t sequence;
+
+    /// Frames rendered from a camera frame
+    int32_t frameCount;
+    /// Camera frames that were never rendered (the camera frame index jumped by more than one)
+    int32_t droppedFrames;
+    /// Render calls without a new camera frame (no state yet or the same camera frame again)
+    int32_t skippedFrames;
+    /// Time between the starts of the last two rendered frames (us)
+    int32_t lastFrameTimeUs;
+    int32_t frameTimeHistogram[FRAME_TIME_BUCKETS];
+
+    /// Targets drawn in the last frame and in all frames
+    int32_t trackedTargets;
+    int32_t trackedTargetsTotal;
+    /// Draw calls of the last frame
+    int32_t drawCalls;
+    /// GL state calls issued and avoided by the state cache in the last frame
+    int32_t glCallsIssued;
+    int32_t glCallsAvoided;
+    /// GL state calls avoided in all frames
+    int32_t glCallsAvoidedTotal;
+
+    /// Hit tests (checkHit*) and their duration, last and maximum (ns)
+    int32_t hitTestCount;
+    int32_t hitTestLastNs;
+    int32_t hitTestMaxNs;
+};
+
+static_assert(sizeof(FrameMetrics) == (15 + FrameMetrics::FRAME_TIME_BUCKETS) * sizeof(int32_t), "FrameMetrics must stay a flat int32 array");
+
+/// Writes FrameMetrics: recordFrame from the render thread, recordHitTest from the UI thread
+class FrameMetricsRecorder
+{
+public:
+    /// What one render call did
+    struct FrameSample
+    {
+        /// steady_clock time the frame started (ns)
+        int64_t startTime{ 0 };
+        /// Camera frame rendered, -1 if there was none
+        int64_t cameraFrameIndex{ -1 };
+        int32_t trackedTargets{ 0 };
+        int32_t drawCalls{ 0 };
+        /// GLESStateCache counters since the state cache was reset, the recorder takes the difference
+        uint64_t glCallsIssued{ 0 };
+        uint64_t glCallsAvoided{ 0 };
+    };
+
+    explicit FrameMetricsRecorder(FrameMetrics& metrics);
+
+    void recordFrame(const FrameSample& sample);
+
+    void recordHitTest(int64_t durationNs);
+
+private:
+    FrameMetrics& mMetrics;
+    /// Start of the previous rendered frame, 0 if there is none
+    int64_t mLastFrameStart{ 0 };
+    int64_t mLastCameraFrameIndex{ -1 };
+    uint64_t mLastGlCallsIssued{ 0 };
+    uint64_t mLastGlCallsAvoided{ 0 };
+};
+
+#endif // __FRAMEMETRICS_H__
@@ -0,0 +1,37 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __FRAMERESULT_H__
+#define __FRAMERESULT_H__
+
+#include <cstdint>
+
+/// Target ID meaning "no target"
+static constexpr int32_t NO_TARGET_ID = -1;
+/// Returned by renderFrameIds while the AR session is not started
+static constexpr int32_t FRAME_WAITING_ID = -2;
+
+/// Per-frame result written by renderFrameIds into a direct ByteBuffer owned by Kotlin
+/**
+ * All fields are int32 in native byte order. The Kotlin side reads them at fixed offsets
+ * (see FrameResult in VuforiaWrapper.kt), keep both in sync.
+ * Target IDs are dense, 0..targetCount-1 in the order the observers were created.
+ */
+struct FrameResult
+{
+    static constexpr int32_t MAX_TRACKED = 16;
+
+    /// Incremented each time a frame has been rendered
+    int32_t frameCount;
+    /// Target the video is played on, NO_TARGET_ID if none
+    int32_t playingId;
+    /// Number of valid entries in trackedIds
+    int32_t numTracked;
+    /// Targets with a pose this frame
+    int32_t trackedIds[MAX_TRACKED];
+};
+
+static_assert(sizeof(FrameResult) == (3 + FrameResult::MAX_TRACKED) * sizeof(int32_t), "FrameResult must stay a flat int32 array");
+
+#endif // __FRAMERESULT_H__
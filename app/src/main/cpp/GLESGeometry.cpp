@@ -0,0 +1,166 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "GLESGeometry.h"
+#include "GLESUtils.h"
+
+
+GLESGeometry::Mesh
+GLESGeometry::createMesh(const float* positions, GLsizei numVertices, const float* attributes, GLint attributeSize,
+                         const unsigned short* indices, GLsizei numIndices)
+{
+    Mesh mesh;
+    mesh.numVertices = numVertices;
+    mesh.positionBuffer = createBuffer(GL_ARRAY_BUFFER, numVertices * 3 * sizeof(float), positions);
+    if (attributes != nullptr)
+    {
+        mesh.attributeSize = attributeSize;
+        mesh.attributeBuffer = createBuffer(GL_ARRAY_BUFFER, numVertices * attributeSize * sizeof(float), attributes);
+    }
+    if (indices != nullptr)
+    {
+        mesh.numIndices = numIndices;
+        mesh.indexBuffer = createBuffer(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(unsigned short), indices);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    GLESUtils::checkGlError("Create mesh");
+    return mesh;
+}
+
+
+GLuint
+GLESGeometry::createIndexBuffer(const unsigned short* indices, GLsizei numIndices)
+{
+    GLuint buffer = createBuffer(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(unsigned short), indices);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return buffer;
+}
+
+
+GLuint
+GLESGeometry::createDynamicBuffer(GLsizeiptr size)
+{
+    GLuint buffer = createBuffer(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return buffer;
+}
+
+
+void
+GLESGeometry::setInstanceMatrixAttribute(GLuint vertexArray, GLuint buffer, GLint location)
+{
+    if (location < 0)
+    {
+        return;
+    }
+
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (GLuint column = 0; column < 4; column++)
+    {
+        GLuint columnLocation = static_cast<GLuint>(location) + column;
+        glVertexAttribPointer(columnLocation, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float),
+                              reinterpret_cast<const void*>(column * 4 * sizeof(float)));
+        glEnableVertexAttribArray(columnLocation);
+        glVertexAttribDivisor(columnLocation, 1);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLESUtils::checkGlError("Set instance matrix attribute");
+}
+
+
+GLuint
+GLESGeometry::createVertexArray(const Mesh& mesh, GLint positionLocation, GLint attributeLocation)
+{
+    GLuint vertexArray = 0;
+    glGenVertexArrays(1, &vertexArray);
+    mVertexArrays.push_back(vertexArray);
+
+    glBindVertexArray(vertexArray);
+    if (positionLocation >= 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.positionBuffer);
+        glVertexAttribPointer(static_cast<GLuint>(positionLocation), 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glEnableVertexAttribArray(static_cast<GLuint>(positionLocation));
+    }
+    if (attributeLocation >= 0 && mesh.attributeBuffer != 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.attributeBuffer);
+        glVertexAttribPointer(static_cast<GLuint>(attributeLocation), mesh.attributeSize, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glEnableVertexAttribArray(static_cast<GLuint>(attributeLocation));
+    }
+    if (mesh.indexBuffer != 0)
+    {
+        // The element array binding is part of the vertex array state
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexBuffer);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    GLESUtils::checkGlError("Create vertex array");
+    return vertexArray;
+}
+
+
+GLuint
+GLESGeometry::createVertexArray()
+{
+    GLuint vertexArray = 0;
+    glGenVertexArrays(1, &vertexArray);
+    mVertexArrays.push_back(vertexArray);
+    return vertexArray;
+}
+
+
+void
+GLESGeometry::setVertexAttribute(GLuint vertexArray, GLuint buffer, GLint location, GLint size, GLenum type,
+                                 GLboolean normalized, GLsizei stride, GLsizei offset)
+{
+    if (location < 0)
+    {
+        return;
+    }
+
+    glBindVertexArray(vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(static_cast<GLuint>(location), size, type, normalized, stride, reinterpret_cast<const void*>(offset));
+    glEnableVertexAttribArray(static_cast<GLuint>(location));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLESUtils::checkGlError("Set vertex attribute");
+}
+
+
+void
+GLESGeometry::destroy()
+{
+    if (!mVertexArrays.empty())
+    {
+        glDeleteVertexArrays(static_cast<GLsizei>(mVertexArrays.size()), mVertexArrays.data());
+        mVertexArrays.clear();
+    }
+    if (!mBuffers.empty())
+    {
+        glDeleteBuffers(static_cast<GLsizei>(mBuffers.size()), mBuffers.data());
+        mBuffers.clear();
+    }
+}
+
+
+GLuint
+GLESGeometry::createBuffer(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    mBuffers.push_back(buffer);
+    glBindBuffer(target, buffer);
+    glBufferData(target, size, data, usage);
+    return buffer;
+}
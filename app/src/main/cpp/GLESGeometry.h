@@ -0,0 +1,73 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __GLESGEOMETRY_H__
+#define __GLESGEOMETRY_H__
+
+#include <GLES3/gl31.h>
+
+#include <vector>
+
+/// Owns the GL buffers and vertex arrays of the static meshes used by GLESRenderer
+/**
+ * Meshes are uploaded once (GL_STATIC_DRAW) when the renderer is initialized. A vertex array then
+ * captures the attribute setup for one shader program, so a draw is just glBindVertexArray plus the
+ * draw call and no vertex data is submitted per frame.
+ */
+class GLESGeometry
+{
+public:
+    /// A mesh in GL buffers
+    struct Mesh
+    {
+        GLuint positionBuffer = 0;
+        /// Second per-vertex attribute (texture coordinates or colors), 0 if none
+        GLuint attributeBuffer = 0;
+        GLint attributeSize = 0;
+        /// GL_UNSIGNED_SHORT indices, 0 for a non indexed mesh
+        GLuint indexBuffer = 0;
+        GLsizei numVertices = 0;
+        GLsizei numIndices = 0;
+    };
+
+    /// Upload a mesh (3 floats per position, attributeSize floats per attribute)
+    /**
+     * attributes and indices may be nullptr.
+     */
+    Mesh createMesh(const float* positions, GLsizei numVertices, const float* attributes, GLint attributeSize,
+                    const unsigned short* indices, GLsizei numIndices);
+
+    /// Upload an additional GL_UNSIGNED_SHORT index buffer, e.g. a wireframe drawn over the positions of another mesh
+    GLuint createIndexBuffer(const unsigned short* indices, GLsizei numIndices);
+
+    /// Create a GL_DYNAMIC_DRAW array buffer of size bytes whose content is refilled every frame
+    GLuint createDynamicBuffer(GLsizeiptr size);
+
+    /// Feed a per-instance mat4 (16 column-major floats per instance) from buffer to the vertex array
+    /**
+     * A mat4 attribute occupies 4 consecutive locations starting at location, one per column.
+     */
+    void setInstanceMatrixAttribute(GLuint vertexArray, GLuint buffer, GLint location);
+
+    /// Create a vertex array feeding the mesh to the given attribute locations (-1 to leave an attribute out)
+    GLuint createVertexArray(const Mesh& mesh, GLint positionLocation, GLint attributeLocation);
+
+    /// Create a vertex array without attributes, to be set up with setVertexAttribute
+    GLuint createVertexArray();
+
+    /// Feed an interleaved per-vertex attribute (size components of type at offset) from buffer to the vertex array
+    void setVertexAttribute(GLuint vertexArray, GLuint buffer, GLint location, GLint size, GLenum type, GLboolean normalized,
+                            GLsizei stride, GLsizei offset);
+
+    /// Delete every buffer and vertex array created through this object
+    void destroy();
+
+private:
+    GLuint createBuffer(GLenum target, GLsizeiptr size, const void* data, GLenum usage = GL_STATIC_DRAW);
+
+    std::vector<GLuint> mBuffers;
+    std::vector<GLuint> mVertexArrays;
+};
+
+#endif // __GLESGEOMETRY_H__
@@ -8,26 +8,30 @@ countries.
 #include "GLESRenderer.h"
 #include "GLESUtils.h"
 #include "Shaders.h"
-#include "MemoryStream.h"
 #include "Models.h"
-#include <android/asset_manager.h>
-#include <chrono>
+#include "QuadGeometry.h"
+#include "Tracer.h"
+#include "VuforiaMath.h"
+#include <cstddef>
 
 bool
-GLESRenderer::init(AAssetManager* assetManager)
+GLESRenderer::init()
 {
+    VPB_TRACE_SCOPE("GLESRenderer::init");
     /* Setup for Video PlayBack rendering */
     _vProgram = GLESUtils::createProgramFromBuffer(VERTEX_SHADER, FRAGMENT_SHADER);
     _vaPosition = glGetAttribLocation(_vProgram, "a_Position");
     _vaTexCoordLoc = glGetAttribLocation(_vProgram, "a_TexCoord");
     _vuProjectionMatrixLoc = glGetUniformLocation(_vProgram, "u_ProjectionMatrix");
+    _vuHalfExtentLoc = glGetUniformLocation(_vProgram, "u_HalfExtent");
     _vuSamplerOES = glGetUniformLocation(_vProgram, "u_SamplerOES");
 
     /* Setup for Pause.png rendering */
     _pProgram = GLESUtils::createProgramFromBuffer(VERTEX_SHADER_PAUSE, FRAGMENT_SHADER_PAUSE);
     _paPosition = glGetAttribLocation(_pProgram, "a_Position");
     _paTexCoordLoc = glGetAttribLocation(_pProgram, "a_TexCoord");
-    _puProjectionMatrixLoc = glGetUniformLocation(_pProgram, "u_ProjectionMatrix");
+    _paModelViewProjection = glGetAttribLocation(_pProgram, "a_ModelViewProjection");
+    _puHalfExtentLoc = glGetUniformLocation(_pProgram, "u_HalfExtent");
     _puSampler2D = glGetUniformLocation(_pProgram, "u_Sampler2D");
 
     // Setup for Video Background rendering
@@ -57,31 +61,147 @@ GLESRenderer::init(AAssetManager* assetManager)
     mVertexColorColorHandle = glGetAttribLocation(mVertexColorShaderProgramID, "vertexColor");
     mVertexColorMvpMatrixHandle = glGetUniformLocation(mVertexColorShaderProgramID, "modelViewProjectionMatrix");
 
+    // Setup for performance HUD rendering
+    mHudProgram = GLESUtils::createProgramFromBuffer(VERTEX_SHADER_HUD, FRAGMENT_SHADER_HUD);
+    mHudPositionHandle = glGetAttribLocation(mHudProgram, "a_Position");
+    mHudTexCoordHandle = glGetAttribLocation(mHudProgram, "a_TexCoord");
+    mHudColorHandle = glGetAttribLocation(mHudProgram, "a_Color");
+    mHudAtlasHandle = glGetUniformLocation(mHudProgram, "u_Atlas");
+
     mModelTargetGuideViewTextureUnit = -1;
+    mAstronautTextureId = -1;
+    _pTextureId = -1;
+    mAstronautVertexCount = 0;
 
-    std::vector<char> data; // for reading model files
+    // The Astronaut model and the textures are loaded by the InitPipeline and uploaded by uploadStartupAssets()
+    createGeometry();
 
-    // Load Astronaut model
+    /* HUDのフォントは1バイト/画素。拡大は整数倍なのでGL_NEARESTでドットのまま出す */
     {
-        if (!readAsset(assetManager, "ImageTargets/Astronaut.obj", data))
-        {
-            return false;
-        }
-        if (!loadObjModel(data, mAstronautVertexCount, mAstronautVertices, mAstronautTexCoords))
-        {
-            return false;
-        }
-        data.clear();
-        mAstronautTextureId = -1;
+        uint8_t atlas[HudOverlay::ATLAS_WIDTH * HudOverlay::ATLAS_HEIGHT];
+        HudOverlay::buildFontAtlas(atlas);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        mHudAtlasTextureId = GLESUtils::createTexture(HudOverlay::ATLAS_WIDTH, HudOverlay::ATLAS_HEIGHT, atlas, GL_LUMINANCE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, mHudAtlasTextureId);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
     }
 
+    // New context: nothing is known about its state yet
+    mState.invalidate();
+    mState.resetCounters();
+
     return true;
 }
 
 
+void
+GLESRenderer::createGeometry()
+{
+    /* 単位矩形(±1)。動画とpause.pngで共有し、u_HalfExtentで拡縮する */
+    GLfloat unitQuadVertices[12];
+    makeQuadVertices(glm::vec2(1.0f), unitQuadVertices);
+    const GLfloat unitQuadTexCoords[] = {
+        0.0f, 1.0f, /* 左下 */
+        1.0f, 1.0f, /* 右下 */
+        0.0f, 0.0f, /* 左上 */
+        1.0f, 0.0f  /* 右上 */
+    };
+    GLESGeometry::Mesh unitQuad = mGeometry.createMesh(unitQuadVertices, 4, unitQuadTexCoords, 2, nullptr, 0);
+    mVideoQuadVertexArray = mGeometry.createVertexArray(unitQuad, _vaPosition, _vaTexCoordLoc);
+    mPauseQuadVertexArray = mGeometry.createVertexArray(unitQuad, _paPosition, _paTexCoordLoc);
+    mPauseInstanceBuffer = mGeometry.createDynamicBuffer(sizeof(mPauseInstances));
+    mGeometry.setInstanceMatrixAttribute(mPauseQuadVertexArray, mPauseInstanceBuffer, _paModelViewProjection);
+
+    // The solid square and its outline share the positions but need their own element buffers
+    GLESGeometry::Mesh square =
+        mGeometry.createMesh(squareVertices, NUM_SQUARE_VERTEX, nullptr, 0, squareIndices, NUM_SQUARE_INDEX);
+    GLESGeometry::Mesh squareWireframe = square;
+    squareWireframe.numIndices = NUM_SQUARE_WIREFRAME_INDEX;
+    squareWireframe.indexBuffer = mGeometry.createIndexBuffer(squareWireframeIndices, NUM_SQUARE_WIREFRAME_INDEX);
+    mSquareVertexArray = mGeometry.createVertexArray(square, mUniformColorVertexPositionHandle, -1);
+    mSquareWireframeVertexArray = mGeometry.createVertexArray(squareWireframe, mUniformColorVertexPositionHandle, -1);
+
+    GLESGeometry::Mesh cube = mGeometry.createMesh(cubeVertices, NUM_CUBE_VERTEX, nullptr, 0, cubeIndices, NUM_CUBE_INDEX);
+    mCubeVertexArray = mGeometry.createVertexArray(cube, mUniformColorVertexPositionHandle, -1);
+
+    GLESGeometry::Mesh axis = mGeometry.createMesh(axisVertices, NUM_AXIS_VERTEX, axisColors, 4, axisIndices, NUM_AXIS_INDEX);
+    mAxisVertexArray = mGeometry.createVertexArray(axis, mVertexColorVertexPositionHandle, mVertexColorColorHandle);
+
+    // HUD vertices are interleaved: position and atlas coordinates as floats, RGBA8 color
+    mHudVertexBuffer = mGeometry.createDynamicBuffer(HudOverlay::MAX_VERTICES * sizeof(HudOverlay::Vertex));
+    mHudVertexArray = mGeometry.createVertexArray();
+    const GLsizei hudStride = sizeof(HudOverlay::Vertex);
+    mGeometry.setVertexAttribute(mHudVertexArray, mHudVertexBuffer, mHudPositionHandle, 2, GL_FLOAT, GL_FALSE, hudStride,
+                                 offsetof(HudOverlay::Vertex, x));
+    mGeometry.setVertexAttribute(mHudVertexArray, mHudVertexBuffer, mHudTexCoordHandle, 2, GL_FLOAT, GL_FALSE, hudStride,
+                                 offsetof(HudOverlay::Vertex, u));
+    mGeometry.setVertexAttribute(mHudVertexArray, mHudVertexBuffer, mHudColorHandle, 4, GL_UNSIGNED_BYTE, GL_TRUE, hudStride,
+                                 offsetof(HudOverlay::Vertex, color));
+}
+
+
+bool
+GLESRenderer::uploadStartupAssets(InitPipeline& pipeline)
+{
+    VPB_TRACE_SCOPE("GLESRenderer::uploadStartupAssets");
+    /* 読み込みと解析はワーカーで済んでいるので、ここはGPUへの転送だけ */
+    const InitPipeline::Model* model = pipeline.getModel();
+    if (model != nullptr)
+    {
+        mAstronautVertexCount = model->numVertices;
+        GLESGeometry::Mesh astronaut =
+            mGeometry.createMesh(model->vertices.data(), mAstronautVertexCount, model->texCoords.data(), 2, nullptr, 0);
+        mAstronautVertexArray = mGeometry.createVertexArray(astronaut, mTextureUniformColorVertexPositionHandle,
+                                                            mTextureUniformColorTextureCoordHandle);
+    }
+
+    const InitPipeline::Image* astronautImage = pipeline.getImage(InitPipeline::ImageId::ASTRONAUT);
+    if (astronautImage != nullptr)
+    {
+        setAstronautTexture(astronautImage->width, astronautImage->height, astronautImage->pixels.data());
+    }
+    const InitPipeline::Image* pauseImage = pipeline.getImage(InitPipeline::ImageId::PAUSE);
+    if (pauseImage != nullptr)
+    {
+        setPauseTexture(pauseImage->width, pauseImage->height, pauseImage->pixels.data());
+    }
+
+    return model != nullptr && astronautImage != nullptr && pauseImage != nullptr;
+}
+
+
 void
 GLESRenderer::deinit()
 {
+    mGeometry.destroy();
+    mVideoQuadVertexArray = 0;
+    mPauseQuadVertexArray = 0;
+    mPauseInstanceBuffer = 0;
+    mNumPauseInstances = 0;
+    mSquareVertexArray = 0;
+    mSquareWireframeVertexArray = 0;
+    mCubeVertexArray = 0;
+    mAxisVertexArray = 0;
+    mAstronautVertexArray = 0;
+    mHudVertexBuffer = 0;
+    mHudVertexArray = 0;
+
+    if (mVbVertexArray != 0)
+    {
+        glDeleteVertexArrays(1, &mVbVertexArray);
+        const GLuint buffers[] = { mVbPositionBuffer, mVbTexCoordBuffer, mVbIndexBuffer };
+        glDeleteBuffers(3, buffers);
+        mVbVertexArray = 0;
+        mVbPositionBuffer = 0;
+        mVbTexCoordBuffer = 0;
+        mVbIndexBuffer = 0;
+        mVbNumIndices = 0;
+        mVbMeshSignature = MeshSignature();
+    }
+
     if (mModelTargetGuideViewTextureUnit != -1)
     {
         GLESUtils::destroyTexture(mModelTargetGuideViewTextureUnit);
@@ -97,60 +217,156 @@ GLESRenderer::deinit()
         GLESUtils::destroyTexture(_pTextureId);
         _pTextureId = -1;
     }
+    if (mHudAtlasTextureId != -1)
+    {
+        GLESUtils::destroyTexture(mHudAtlasTextureId);
+        mHudAtlasTextureId = -1;
+    }
+}
+
+
+void
+GLESRenderer::beginFrame()
+{
+    processCommands();
+    mDrawCalls = 0;
+
+    // Clear colour and depth buffers
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+
+FrameRenderer::Counters
+GLESRenderer::getCounters() const
+{
+    Counters counters;
+    counters.drawCalls = mDrawCalls;
+    counters.glCallsIssued = mState.getCounters().issued;
+    counters.glCallsAvoided = mState.getCounters().skipped;
+    return counters;
+}
+
+
+void
+GLESRenderer::processCommands()
+{
+    RenderCommand command;
+    while (mCommands.tryPop(command))
+    {
+        switch (command.type)
+        {
+        case RenderCommand::Type::SET_VIDEO_SIZE:
+            _vVideoWidth = command.width;
+            _vVideoHeight = command.height;
+            break;
+        case RenderCommand::Type::SET_SCREEN_SIZE:
+            setScreenSize(command.width, command.height);
+            break;
+        case RenderCommand::Type::SET_FULLSCREEN:
+            _fullscreenFlg = command.enabled;
+            break;
+        case RenderCommand::Type::SET_HUD:
+            _hudEnabled = command.enabled;
+            break;
+        }
+    }
+}
+
+
+void
+GLESRenderer::setScreenSize(float width, float height)
+{
+    _screenWidth = width;
+    _screenHeight = height;
 }
 
 
 void
-GLESRenderer::setAstronautTexture(int width, int height, unsigned char* bytes)
+GLESRenderer::setAstronautTexture(int width, int height, const unsigned char* bytes)
 {
     createTexture(width, height, bytes, mAstronautTextureId);
 }
 
 void
-GLESRenderer::setPauseTexture(int width, int height, unsigned char* bytes) {
+GLESRenderer::setPauseTexture(int width, int height, const unsigned char* bytes) {
     createTexture(width, height, bytes, _pTextureId);
 }
 
 void
-GLESRenderer::renderVideoBackground(const VuMatrix44F& projectionMatrix, const float* vertices, const float* textureCoordinates,
-                                    const int numTriangles, const unsigned int* indices, int textureUnit)
+GLESRenderer::updateVideoBackgroundMesh(const VuMesh& mesh)
 {
-    GLboolean depthTest = GL_FALSE;
-    GLboolean cullTest = GL_FALSE;
+    MeshSignature signature = computeMeshSignature(&mesh, mesh.pos, mesh.tex, mesh.numVertices, mesh.faceIndices, mesh.numFaces);
+    if (mVbVertexArray != 0 && signature == mVbMeshSignature)
+    {
+        return;
+    }
 
-    glGetBooleanv(GL_DEPTH_TEST, &depthTest);
-    glGetBooleanv(GL_CULL_FACE, &cullTest);
+    // GL_ELEMENT_ARRAY_BUFFER is bound below, which must not touch the vertex array of another mesh
+    mState.bindVertexArray(0);
+    if (mVbVertexArray == 0)
+    {
+        GLuint buffers[3];
+        glGenBuffers(3, buffers);
+        mVbPositionBuffer = buffers[0];
+        mVbTexCoordBuffer = buffers[1];
+        mVbIndexBuffer = buffers[2];
+
+        glGenVertexArrays(1, &mVbVertexArray);
+        mState.bindVertexArray(mVbVertexArray);
+        glBindBuffer(GL_ARRAY_BUFFER, mVbPositionBuffer);
+        glVertexAttribPointer(static_cast<GLuint>(mVbVertexPositionHandle), 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glEnableVertexAttribArray(static_cast<GLuint>(mVbVertexPositionHandle));
+        glBindBuffer(GL_ARRAY_BUFFER, mVbTexCoordBuffer);
+        glVertexAttribPointer(static_cast<GLuint>(mVbTextureCoordHandle), 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glEnableVertexAttribArray(static_cast<GLuint>(mVbTextureCoordHandle));
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mVbIndexBuffer);
+        mState.bindVertexArray(0);
+    }
 
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
+    // The buffers stay attached to the vertex array, only their storage is replaced
+    glBindBuffer(GL_ARRAY_BUFFER, mVbPositionBuffer);
+    glBufferData(GL_ARRAY_BUFFER, mesh.numVertices * 3 * sizeof(float), mesh.pos, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, mVbTexCoordBuffer);
+    glBufferData(GL_ARRAY_BUFFER, mesh.numVertices * 2 * sizeof(float), mesh.tex, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mVbIndexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.numFaces * 3 * sizeof(unsigned int), mesh.faceIndices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    mVbNumIndices = mesh.numFaces * 3;
+    mVbMeshSignature = signature;
+
+    LOG("Uploaded video background mesh: %d vertices, %d faces", mesh.numVertices, mesh.numFaces);
+    GLESUtils::checkGlError("Upload video background mesh");
+}
 
-    // Load the shader and upload the vertex/texcoord/index data
-    glUseProgram(mVbShaderProgramID);
-    glVertexAttribPointer(static_cast<GLuint>(mVbVertexPositionHandle), 3, GL_FLOAT, GL_FALSE, 0, vertices);
-    glVertexAttribPointer(static_cast<GLuint>(mVbTextureCoordHandle), 2, GL_FLOAT, GL_FALSE, 0, textureCoordinates);
 
-    glUniform1i(mVbTexSampler2DHandle, textureUnit);
+void
+GLESRenderer::renderVideoBackground(const AppController::TrackingFrame& frame, const double* viewport, int textureUnit)
+{
+    VPB_TRACE_SCOPE("GLESRenderer::renderVideoBackground");
+    // Set viewport for current view
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    /* エンジンが背景テクスチャを更新したときのバインドはキャッシュに映っていない */
+    mState.invalidateTextures();
 
-    // Render the video background with the custom shader
-    // First, we enable the vertex arrays
-    glEnableVertexAttribArray(static_cast<GLuint>(mVbVertexPositionHandle));
-    glEnableVertexAttribArray(static_cast<GLuint>(mVbTextureCoordHandle));
+    const VuRenderState& renderState = frame.renderState;
+    updateVideoBackgroundMesh(*renderState.vbMesh);
 
-    // Pass the projection matrix to OpenGL
-    glUniformMatrix4fv(mVbMvpMatrixHandle, 1, GL_FALSE, projectionMatrix.data);
+    setRenderState(false, false, false);
 
-    // Then, we issue the render call
-    glDrawElements(GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_INT, indices);
+    // Load the shader and bind the cached vertex/texcoord/index buffers
+    mState.useProgram(mVbShaderProgramID);
+    mState.bindVertexArray(mVbVertexArray);
 
-    // Finally, we disable the vertex arrays
-    glDisableVertexAttribArray(static_cast<GLuint>(mVbVertexPositionHandle));
-    glDisableVertexAttribArray(static_cast<GLuint>(mVbTextureCoordHandle));
+    glUniform1i(mVbTexSampler2DHandle, textureUnit);
 
-    if (depthTest)
-        glEnable(GL_DEPTH_TEST);
+    // Pass the projection matrix to OpenGL
+    glUniformMatrix4fv(mVbMvpMatrixHandle, 1, GL_FALSE, renderState.vbProjectionMatrix.data);
 
-    if (cullTest)
-        glEnable(GL_CULL_FACE);
+    // Then, we issue the render call
+    glDrawElements(GL_TRIANGLES, mVbNumIndices, GL_UNSIGNED_INT, nullptr);
+    mDrawCalls++;
 
     GLESUtils::checkGlError("Render video background");
 }
@@ -166,125 +382,98 @@ GLESRenderer::renderWorldOrigin(VuMatrix44F& projectionMatrix, VuMatrix44F& mode
 }
 
 void
-GLESRenderer::renderPause(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix, const VuVector2F &markerSize, const std::string &targetName) {
-    VuMatrix44F scaledModelViewProjectionMatrix = vuMatrix44FMultiplyMatrix(projectionMatrix, scaledModelViewMatrix);
+GLESRenderer::queuePause(const AppController::TrackingFrame::Target& target, const VuMatrix44F& projectionMatrix,
+                         const VuMatrix44F& /*modelViewMatrix*/, const VuMatrix44F& scaledModelViewMatrix) {
+    VPB_TRACE_SCOPE_ID("GLESRenderer::queuePause", target.targetId);
+    if (mNumPauseInstances >= static_cast<int>(mPauseInstances.size()))
+        return;
+
+    VuMatrix44F& scaledModelViewProjectionMatrix = mPauseInstances[mNumPauseInstances++];
+    scaledModelViewProjectionMatrix = multiplyMatrix(projectionMatrix, scaledModelViewMatrix);
+}
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+void
+GLESRenderer::renderPauses() {
+    VPB_TRACE_SCOPE("GLESRenderer::renderPauses");
+    if (mNumPauseInstances == 0)
+        return;
 
-    glUseProgram(_pProgram);
+    setRenderState(true, true, false);
 
-    const GLfloat vertices[] = {
-        -0.5, -0.5, 0.0f, /* 左下 */
-         0.5, -0.5, 0.0f, /* 右下 */
-        -0.5,  0.5, 0.0f, /* 左上 */
-         0.5,  0.5, 0.0f  /* 右上 */
-    };
+    /* 前フレームの内容を待たないようにバッファを捨ててから詰め直す */
+    glBindBuffer(GL_ARRAY_BUFFER, mPauseInstanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(mPauseInstances), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, mNumPauseInstances * sizeof(VuMatrix44F), mPauseInstances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    const GLfloat texCoords[] = {
-        0.0f, 1.0f, /* 左下 */
-        1.0f, 1.0f, /* 右下 */
-        0.0f, 0.0f, /* 左上 */
-        1.0f, 0.0f  /* 右上 */
-    };
+    mState.useProgram(_pProgram);
+    mState.bindVertexArray(mPauseQuadVertexArray);
 
-    glVertexAttribPointer(_paPosition, 3, GL_FLOAT, GL_FALSE, 0, vertices);
-    glVertexAttribPointer(_paTexCoordLoc, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
-    glEnableVertexAttribArray(_paPosition);
-    glEnableVertexAttribArray(_paTexCoordLoc);
-
-    glUniformMatrix4fv(_vuProjectionMatrixLoc, 1, GL_FALSE, &scaledModelViewProjectionMatrix.data[0]);
-
-    /* 当たり判定用に板ポリ座標をNDC(正規化デバイス座標)に変換して保持 */
-    std::array<glm::vec2, 4> ndcQuadPoints = {};
-    int idx = 0;
-    for(int lpct : {0,1,3,2/*左下→右下→右上→左上→左下の順番にする必要がある*/}) {
-        glm::vec4 pos = glm::vec4(vertices[lpct*3], vertices[lpct*3+1],vertices[lpct*3+2],1.0f);
-        glm::vec4 glpos = glm::make_mat4(scaledModelViewProjectionMatrix.data) * pos;
-        glm::vec3 ndcpos = glm::vec3(glpos) / glpos.w;
-        ndcQuadPoints[idx++] = glm::vec2(ndcpos);
-    }
-    _ndcQuadPoints[targetName] = std::pair(std::chrono::system_clock::now(), ndcQuadPoints);
-    /* 古い(1000[ms]過ぎた)データは削除する */
-    for (auto it = _ndcQuadPoints.begin(); it != _ndcQuadPoints.end(); ) {
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now() - it->second.first
-        );
-        if (duration.count() > 1000)
-            it = _ndcQuadPoints.erase(it);  /* erase() は次のイテレータを返す */
-        else
-            ++it;
-    }
+    glUniform2f(_puHalfExtentLoc, PAUSE_QUAD_HALF_EXTENT, PAUSE_QUAD_HALF_EXTENT);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, _pTextureId);
+    mState.activeTexture(GL_TEXTURE0);
+    mState.bindTexture(GL_TEXTURE_2D, _pTextureId);
     glUniform1i(_puSampler2D, 0);
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, mNumPauseInstances);
+    mDrawCalls++;
+    mNumPauseInstances = 0;
 
-    glDisableVertexAttribArray(_paPosition);
-    glDisableVertexAttribArray(_paTexCoordLoc);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glUseProgram(0);
+    GLESUtils::checkGlError("Render pauses");
 }
 
-void
-GLESRenderer::renderVideoPlayback(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix, const VuVector2F &markerSize, const std::string &targetName) {
-    VuMatrix44F scaledModelViewProjectionMatrix = vuMatrix44FMultiplyMatrix(projectionMatrix, scaledModelViewMatrix);
+bool
+GLESRenderer::renderHud(HudOverlay& hud) {
+    if (!_hudEnabled)
+        return false;
 
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    VPB_TRACE_SCOPE("GLESRenderer::renderHud");
+    const int numVertices = hud.build(_screenWidth, _screenHeight);
+    if (numVertices == 0)
+        return true;
 
-    glUseProgram(_vProgram);
+    /* ビデオ背景のビューポートは画面からはみ出すことがあるので、HUDは画面全体に対して描く */
+    glViewport(0, 0, static_cast<GLsizei>(_screenWidth), static_cast<GLsizei>(_screenHeight));
+    setRenderState(false, true, false);
 
-    float scaleX = 0.5f;
-    float scaleY = 0.5f;
+    glBindBuffer(GL_ARRAY_BUFFER, mHudVertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, HudOverlay::MAX_VERTICES * sizeof(HudOverlay::Vertex), nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, numVertices * sizeof(HudOverlay::Vertex), hud.getVertices());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    if(_fullscreenFlg) {
-        scaleX = 1.0f;
-        scaleY = 1.0f;
+    mState.useProgram(mHudProgram);
+    mState.bindVertexArray(mHudVertexArray);
 
-        float videoAspect = _vVideoWidth / _vVideoHeight;
-        float screenAspect= _screenWidth / _screenHeight;
+    mState.activeTexture(GL_TEXTURE0);
+    mState.bindTexture(GL_TEXTURE_2D, mHudAtlasTextureId);
+    glUniform1i(mHudAtlasHandle, 0);
 
-        if (screenAspect > videoAspect) /* 横長動画 → 横を1.0にして縦を縮める */
-            scaleX = videoAspect / screenAspect;
-        else    /* 縦長動画 → 縦を1.0にして横を縮める */
-            scaleY = screenAspect / videoAspect;
-    }
-    else {
-        /* Calculation of vertex coordinates considering the aspect ratio. */
-        float markerAspect = markerSize.data[0] / markerSize.data[1];
-        float videoAspect = _vVideoWidth / _vVideoHeight;
-
-        if(markerAspect > videoAspect)  /* When the marker is wider than the video. */
-            scaleX = scaleX * (videoAspect / markerAspect);
-        else    /* When the marker is taller than the video or has the same aspect ratio. */
-            scaleY = scaleY * (markerAspect / videoAspect);
-    };
+    glDrawArrays(GL_TRIANGLES, 0, numVertices);
+    mDrawCalls++;
 
-    GLfloat vertices[] = {
-        -scaleX, -scaleY, 0.0f, /* 左下 */
-         scaleX, -scaleY, 0.0f, /* 右下 */
-        -scaleX,  scaleY, 0.0f, /* 左上 */
-         scaleX,  scaleY, 0.0f  /* 右上 */
-    };
+    GLESUtils::checkGlError("Render HUD");
+    return true;
+}
 
-    GLfloat texCoords[] = {
-        0.0f, 1.0f, /* 左下 */
-        1.0f, 1.0f, /* 右下 */
-        0.0f, 0.0f, /* 左上 */
-        1.0f, 0.0f  /* 右上 */
-    };
+FrameRenderer::VideoQuad
+GLESRenderer::renderVideoPlayback(const AppController::TrackingFrame::Target& target, const VuMatrix44F& projectionMatrix,
+                                  const VuMatrix44F& /*modelViewMatrix*/, const VuMatrix44F& scaledModelViewMatrix) {
+    VPB_TRACE_SCOPE_ID("GLESRenderer::renderVideoPlayback", target.targetId);
+    VuMatrix44F scaledModelViewProjectionMatrix = multiplyMatrix(projectionMatrix, scaledModelViewMatrix);
+
+    setRenderState(true, true, false);
+
+    mState.useProgram(_vProgram);
+    mState.bindVertexArray(mVideoQuadVertexArray);
 
-    glVertexAttribPointer(_vaPosition, 3, GL_FLOAT, GL_FALSE, 0, vertices);
-    glVertexAttribPointer(_vaTexCoordLoc, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
-    glEnableVertexAttribArray(_vaPosition);
-    glEnableVertexAttribArray(_vaTexCoordLoc);
+    VideoQuad quad;
+    quad.fullscreen = _fullscreenFlg;
+    quad.halfExtent = computeVideoQuadHalfExtent(_fullscreenFlg, _vVideoWidth, _vVideoHeight, _screenWidth, _screenHeight,
+                                                 glm::vec2(target.markerSize.data[0], target.markerSize.data[1]));
+    glUniform2f(_vuHalfExtentLoc, quad.halfExtent.x, quad.halfExtent.y);
 
     if(_fullscreenFlg) {
+        /* 全画面表示は単位行列で描く */
         const GLfloat identityMatrix[16] = {
                 1.0f, 0.0f, 0.0f, 0.0f,
                 0.0f, 1.0f, 0.0f, 0.0f,
@@ -293,93 +482,57 @@ GLESRenderer::renderVideoPlayback(VuMatrix44F& projectionMatrix, VuMatrix44F& mo
         };
         glUniformMatrix4fv(_vuProjectionMatrixLoc, 1, GL_FALSE, identityMatrix);
     }
-    else
+    else {
         glUniformMatrix4fv(_vuProjectionMatrixLoc, 1, GL_FALSE, &scaledModelViewProjectionMatrix.data[0]);
-
-    /* 当たり判定用に板ポリ座標をNDC(正規化デバイス座標)に変換して保持 */
-    std::array<glm::vec2, 4> ndcQuadPoints = {};
-    int idx = 0;
-    for(int lpct : {0,1,3,2/*左下→右下→右上→左上→左下の順番にする必要がある*/}) {
-        glm::vec4 pos = glm::vec4(vertices[lpct*3], vertices[lpct*3+1],vertices[lpct*3+2],1.0f);
-        glm::vec4 glpos = glm::make_mat4(scaledModelViewProjectionMatrix.data) * pos;
-        glm::vec3 ndcpos = glm::vec3(glpos) / glpos.w;
-        ndcQuadPoints[idx++] = glm::vec2(ndcpos);
-    }
-    _ndcQuadPoints[targetName] = std::pair(std::chrono::system_clock::now(), ndcQuadPoints);
-    /* 古い(1000[ms]過ぎた)データは削除する */
-    for (auto it = _ndcQuadPoints.begin(); it != _ndcQuadPoints.end(); ) {
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now() - it->second.first
-        );
-        if (duration.count() > 1000)
-            it = _ndcQuadPoints.erase(it);  /* erase() は次のイテレータを返す */
-        else
-            ++it;
     }
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_EXTERNAL_OES, _vTextureId);
+    mState.activeTexture(GL_TEXTURE0);
+    mState.bindTexture(GL_TEXTURE_EXTERNAL_OES, _vTextureId);
     glUniform1i(_vuSamplerOES, 0);
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-    glDisableVertexAttribArray(_vaPosition);
-    glDisableVertexAttribArray(_vaTexCoordLoc);
-    glBindTexture(GL_TEXTURE_EXTERNAL_OES, 0);
-    glUseProgram(0);
+    mDrawCalls++;
+    return quad;
 }
 
 void
-GLESRenderer::renderImageTarget(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix)
+GLESRenderer::renderImageTarget(const VuMatrix44F& projectionMatrix, const VuMatrix44F& modelViewMatrix, const VuMatrix44F& scaledModelViewMatrix)
 {
-    VuMatrix44F scaledModelViewProjectionMatrix = vuMatrix44FMultiplyMatrix(projectionMatrix, scaledModelViewMatrix);
-
-
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    float stateLineWidth;
-    glGetFloatv(GL_LINE_WIDTH, &stateLineWidth);
+    VuMatrix44F scaledModelViewProjectionMatrix = multiplyMatrix(projectionMatrix, scaledModelViewMatrix);
 
-    glUseProgram(mUniformColorShaderProgramID);
 
-    glVertexAttribPointer(mUniformColorVertexPositionHandle, 3, GL_FLOAT, GL_TRUE, 0, (const GLvoid*)&squareVertices[0]);
+    setRenderState(true, true, false);
 
-    glEnableVertexAttribArray(mUniformColorVertexPositionHandle);
+    mState.useProgram(mUniformColorShaderProgramID);
 
     glUniformMatrix4fv(mUniformColorMvpMatrixHandle, 1, GL_FALSE, &scaledModelViewProjectionMatrix.data[0]);
 
     // Draw translucent solid overlay
     // Color RGBA
     glUniform4f(mUniformColorColorHandle, 1.0, 0.0, 0.0, 0.1);
-    glDrawElements(GL_TRIANGLES, NUM_SQUARE_INDEX, GL_UNSIGNED_SHORT, (const GLvoid*)&squareIndices[0]);
+    mState.bindVertexArray(mSquareVertexArray);
+    glDrawElements(GL_TRIANGLES, NUM_SQUARE_INDEX, GL_UNSIGNED_SHORT, nullptr);
+    mDrawCalls++;
 
     // Draw solid outline
     glUniform4f(mUniformColorColorHandle, 1.0, 0.0, 0.0, 1.0);
-    glLineWidth(4.0f);
-    glDrawElements(GL_LINES, NUM_SQUARE_WIREFRAME_INDEX, GL_UNSIGNED_SHORT, (const GLvoid*)&squareWireframeIndices[0]);
-
-    glDisableVertexAttribArray(mUniformColorVertexPositionHandle);
+    mState.lineWidth(4.0f);
+    mState.bindVertexArray(mSquareWireframeVertexArray);
+    glDrawElements(GL_LINES, NUM_SQUARE_WIREFRAME_INDEX, GL_UNSIGNED_SHORT, nullptr);
+    mDrawCalls++;
 
     GLESUtils::checkGlError("Render Image Target");
 
-    glLineWidth(stateLineWidth);
-
-    glDisable(GL_BLEND);
-    glDisable(GL_DEPTH_TEST);
-
     VuVector3F axis2cmSize{ 0.02f, 0.02f, 0.02f };
     renderAxis(projectionMatrix, modelViewMatrix, axis2cmSize, 4.0f);
 
-    VuMatrix44F modelViewProjectionMatrix = vuMatrix44FMultiplyMatrix(projectionMatrix, modelViewMatrix);
-    renderModel(modelViewProjectionMatrix, mAstronautVertexCount, mAstronautVertices.data(), mAstronautTexCoords.data(),
-                mAstronautTextureId);
+    VuMatrix44F modelViewProjectionMatrix = multiplyMatrix(projectionMatrix, modelViewMatrix);
+    renderModel(modelViewProjectionMatrix, mAstronautVertexArray, mAstronautVertexCount, mAstronautTextureId);
 }
 
 
 void
-GLESRenderer::createTexture(int width, int height, unsigned char* bytes, GLuint& textureId)
+GLESRenderer::createTexture(int width, int height, const unsigned char* bytes, GLuint& textureId)
 {
     if (textureId != -1)
     {
@@ -387,6 +540,21 @@ GLESRenderer::createTexture(int width, int height, unsigned char* bytes, GLuint&
         textureId = -1;
     }
     textureId = GLESUtils::createTexture(width, height, bytes);
+    // GLESUtils binds the new texture directly
+    mState.invalidateTextures();
+}
+
+
+void
+GLESRenderer::setRenderState(bool depthTest, bool blend, bool cullFace)
+{
+    mState.setEnabled(GL_DEPTH_TEST, depthTest);
+    mState.setEnabled(GL_BLEND, blend);
+    mState.setEnabled(GL_CULL_FACE, cullFace);
+    if (blend)
+    {
+        mState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
 }
 
 
@@ -397,28 +565,21 @@ GLESRenderer::renderCube(const VuMatrix44F& projectionMatrix, const VuMatrix44F&
     VuMatrix44F modelViewProjectionMatrix;
     VuVector3F scaleVec{ scale, scale, scale };
 
-    scaledModelViewMatrix = vuMatrix44FScale(scaleVec, modelViewMatrix);
-    modelViewProjectionMatrix = vuMatrix44FMultiplyMatrix(projectionMatrix, scaledModelViewMatrix);
+    scaledModelViewMatrix = scaleMatrix(scaleVec, modelViewMatrix);
+    modelViewProjectionMatrix = multiplyMatrix(projectionMatrix, scaledModelViewMatrix);
 
     ///////////////////////////////////////////////////////////////
     // Render with const ambient diffuse light uniform color shader
-    glEnable(GL_DEPTH_TEST);
-    glUseProgram(mUniformColorShaderProgramID);
-
-    glEnableVertexAttribArray(mUniformColorVertexPositionHandle);
-
-    glVertexAttribPointer(mUniformColorVertexPositionHandle, 3, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)&cubeVertices[0]);
+    setRenderState(true, false, false);
+    mState.useProgram(mUniformColorShaderProgramID);
+    mState.bindVertexArray(mCubeVertexArray);
 
     glUniformMatrix4fv(mUniformColorMvpMatrixHandle, 1, GL_FALSE, (GLfloat*)modelViewProjectionMatrix.data);
     glUniform4f(mUniformColorColorHandle, color.data[0], color.data[1], color.data[2], color.data[3]);
 
     // Draw
-    glDrawElements(GL_TRIANGLES, NUM_CUBE_INDEX, GL_UNSIGNED_SHORT, (const GLvoid*)&cubeIndices[0]);
-
-    // disable input data structures
-    glDisableVertexAttribArray(mUniformColorVertexPositionHandle);
-    glUseProgram(0);
-    glDisable(GL_DEPTH_TEST);
+    glDrawElements(GL_TRIANGLES, NUM_CUBE_INDEX, GL_UNSIGNED_SHORT, nullptr);
+    mDrawCalls++;
 
     GLESUtils::checkGlError("Render cube");
     ///////////////////////////////////////////////////////
@@ -431,37 +592,22 @@ GLESRenderer::renderAxis(const VuMatrix44F& projectionMatrix, const VuMatrix44F&
     VuMatrix44F scaledModelViewMatrix;
     VuMatrix44F modelViewProjectionMatrix;
 
-    scaledModelViewMatrix = vuMatrix44FScale(scale, modelViewMatrix);
-    modelViewProjectionMatrix = vuMatrix44FMultiplyMatrix(projectionMatrix, scaledModelViewMatrix);
+    scaledModelViewMatrix = scaleMatrix(scale, modelViewMatrix);
+    modelViewProjectionMatrix = multiplyMatrix(projectionMatrix, scaledModelViewMatrix);
 
     ///////////////////////////////////////////////////////
     // Render with vertex color shader
-    glEnable(GL_DEPTH_TEST);
-    glUseProgram(mVertexColorShaderProgramID);
-
-    glEnableVertexAttribArray(mVertexColorVertexPositionHandle);
-    glVertexAttribPointer(mVertexColorVertexPositionHandle, 3, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)&axisVertices[0]);
-
-    glEnableVertexAttribArray(mVertexColorColorHandle);
-    glVertexAttribPointer(mVertexColorColorHandle, 4, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)&axisColors[0]);
+    setRenderState(true, false, false);
+    mState.useProgram(mVertexColorShaderProgramID);
+    mState.bindVertexArray(mAxisVertexArray);
 
     glUniformMatrix4fv(mVertexColorMvpMatrixHandle, 1, GL_FALSE, (GLfloat*)modelViewProjectionMatrix.data);
 
     // Draw
-    float stateLineWidth;
-    glGetFloatv(GL_LINE_WIDTH, &stateLineWidth);
+    mState.lineWidth(lineWidth);
 
-    glLineWidth(lineWidth);
-
-    glDrawElements(GL_LINES, NUM_AXIS_INDEX, GL_UNSIGNED_SHORT, (const GLvoid*)&axisIndices[0]);
-
-    // disable input data structures
-    glDisableVertexAttribArray(mVertexColorVertexPositionHandle);
-    glDisableVertexAttribArray(mVertexColorColorHandle);
-    glUseProgram(0);
-    glDisable(GL_DEPTH_TEST);
-
-    glLineWidth(stateLineWidth);
+    glDrawElements(GL_LINES, NUM_AXIS_INDEX, GL_UNSIGNED_SHORT, nullptr);
+    mDrawCalls++;
 
     GLESUtils::checkGlError("Render axis");
     ///////////////////////////////////////////////////////
@@ -469,27 +615,17 @@ GLESRenderer::renderAxis(const VuMatrix44F& projectionMatrix, const VuMatrix44F&
 
 
 void
-GLESRenderer::renderModel(VuMatrix44F modelViewProjectionMatrix, const int numVertices, const float* vertices,
-                          const float* textureCoordinates, GLuint textureId)
+GLESRenderer::renderModel(VuMatrix44F modelViewProjectionMatrix, GLuint vertexArray, const int numVertices, GLuint textureId)
 {
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
-
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glUseProgram(mTextureUniformColorShaderProgramID);
-
-    glEnableVertexAttribArray(mTextureUniformColorVertexPositionHandle);
-    glVertexAttribPointer(mTextureUniformColorVertexPositionHandle, 3, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)vertices);
+    setRenderState(true, true, true);
+    mState.cullFace(GL_BACK);
+    mState.frontFace(GL_CCW);
 
-    glEnableVertexAttribArray(mTextureUniformColorTextureCoordHandle);
-    glVertexAttribPointer(mTextureUniformColorTextureCoordHandle, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)textureCoordinates);
+    mState.useProgram(mTextureUniformColorShaderProgramID);
+    mState.bindVertexArray(vertexArray);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    mState.activeTexture(GL_TEXTURE0);
+    mState.bindTexture(GL_TEXTURE_2D, textureId);
 
     glUniformMatrix4fv(mTextureUniformColorMvpMatrixHandle, 1, GL_FALSE, (GLfloat*)modelViewProjectionMatrix.data);
     glUniform4f(mTextureUniformColorColorHandle, 1.0f, 1.0f, 1.0f, 1.0f);
@@ -497,114 +633,7 @@ GLESRenderer::renderModel(VuMatrix44F modelViewProjectionMatrix, const int numVe
 
     // Draw
     glDrawArrays(GL_TRIANGLES, 0, numVertices);
-
-    // disable input data structures
-    glDisableVertexAttribArray(mTextureUniformColorTextureCoordHandle);
-    glDisableVertexAttribArray(mTextureUniformColorVertexPositionHandle);
-    glUseProgram(0);
-
-    glBindTexture(GL_TEXTURE_2D, 0);
+    mDrawCalls++;
 
     GLESUtils::checkGlError("Render model");
-
-    glDisable(GL_BLEND);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_DEPTH_TEST);
-}
-
-
-bool
-GLESRenderer::readAsset(AAssetManager* assetManager, const char* filename, std::vector<char>& data)
-{
-    LOG("Reading asset %s", filename);
-    AAsset* asset = AAssetManager_open(assetManager, filename, AASSET_MODE_STREAMING);
-    if (asset == nullptr)
-    {
-        LOG("Error opening asset file %s", filename);
-        return false;
-    }
-    auto assetSize = AAsset_getLength(asset);
-    data.reserve(assetSize);
-    char buf[BUFSIZ];
-    int nb_read = 0;
-    while ((nb_read = AAsset_read(asset, buf, BUFSIZ)) > 0)
-    {
-        std::copy(&buf[0], &buf[BUFSIZ], std::back_inserter(data));
-    }
-    AAsset_close(asset);
-    if (nb_read < 0)
-    {
-        LOG("Error reading asset file %s", filename);
-        return false;
-    }
-    return true;
-}
-
-
-bool
-GLESRenderer::loadObjModel(const std::vector<char>& data, int& numVertices, std::vector<float>& vertices, std::vector<float>& texCoords)
-{
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-
-    std::string warn;
-    std::string err;
-
-    MemoryInputStream aFileDataStream(data.data(), data.size());
-    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &aFileDataStream);
-    if (!ret || !err.empty())
-    {
-        LOG("Error loading model (%s)", err.c_str());
-        return false;
-    }
-    if (!warn.empty())
-    {
-        LOG("Warning loading model (%s)", warn.c_str());
-    }
-
-    numVertices = 0;
-    vertices.clear();
-    texCoords.clear();
-    // Loop over shapes
-    // s is the index into the shapes vector
-    // f is the index of the current face
-    // v is the index of the current vertex
-    for (size_t s = 0; s < shapes.size(); ++s)
-    {
-        // Loop over faces(polygon)
-        size_t index_offset = 0;
-        for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); ++f)
-        {
-            int fv = shapes[s].mesh.num_face_vertices[f];
-            numVertices += fv;
-
-            // Loop over vertices in the face.
-            for (size_t v = 0; v < fv; ++v)
-            {
-                // access to vertex
-                tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
-
-                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 0]);
-                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 1]);
-                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 2]);
-
-                // The model may not have texture coordinates for every vertex
-                // If a texture coordinate is missing we just set it to 0,0
-                // This may not be suitable for rendering some OBJ model files
-                if (idx.texcoord_index < 0)
-                {
-                    texCoords.push_back(0.f);
-                    texCoords.push_back(0.f);
-                }
-                else
-                {
-                    texCoords.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
-                    texCoords.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
-                }
-            }
-            index_offset += fv;
-        }
-    }
-    return true;
 }
@@ -17,47 +17,82 @@ countries.
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
-#include <android/asset_manager.h>
-#include "tiny_obj_loader.h"
+#include "FrameLoop.h"
+#include "GLESGeometry.h"
+#include "GLESStateCache.h"
+#include "HudOverlay.h"
+#include "InitPipeline.h"
+#include "MeshSignature.h"
+#include "RenderCommand.h"
 #include "VuforiaEngine/VuforiaEngine.h"
 #include <vector>
-#include <map>
 #include <array>
-#include <chrono>
 
 /// Class to encapsulate OpenGLES rendering for the sample
-class GLESRenderer
+class GLESRenderer : public FrameRenderer
 {
 public:
-    /// Initialize the renderer ready for use
-    bool init(AAssetManager* assetManager);
+    /// Initialize the renderer ready for use: shaders and static meshes
+    bool init();
+
+    /// Upload the model and textures loaded by pipeline, waiting for the tasks that are still running
+    /**
+     * Returns false if one of them failed to load. Call after init(), again after a new context.
+     */
+    bool uploadStartupAssets(InitPipeline& pipeline);
     /// Clean up objects created during rendering
     void deinit();
 
-    void setAstronautTexture(int width, int height, unsigned char* bytes);
-    void setPauseTexture(int width, int height, unsigned char* bytes);
+    /// Start of every frame (FrameLoop): apply the posted commands and clear the color and depth buffers
+    void beginFrame() override;
+
+    /// UI thread (single producer): queue a setting change, applied by processCommands() on the render thread.
+    /// Returns false if the queue is full.
+    bool postCommand(const RenderCommand& command) { return mCommands.tryPush(command); }
+
+    /// Render thread: apply the commands posted since the last call, called by beginFrame()
+    void processCommands();
+
+    /// Render thread: set the GL surface size (configureRendering and onSurfaceChanged run on the render thread)
+    void setScreenSize(float width, float height);
 
-    /// Render the video background
-    void renderVideoBackground(const VuMatrix44F& projectionMatrix, const float* vertices, const float* textureCoordinates,
-                               const int numTriangles, const unsigned int* indices, int textureUnit);
+    /// Draw calls issued since beginFrame() and GL calls issued and avoided by the state cache since init()
+    Counters getCounters() const override;
+
+    void setAstronautTexture(int width, int height, const unsigned char* bytes);
+    void setPauseTexture(int width, int height, const unsigned char* bytes);
+
+    /// Set the viewport and render the video background of frame, after the engine updated its texture
+    /**
+     * The mesh is kept in GPU buffers and only uploaded again when its signature (pointer, sizes, content hash) changes.
+     */
+    void renderVideoBackground(const AppController::TrackingFrame& frame, const double* viewport, int textureUnit) override;
 
     /// Render augmentation for the world origin
     void renderWorldOrigin(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix);
 
-    /* Render a bounding box augmentation on an Pause image */
-    void renderPause(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix, const VuVector2F &markerSize, const std::string &targetName);
+    /* Queue the Pause image of a target, drawn for all targets at once by renderPauses() */
+    void queuePause(const AppController::TrackingFrame::Target& target, const VuMatrix44F& projectionMatrix,
+                    const VuMatrix44F& modelViewMatrix, const VuMatrix44F& scaledModelViewMatrix) override;
+
+    /* Render all queued Pause images with a single instanced draw call */
+    void renderPauses() override;
+
+    /* Render the performance HUD over the whole screen with a single draw call, last in the frame (RenderCommand::hud) */
+    bool renderHud(HudOverlay& hud) override;
 
-    /* Render a bounding box augmentation on an Video PlayBack */
-    void renderVideoPlayback(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix, const VuVector2F &markerSize, const std::string &targetName);
+    /* Render the video on a target, or over the whole screen in fullscreen mode */
+    VideoQuad renderVideoPlayback(const AppController::TrackingFrame::Target& target, const VuMatrix44F& projectionMatrix,
+                                  const VuMatrix44F& modelViewMatrix, const VuMatrix44F& scaledModelViewMatrix) override;
 
     /// Render a bounding box augmentation on an Image Target
-    void renderImageTarget(VuMatrix44F& projectionMatrix, VuMatrix44F& modelViewMatrix, VuMatrix44F& scaledModelViewMatrix);
+    void renderImageTarget(const VuMatrix44F& projectionMatrix, const VuMatrix44F& modelViewMatrix, const VuMatrix44F& scaledModelViewMatrix);
 
 private: // methods
     /// Attempt to create a texture from bytes
     /// If the value of textureId is not -1 it is assumed that it refers to an existing texture
     /// that should be destroyed and replaced with a new one.
-    void createTexture(int width, int height, unsigned char* bytes, GLuint& textureId);
+    void createTexture(int width, int height, const unsigned char* bytes, GLuint& textureId);
 
     /// Render a filled 3D cube
     /*
@@ -78,22 +113,20 @@ private: // methods
     void renderAxis(const VuMatrix44F& projectionMatrix, const VuMatrix44F& modelViewMatrix, const VuVector3F& scale,
                     float lineWidth = 2.0f);
 
-    /// Render a 3D model
-    void renderModel(VuMatrix44F modelViewProjectionMatrix, const int numVertices, const float* vertices, const float* textureCoordinates,
-                     GLuint textureId);
+    /// Render a 3D model (vertex array created by createGeometry)
+    void renderModel(VuMatrix44F modelViewProjectionMatrix, GLuint vertexArray, const int numVertices, GLuint textureId);
 
-    /// Read an asset file into a byte vector
-    bool readAsset(AAssetManager* assetManager, const char* filename, std::vector<char>& data);
+    /// Set the enables used by the draw helpers (blending is always GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+    void setRenderState(bool depthTest, bool blend, bool cullFace);
 
-    /// Load a model from an OBJ file
-    /*
-     * The model is input as the data array, the vertex and texture coordinate
-     * vectors are populated by this method as it reads the input.
-     */
-    bool loadObjModel(const std::vector<char>& data, int& numVertices, std::vector<float>& vertices, std::vector<float>& texCoords);
+    /// Upload the video background mesh if it differs from the cached one
+    void updateVideoBackgroundMesh(const VuMesh& mesh);
 
-public:
-    /* Screen size and video size */
+    /// Upload the static meshes into buffers and create the vertex arrays for the programs using them
+    void createGeometry();
+
+private:
+    /* Screen size and video size (描画スレッドだけが触る。UIスレッドからはpostCommandで変更) */
     float _vVideoWidth = 0.0f;
     float _vVideoHeight = 0.0f;
     float _screenWidth  = 0.0f;
@@ -102,12 +135,20 @@ public:
     /* Fullscreen mode flag */
     bool  _fullscreenFlg = false;
 
+    /* 性能HUDの表示フラグ */
+    bool  _hudEnabled = false;
+
+    /* UIスレッド → 描画スレッドの設定変更 */
+    RenderCommandQueue mCommands;
+
+public:
     /* For video playback rendering */
     GLuint _vTextureId = 0;
     GLuint _vProgram = 0;
     GLint _vaPosition = -1;
     GLint _vaTexCoordLoc = -1;
     GLint _vuProjectionMatrixLoc = -1;
+    GLint _vuHalfExtentLoc = -1;
     GLint _vuSamplerOES = -1;
 
     /* For pause.png rendering */
@@ -115,13 +156,10 @@ public:
     GLuint _pProgram = 0;
     GLint _paPosition = -1;
     GLint _paTexCoordLoc = -1;
-    GLint _puProjectionMatrixLoc = -1;
+    GLint _paModelViewProjection = -1;
+    GLint _puHalfExtentLoc = -1;
     GLint _puSampler2D = -1;
 
-    /* NDC(正規化デバイス)座標系の矩形座標 */
-    using lastupdate = std::chrono::time_point<std::chrono::system_clock>;
-    std::map<std::string, std::pair<lastupdate, std::array<glm::vec2, 4>>> _ndcQuadPoints;
-
 private: // data members
     // For video background rendering
     GLuint mVbShaderProgramID = 0;
@@ -129,6 +167,12 @@ private: // data members
     GLint mVbTextureCoordHandle = 0;
     GLint mVbMvpMatrixHandle = 0;
     GLint mVbTexSampler2DHandle = 0;
+    GLuint mVbPositionBuffer = 0;
+    GLuint mVbTexCoordBuffer = 0;
+    GLuint mVbIndexBuffer = 0;
+    GLuint mVbVertexArray = 0;
+    GLsizei mVbNumIndices = 0;
+    MeshSignature mVbMeshSignature;
 
     // For augmentation rendering
     GLuint mUniformColorShaderProgramID = 0;
@@ -151,11 +195,39 @@ private: // data members
     GLint mVertexColorColorHandle = 0;
     GLint mVertexColorMvpMatrixHandle = 0;
 
-    // For rendering the Astronaut, loaded from the obj file
-    int mAstronautVertexCount;
-    std::vector<float> mAstronautVertices;
-    std::vector<float> mAstronautTexCoords;
+    // For rendering the Astronaut, loaded from the obj file by the InitPipeline
+    int mAstronautVertexCount = 0;
     GLuint mAstronautTextureId = -1;
+
+    // Shadow of the GL state, all state changes of the draw helpers go through it
+    GLESStateCache mState;
+    // Draw calls of the current frame, reset in beginFrame()
+    int mDrawCalls = 0;
+
+    // Static meshes, uploaded once in init()
+    GLESGeometry mGeometry;
+    /* 動画・pause.pngは同じ単位矩形(±1)を共有し、サイズはu_HalfExtentで指定する */
+    GLuint mVideoQuadVertexArray = 0;
+    GLuint mPauseQuadVertexArray = 0;
+    /* pause.pngのインスタンスごとのMVP(フレーム中に溜めてrenderPauses()で一括転送) */
+    GLuint mPauseInstanceBuffer = 0;
+    std::array<VuMatrix44F, TargetRegistry::MAX_TARGETS> mPauseInstances{};
+    int mNumPauseInstances = 0;
+    GLuint mSquareVertexArray = 0;
+    GLuint mSquareWireframeVertexArray = 0;
+    GLuint mCubeVertexArray = 0;
+    GLuint mAxisVertexArray = 0;
+    GLuint mAstronautVertexArray = 0;
+
+    // For the performance HUD: font atlas and a vertex buffer refilled by renderHud()
+    GLuint mHudProgram = 0;
+    GLint mHudPositionHandle = -1;
+    GLint mHudTexCoordHandle = -1;
+    GLint mHudColorHandle = -1;
+    GLint mHudAtlasHandle = -1;
+    GLuint mHudAtlasTextureId = -1;
+    GLuint mHudVertexBuffer = 0;
+    GLuint mHudVertexArray = 0;
 };
 
 #endif //_VUFORIA_GLESRENDERER_H_
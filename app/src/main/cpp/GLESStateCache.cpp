@@ -0,0 +1,154 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "GLESStateCache.h"
+
+#include <cassert>
+
+
+void
+GLESStateCache::invalidate()
+{
+    for (auto& enabled : mEnabled)
+    {
+        enabled.known = false;
+    }
+    mBlendSourceFactor.known = false;
+    mBlendDestinationFactor.known = false;
+    mCullFace.known = false;
+    mFrontFace.known = false;
+    mLineWidth.known = false;
+    mProgram.known = false;
+    mVertexArray.known = false;
+    invalidateTextures();
+}
+
+
+void
+GLESStateCache::invalidateTextures()
+{
+    mActiveTexture.known = false;
+    for (auto& unit : mTextures)
+    {
+        for (auto& texture : unit)
+        {
+            texture.known = false;
+        }
+    }
+}
+
+
+void
+GLESStateCache::setEnabled(GLenum capability, bool enabled)
+{
+    Capability index;
+    switch (capability)
+    {
+        case GL_DEPTH_TEST: index = CAPABILITY_DEPTH_TEST; break;
+        case GL_BLEND: index = CAPABILITY_BLEND; break;
+        case GL_CULL_FACE: index = CAPABILITY_CULL_FACE; break;
+        default:
+            assert(!"untracked capability");
+            enabled ? glEnable(capability) : glDisable(capability);
+            return;
+    }
+
+    if (change(mEnabled[index], enabled))
+    {
+        enabled ? glEnable(capability) : glDisable(capability);
+    }
+}
+
+
+void
+GLESStateCache::blendFunc(GLenum sourceFactor, GLenum destinationFactor)
+{
+    // Evaluate both so the shadow values stay in sync, then issue a single call
+    bool sourceChanged = change(mBlendSourceFactor, sourceFactor);
+    bool destinationChanged = change(mBlendDestinationFactor, destinationFactor);
+    if (sourceChanged || destinationChanged)
+    {
+        glBlendFunc(sourceFactor, destinationFactor);
+    }
+}
+
+
+void
+GLESStateCache::cullFace(GLenum mode)
+{
+    if (change(mCullFace, mode))
+    {
+        glCullFace(mode);
+    }
+}
+
+
+void
+GLESStateCache::frontFace(GLenum mode)
+{
+    if (change(mFrontFace, mode))
+    {
+        glFrontFace(mode);
+    }
+}
+
+
+void
+GLESStateCache::lineWidth(GLfloat width)
+{
+    if (change(mLineWidth, width))
+    {
+        glLineWidth(width);
+    }
+}
+
+
+void
+GLESStateCache::useProgram(GLuint program)
+{
+    if (change(mProgram, program))
+    {
+        glUseProgram(program);
+    }
+}
+
+
+void
+GLESStateCache::bindVertexArray(GLuint vertexArray)
+{
+    if (change(mVertexArray, vertexArray))
+    {
+        glBindVertexArray(vertexArray);
+    }
+}
+
+
+void
+GLESStateCache::activeTexture(GLenum unit)
+{
+    if (change(mActiveTexture, unit))
+    {
+        glActiveTexture(unit);
+    }
+}
+
+
+void
+GLESStateCache::bindTexture(GLenum target, GLuint texture)
+{
+    int unit = mActiveTexture.known ? static_cast<int>(mActiveTexture.value - GL_TEXTURE0) : -1;
+    int index = target == GL_TEXTURE_EXTERNAL_OES ? TEXTURE_TARGET_EXTERNAL_OES : TEXTURE_TARGET_2D;
+    if (unit < 0 || unit >= MAX_TEXTURE_UNITS || (target != GL_TEXTURE_2D && target != GL_TEXTURE_EXTERNAL_OES))
+    {
+        // Unknown or untracked unit: bind without caching
+        mCounters.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (change(mTextures[unit][index], texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
@@ -0,0 +1,109 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __GLESSTATECACHE_H__
+#define __GLESSTATECACHE_H__
+
+#include <GLES3/gl31.h>
+#include <GLES2/gl2ext.h>
+
+#include <cstdint>
+
+/// Shadow copy of the GL state touched by GLESRenderer
+/**
+ * Every setter compares against the shadow value and only calls GL when the state actually changes,
+ * so helpers can simply declare the state they need instead of saving and restoring it with glGet*.
+ * The cache never reads state back from the driver: after invalidate() (new context, or code outside
+ * the renderer changed the state) every value is unknown and the next setter always calls GL.
+ */
+class GLESStateCache
+{
+public:
+    /// Number of tracked texture units (GL_TEXTURE0 ...)
+    static constexpr int MAX_TEXTURE_UNITS = 4;
+
+    /// GL calls issued and avoided since the last resetCounters()
+    struct Counters
+    {
+        uint64_t issued{ 0 };
+        uint64_t skipped{ 0 };
+    };
+
+    /// Forget all state, e.g. for a new context
+    void invalidate();
+
+    /// Forget the active texture unit and the texture bindings
+    /**
+     * Call once per frame: SurfaceTexture.updateTexImage() and the engine's video background update
+     * bind textures behind the renderer's back.
+     */
+    void invalidateTextures();
+
+    /// glEnable / glDisable for GL_DEPTH_TEST, GL_BLEND and GL_CULL_FACE
+    void setEnabled(GLenum capability, bool enabled);
+    void blendFunc(GLenum sourceFactor, GLenum destinationFactor);
+    void cullFace(GLenum mode);
+    void frontFace(GLenum mode);
+    void lineWidth(GLfloat width);
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vertexArray);
+    void activeTexture(GLenum unit);
+    /// glBindTexture for GL_TEXTURE_2D or GL_TEXTURE_EXTERNAL_OES on the active unit
+    void bindTexture(GLenum target, GLuint texture);
+
+    const Counters& getCounters() const { return mCounters; }
+    void resetCounters() { mCounters = Counters(); }
+
+private:
+    template<typename T>
+    struct Tracked
+    {
+        T value{};
+        bool known{ false };
+    };
+
+    /// Update the shadow value and return true if GL has to be called
+    template<typename T>
+    bool change(Tracked<T>& tracked, T value)
+    {
+        if (tracked.known && tracked.value == value)
+        {
+            mCounters.skipped++;
+            return false;
+        }
+        tracked.value = value;
+        tracked.known = true;
+        mCounters.issued++;
+        return true;
+    }
+
+    enum Capability
+    {
+        CAPABILITY_DEPTH_TEST,
+        CAPABILITY_BLEND,
+        CAPABILITY_CULL_FACE,
+        NUM_CAPABILITIES
+    };
+    enum TextureTarget
+    {
+        TEXTURE_TARGET_2D,
+        TEXTURE_TARGET_EXTERNAL_OES,
+        NUM_TEXTURE_TARGETS
+    };
+
+    Tracked<bool> mEnabled[NUM_CAPABILITIES];
+    Tracked<GLenum> mBlendSourceFactor;
+    Tracked<GLenum> mBlendDestinationFactor;
+    Tracked<GLenum> mCullFace;
+    Tracked<GLenum> mFrontFace;
+    Tracked<GLfloat> mLineWidth;
+    Tracked<GLuint> mProgram;
+    Tracked<GLuint> mVertexArray;
+    Tracked<GLenum> mActiveTexture;
+    Tracked<GLuint> mTextures[MAX_TEXTURE_UNITS][NUM_TEXTURE_TARGETS];
+
+    Counters mCounters;
+};
+
+#endif // __GLESSTATECACHE_H__
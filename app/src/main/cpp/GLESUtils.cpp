@@ -6,6 +6,7 @@ countries.
 ===============================================================================*/
 
 #include "GLESUtils.h"
+#include "Tracer.h"
 
 #include <stdlib.h>
 
@@ -62,6 +63,7 @@ GLESUtils::initShader(GLenum shaderType, const char* source)
 GLuint
 GLESUtils::createProgramFromBuffer(const char* vertexShaderBuffer, const char* fragmentShaderBuffer)
 {
+    VPB_TRACE_SCOPE("GLESUtils::createProgramFromBuffer");
     GLuint vertexShader = initShader(GL_VERTEX_SHADER, vertexShaderBuffer);
     if (!vertexShader)
         return 0;
@@ -161,7 +163,7 @@ GLESUtils::createTexture(const VuImageInfo& image)
 
 
 GLuint
-GLESUtils::createTexture(int width, int height, unsigned char* data, GLenum format)
+GLESUtils::createTexture(int width, int height, const unsigned char* data, GLenum format)
 {
     GLuint gl_TextureID = -1;
 
@@ -36,7 +36,7 @@ public:
     static GLuint createTexture(const VuImageInfo& image);
 
     /// Create a texture from a byte vector
-    static unsigned int createTexture(int width, int height, unsigned char* data, GLenum format = GL_RGBA);
+    static unsigned int createTexture(int width, int height, const unsigned char* data, GLenum format = GL_RGBA);
 
     /// Clean up texture
     static bool destroyTexture(GLuint textureId);
@@ -0,0 +1,37 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "HitTest.h"
+
+
+glm::vec2
+screenToNdc(float x, float y, float screenWidth, float screenHeight)
+{
+    /* タッチ座標を スクリーン座標 → NDC(正規化デバイス座標-1～1)に変換 */
+    float ndcX = (2.0f * x / screenWidth) - 1.0f;
+    float ndcY = 1.0f - (2.0f * y / screenHeight); /* Y軸は反転してOpenGL系に合わせる */
+    return glm::vec2(ndcX, ndcY);
+}
+
+
+/* 2Dベクトルの外積(z成分)の算出関数 */
+float
+cross2D(const glm::vec2& v1, const glm::vec2& v2)
+{
+    return v1.x * v2.y - v1.y * v2.x;
+}
+
+
+/* タッチ座標と四角形頂点座標からコリジョン判定 */
+/* 0 → 1 → 2 → 3 → 0 の淳で判定 */
+bool
+checkPolygonHit(const glm::vec2& targetPoint, const std::array<glm::vec2, 4>& ndcQuadPoints)
+{
+    float z0 = cross2D(ndcQuadPoints[1] - ndcQuadPoints[0], targetPoint - ndcQuadPoints[0]);
+    float z1 = cross2D(ndcQuadPoints[2] - ndcQuadPoints[1], targetPoint - ndcQuadPoints[1]);
+    float z2 = cross2D(ndcQuadPoints[3] - ndcQuadPoints[2], targetPoint - ndcQuadPoints[2]);
+    float z3 = cross2D(ndcQuadPoints[0] - ndcQuadPoints[3], targetPoint - ndcQuadPoints[3]);
+    return (z0 >= 0 && z1 >= 0 && z2 >= 0 && z3 >= 0) || /* 全部が0以上　もしくは */
+           (z0 <= 0 && z1 <= 0 && z2 <= 0 && z3 <= 0);   /* 全部が0以下 */
+}
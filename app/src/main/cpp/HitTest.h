@@ -0,0 +1,24 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __HITTEST_H__
+#define __HITTEST_H__
+
+#include "glm/glm.hpp"
+
+#include <array>
+
+/// Convert a touch position in screen pixels to NDC (-1..1, Y up as in OpenGL)
+glm::vec2 screenToNdc(float x, float y, float screenWidth, float screenHeight);
+
+/// 2D cross product (z component)
+float cross2D(const glm::vec2& v1, const glm::vec2& v2);
+
+/// Check whether targetPoint lies inside the convex quad ndcQuadPoints.
+/**
+ * The corners must be ordered around the outline (0 -> 1 -> 2 -> 3 -> 0), either winding is accepted.
+ */
+bool checkPolygonHit(const glm::vec2& targetPoint, const std::array<glm::vec2, 4>& ndcQuadPoints);
+
+#endif // __HITTEST_H__
@@ -0,0 +1,401 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "HudOverlay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+namespace
+{
+struct Glyph
+{
+    char character;
+    /// Rows top to bottom, bit 4 is the leftmost pixel
+    uint8_t rows[7];
+};
+
+/* 5x7のビットマップフォント。小文字は大文字で表示する */
+const Glyph GLYPHS[] = {
+    { ' ', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 } },
+    { '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+    { '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+    { '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+    { '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+    { '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+    { '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+    { '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+    { '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+    { '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+    { 'A', { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+    { 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+    { 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+    { 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+    { 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+    { 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+    { 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+    { 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+    { 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+    { 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+    { 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+    { 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+    { 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+    { 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+    { 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+    { 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+    { 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+    { 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+    { 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+    { 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+    { 'Y', { 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x04 } },
+    { 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+    { '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+    { ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+    { '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+    { '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+    { '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+    { '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+    { ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+    { '=', { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 } },
+    { '+', { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 } },
+    { '|', { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+    { '_', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F } },
+    { '#', { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A } },
+};
+constexpr int NUM_GLYPHS = sizeof(GLYPHS) / sizeof(GLYPHS[0]);
+/// Fully covered cell after the glyphs, used for the panel and the graph
+constexpr int SOLID_GLYPH = NUM_GLYPHS;
+static_assert(SOLID_GLYPH < HudOverlay::ATLAS_COLUMNS * HudOverlay::ATLAS_ROWS, "The glyphs do not fit in the atlas");
+
+constexpr int STAGE_COUNT = 4;
+const LatencyStats::Stage STAGES[STAGE_COUNT] = {
+    LatencyStats::Stage::PREPARE, LatencyStats::Stage::OBSERVATIONS, LatencyStats::Stage::DRAW, LatencyStats::Stage::FINISH
+};
+
+/// Weight of a new frame in the displayed averages
+constexpr float AVERAGE_WEIGHT = 0.1f;
+/// Frame time budgets drawn as lines in the graph, 60 and 30 fps
+constexpr float BUDGET_60_MS = 1000.0f / 60.0f;
+constexpr float BUDGET_30_MS = 1000.0f / 30.0f;
+/// Characters per text line
+constexpr int MAX_LINE_LENGTH = 40;
+
+constexpr uint32_t
+rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+    /* メモリ上でR,G,B,Aの順(リトルエンディアン) */
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+constexpr uint32_t PANEL_COLOR = rgba(0, 0, 0, 150);
+constexpr uint32_t TEXT_COLOR = rgba(255, 255, 255, 255);
+constexpr uint32_t LABEL_COLOR = rgba(160, 200, 255, 255);
+constexpr uint32_t GOOD_COLOR = rgba(80, 220, 80, 255);
+constexpr uint32_t SLOW_COLOR = rgba(240, 200, 40, 255);
+constexpr uint32_t JANK_COLOR = rgba(240, 60, 60, 255);
+constexpr uint32_t BUDGET_COLOR = rgba(255, 255, 255, 110);
+
+int
+getGlyphIndex(char character)
+{
+    if (character >= 'a' && character <= 'z')
+        character = static_cast<char>(character - 'a' + 'A');
+    if (character >= '0' && character <= '9')
+        return 1 + (character - '0');
+    if (character >= 'A' && character <= 'Z')
+        return 11 + (character - 'A');
+    for (int index = 37; index < NUM_GLYPHS; index++)
+    {
+        if (GLYPHS[index].character == character)
+            return index;
+    }
+    return 0;
+}
+
+uint32_t
+getFrameTimeColor(float frameMs)
+{
+    /* 少しの揺れは許容して、予算を明確に超えたフレームだけ色を変える */
+    if (frameMs <= BUDGET_60_MS * 1.1f)
+        return GOOD_COLOR;
+    if (frameMs <= BUDGET_30_MS * 1.1f)
+        return SLOW_COLOR;
+    return JANK_COLOR;
+}
+
+/// Fixed size text line, formatted without printf so that building the overlay stays cheap
+class Line
+{
+public:
+    const char* c_str() const { return mText; }
+
+    Line& append(const char* text)
+    {
+        while (*text != '\0' && mLength < MAX_LINE_LENGTH)
+            mText[mLength++] = *text++;
+        mText[mLength] = '\0';
+        return *this;
+    }
+
+    Line& appendInt(int64_t value)
+    {
+        char digits[24];
+        int count = 0;
+        const bool negative = value < 0;
+        uint64_t magnitude = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        do
+        {
+            digits[count++] = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+        if (negative)
+            digits[count++] = '-';
+
+        char text[24];
+        for (int index = 0; index < count; index++)
+            text[index] = digits[count - 1 - index];
+        text[count] = '\0';
+        return append(text);
+    }
+
+    /// value >= 0 with the given number of decimals
+    Line& appendFixed(float value, int decimals)
+    {
+        int scale = 1;
+        for (int index = 0; index < decimals; index++)
+            scale *= 10;
+        const int64_t scaled = std::llround(std::min(std::max(value, 0.0f), 1e6f) * static_cast<float>(scale));
+        appendInt(scaled / scale);
+        if (decimals == 0)
+            return *this;
+
+        char fraction[12];
+        int64_t remainder = scaled % scale;
+        fraction[0] = '.';
+        for (int index = decimals; index >= 1; index--)
+        {
+            fraction[index] = static_cast<char>('0' + remainder % 10);
+            remainder /= 10;
+        }
+        fraction[decimals + 1] = '\0';
+        return append(fraction);
+    }
+
+    /// Pad with spaces up to column
+    Line& padTo(int column)
+    {
+        while (mLength < column && mLength < MAX_LINE_LENGTH)
+            mText[mLength++] = ' ';
+        mText[mLength] = '\0';
+        return *this;
+    }
+
+    int length() const { return mLength; }
+
+private:
+    char mText[MAX_LINE_LENGTH + 1]{};
+    int mLength{ 0 };
+};
+}
+
+
+void
+HudOverlay::buildFontAtlas(uint8_t* pixels)
+{
+    std::memset(pixels, 0, ATLAS_WIDTH * ATLAS_HEIGHT);
+    auto fillCell = [pixels](int cell, int x, int y) {
+        const int column = cell % ATLAS_COLUMNS;
+        const int row = cell / ATLAS_COLUMNS;
+        pixels[(row * CELL_HEIGHT + y) * ATLAS_WIDTH + column * CELL_WIDTH + x] = 255;
+    };
+
+    for (int glyph = 0; glyph < NUM_GLYPHS; glyph++)
+    {
+        for (int y = 0; y < 7; y++)
+        {
+            for (int x = 0; x < 5; x++)
+            {
+                if (GLYPHS[glyph].rows[y] & (0x10 >> x))
+                    fillCell(glyph, x, y);
+            }
+        }
+    }
+    for (int y = 0; y < CELL_HEIGHT; y++)
+    {
+        for (int x = 0; x < CELL_WIDTH; x++)
+            fillCell(SOLID_GLYPH, x, y);
+    }
+}
+
+
+void
+HudOverlay::addFrame(const LatencyStats::FrameTimer& timer, const FrameResult& result)
+{
+    const int64_t start = timer.getStartTime();
+    if (mLastFrameStart != 0 && start > mLastFrameStart)
+    {
+        const float frameMs = static_cast<float>(start - mLastFrameStart) * 1e-6f;
+        mFrameTimes[mNextGraphFrame] = frameMs;
+        mNextGraphFrame = (mNextGraphFrame + 1) % GRAPH_FRAMES;
+        mNumGraphFrames = std::min(mNumGraphFrames + 1, GRAPH_FRAMES);
+        mAverageFrameMs = mAverageFrameMs == 0.0f ? frameMs : mAverageFrameMs + (frameMs - mAverageFrameMs) * AVERAGE_WEIGHT;
+    }
+    mLastFrameStart = start;
+
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        const float stageMs = static_cast<float>(timer.getStageNs(STAGES[stage])) * 1e-6f;
+        mAverageStageMs[stage] += (stageMs - mAverageStageMs[stage]) * AVERAGE_WEIGHT;
+    }
+
+    mNumTracked = std::min(result.numTracked, FrameResult::MAX_TRACKED);
+    std::copy(result.trackedIds, result.trackedIds + mNumTracked, mTrackedIds);
+    mPlayingId = result.playingId;
+}
+
+
+int
+HudOverlay::build(float screenWidth, float screenHeight)
+{
+    mNumVertices = 0;
+    if (screenWidth <= 0.0f || screenHeight <= 0.0f)
+        return 0;
+
+    /* 360dp幅くらいの画面で読める大きさに、整数倍で拡大してドットをぼかさない */
+    mPixelSize = std::max(1.0f, std::floor(std::min(screenWidth, screenHeight) / 360.0f));
+    mScaleX = 2.0f / screenWidth;
+    mScaleY = 2.0f / screenHeight;
+
+    const float cellWidth = CELL_WIDTH * mPixelSize;
+    const float cellHeight = CELL_HEIGHT * mPixelSize;
+    const float padding = 4.0f * mPixelSize;
+    const float left = cellWidth;
+    const float top = 3.0f * cellHeight;
+
+    Line lines[6];
+    Line& fpsLine = lines[0];
+    fpsLine.append("FPS ").appendFixed(mAverageFrameMs > 0.0f ? 1000.0f / mAverageFrameMs : 0.0f, 1);
+    fpsLine.padTo(10).append("FRAME ").appendFixed(mAverageFrameMs, 1).append(" MS");
+
+    lines[1].append("PREP ").appendFixed(mAverageStageMs[0], 2).padTo(12).append("OBS ").appendFixed(mAverageStageMs[1], 2);
+    lines[2].append("DRAW ").appendFixed(mAverageStageMs[2], 2).padTo(12).append("FIN ").appendFixed(mAverageStageMs[3], 2);
+    lines[3].append("TRACKED ").appendInt(mNumTracked);
+
+    Line& targetLine = lines[4];
+    targetLine.append("VIDEO ");
+    if (mPlayingId == NO_TARGET_ID)
+        targetLine.append("-");
+    else
+        targetLine.appendInt(mPlayingId);
+    targetLine.append(" PAUSE");
+    int numPaused = 0;
+    for (int index = 0; index < mNumTracked; index++)
+    {
+        if (mTrackedIds[index] == mPlayingId)
+            continue;
+        targetLine.append(" ").appendInt(mTrackedIds[index]);
+        numPaused++;
+    }
+    if (numPaused == 0)
+        targetLine.append(" -");
+
+    float maxFrameMs = 0.0f;
+    for (int index = 0; index < mNumGraphFrames; index++)
+        maxFrameMs = std::max(maxFrameMs, mFrameTimes[index]);
+    lines[5].append("MAX ").appendFixed(maxFrameMs, 1).append(" MS / ").appendInt(GRAPH_FRAMES);
+
+    const int numLines = sizeof(lines) / sizeof(lines[0]);
+    int maxLength = 0;
+    for (const Line& line : lines)
+        maxLength = std::max(maxLength, line.length());
+
+    const float barWidth = 2.0f * mPixelSize;
+    const float graphWidth = GRAPH_FRAMES * barWidth;
+    const float graphHeight = 40.0f * mPixelSize;
+    const float graphTop = top + numLines * cellHeight + padding;
+    const float panelWidth = std::max(maxLength * cellWidth, graphWidth) + 2.0f * padding;
+    const float panelHeight = graphTop + graphHeight + padding - (top - padding);
+
+    /* 背景を先に積む(1回の描画で頂点順に重なる) */
+    addRect(left - padding, top - padding, panelWidth, panelHeight, PANEL_COLOR);
+
+    for (int index = 0; index < numLines; index++)
+        addText(left, top + index * cellHeight, lines[index].c_str(), index == 0 ? TEXT_COLOR : LABEL_COLOR);
+
+    /* フレーム時間のグラフ(古い順に左から)。上限を超えたフレームは上端で切る */
+    const int firstFrame = mNumGraphFrames < GRAPH_FRAMES ? 0 : mNextGraphFrame;
+    const float graphLeft = left + graphWidth - mNumGraphFrames * barWidth;
+    for (int index = 0; index < mNumGraphFrames; index++)
+    {
+        const float frameMs = mFrameTimes[(firstFrame + index) % GRAPH_FRAMES];
+        const float height = std::max(mPixelSize, std::min(frameMs, GRAPH_MAX_MS) / GRAPH_MAX_MS * graphHeight);
+        addRect(graphLeft + index * barWidth, graphTop + graphHeight - height, barWidth - mPixelSize * 0.5f, height,
+                getFrameTimeColor(frameMs));
+    }
+    for (float budgetMs : { BUDGET_60_MS, BUDGET_30_MS })
+    {
+        const float y = graphTop + graphHeight - budgetMs / GRAPH_MAX_MS * graphHeight;
+        addRect(left, y, graphWidth, mPixelSize, BUDGET_COLOR);
+    }
+
+    return mNumVertices;
+}
+
+
+void
+HudOverlay::addQuad(float left, float top, float width, float height, float u0, float v0, float u1, float v1, uint32_t color)
+{
+    if (mNumVertices + VERTICES_PER_QUAD > MAX_VERTICES)
+        return;
+
+    const float x0 = left * mScaleX - 1.0f;
+    const float x1 = (left + width) * mScaleX - 1.0f;
+    const float y0 = 1.0f - top * mScaleY;
+    const float y1 = 1.0f - (top + height) * mScaleY;
+    Vertex* vertex = mVertices + mNumVertices;
+    vertex[0] = { x0, y0, u0, v0, color };
+    vertex[1] = { x0, y1, u0, v1, color };
+    vertex[2] = { x1, y0, u1, v0, color };
+    vertex[3] = { x1, y0, u1, v0, color };
+    vertex[4] = { x0, y1, u0, v1, color };
+    vertex[5] = { x1, y1, u1, v1, color };
+    mNumVertices += VERTICES_PER_QUAD;
+}
+
+
+float
+HudOverlay::addText(float left, float top, const char* text, uint32_t color)
+{
+    const float cellWidth = CELL_WIDTH * mPixelSize;
+    const float cellHeight = CELL_HEIGHT * mPixelSize;
+    for (; *text != '\0'; text++, left += cellWidth)
+    {
+        const int glyph = getGlyphIndex(*text);
+        if (glyph == 0)
+            continue;
+
+        const float u0 = static_cast<float>((glyph % ATLAS_COLUMNS) * CELL_WIDTH) / ATLAS_WIDTH;
+        const float v0 = static_cast<float>((glyph / ATLAS_COLUMNS) * CELL_HEIGHT) / ATLAS_HEIGHT;
+        addQuad(left, top, cellWidth, cellHeight, u0, v0, u0 + static_cast<float>(CELL_WIDTH) / ATLAS_WIDTH,
+                v0 + static_cast<float>(CELL_HEIGHT) / ATLAS_HEIGHT, color);
+    }
+    return left;
+}
+
+
+void
+HudOverlay::addRect(float left, float top, float width, float height, uint32_t color)
+{
+    /* 塗りつぶしセルの中央だけをサンプルする */
+    const float u = (static_cast<float>((SOLID_GLYPH % ATLAS_COLUMNS) * CELL_WIDTH) + CELL_WIDTH * 0.5f) / ATLAS_WIDTH;
+    const float v = (static_cast<float>((SOLID_GLYPH / ATLAS_COLUMNS) * CELL_HEIGHT) + CELL_HEIGHT * 0.5f) / ATLAS_HEIGHT;
+    addQuad(left, top, width, height, u, v, u, v, color);
+}
@@ -0,0 +1,93 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __HUDOVERLAY_H__
+#define __HUDOVERLAY_H__
+
+#include "FrameResult.h"
+#include "LatencyStats.h"
+
+#include <cstdint>
+
+/// Performance overlay: FPS, frame time graph, stage timings and the tracked targets
+/**
+ * The render thread feeds every rendered frame to addFrame() and, while the overlay is shown, calls
+ * build() to lay it out as textured quads in NDC. All quads sample one small atlas (buildFontAtlas:
+ * an embedded 5x7 bitmap font plus a solid cell for the panel and the graph bars), so the renderer
+ * draws the whole overlay with one draw call. Vertices go to a fixed array, nothing is allocated.
+ */
+class HudOverlay
+{
+public:
+    /// Atlas cell of a glyph (5x7 pixels, the last column and row stay empty as spacing)
+    static constexpr int CELL_WIDTH = 6;
+    static constexpr int CELL_HEIGHT = 8;
+    static constexpr int ATLAS_COLUMNS = 16;
+    static constexpr int ATLAS_ROWS = 4;
+    /// One byte (coverage 0 or 255) per pixel, rows top to bottom
+    static constexpr int ATLAS_WIDTH = ATLAS_COLUMNS * CELL_WIDTH;
+    static constexpr int ATLAS_HEIGHT = ATLAS_ROWS * CELL_HEIGHT;
+
+    /// Frames shown in the frame time graph
+    static constexpr int GRAPH_FRAMES = 120;
+    /// Frame time at the top of the graph
+    static constexpr float GRAPH_MAX_MS = 50.0f;
+    static constexpr int MAX_QUADS = 512;
+    static constexpr int VERTICES_PER_QUAD = 6;
+    static constexpr int MAX_VERTICES = MAX_QUADS * VERTICES_PER_QUAD;
+
+    /// Interleaved vertex of the overlay (GL_TRIANGLES), color is RGBA8 in memory order
+    struct Vertex
+    {
+        float x;
+        float y;
+        float u;
+        float v;
+        uint32_t color;
+    };
+
+    /// Fill pixels (ATLAS_WIDTH * ATLAS_HEIGHT bytes) with the font atlas
+    static void buildFontAtlas(uint8_t* pixels);
+
+    /// Render thread: add a frame drawn from a camera frame, timer marked up to FINISH
+    void addFrame(const LatencyStats::FrameTimer& timer, const FrameResult& result);
+
+    /// Lay the overlay out for a screen of the given size in pixels, returns the number of vertices
+    int build(float screenWidth, float screenHeight);
+
+    const Vertex* getVertices() const { return mVertices; }
+
+private:
+    /// Append a quad in pixels (origin top left) with the atlas coordinates of its corners
+    void addQuad(float left, float top, float width, float height, float u0, float v0, float u1, float v1, uint32_t color);
+
+    /// Append text at the pixel position, returns the x after the last character
+    float addText(float left, float top, const char* text, uint32_t color);
+
+    /// Append a filled rectangle (solid atlas cell)
+    void addRect(float left, float top, float width, float height, uint32_t color);
+
+    Vertex mVertices[MAX_VERTICES];
+    int mNumVertices{ 0 };
+    /// Scale from pixels to NDC of the current build()
+    float mScaleX{ 0.0f };
+    float mScaleY{ 0.0f };
+    float mPixelSize{ 1.0f };
+
+    /// Frame intervals (ms), mNextGraphFrame is the oldest once the ring is full
+    float mFrameTimes[GRAPH_FRAMES]{};
+    int mNextGraphFrame{ 0 };
+    int mNumGraphFrames{ 0 };
+    int64_t mLastFrameStart{ 0 };
+
+    /* 数字がちらつかないよう指数移動平均で表示する (ms) */
+    float mAverageFrameMs{ 0.0f };
+    float mAverageStageMs[4]{};
+
+    int32_t mNumTracked{ 0 };
+    int32_t mTrackedIds[FrameResult::MAX_TRACKED]{};
+    int32_t mPlayingId{ NO_TARGET_ID };
+};
+
+#endif // __HUDOVERLAY_H__
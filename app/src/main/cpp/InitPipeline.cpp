@@ -0,0 +1,184 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "InitPipeline.h"
+#include "ObjModel.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+InitPipeline::InitPipeline(StartupTimeline& timeline, JobSystem& jobs)
+    : mTimeline(timeline), mJobs(jobs)
+{
+}
+
+
+InitPipeline::~InitPipeline()
+{
+    /* ジョブがメンバーに書き込み終わるまで待つ */
+    if (!isStarted())
+        return;
+    wait(mModelTask);
+    for (const JobSystem::JobFuture<bool>& task : mImageTasks)
+        wait(task);
+    wait(mManifestTask);
+}
+
+
+void
+InitPipeline::start(const Platform& platform)
+{
+    /* onCreateとinitAR(別スレッド)のどちらから先に呼ばれてもよいように */
+    std::lock_guard<std::mutex> lock(mStartMutex);
+    if (isStarted())
+        return;
+
+    StartupTimeline::Scope phase(mTimeline, "InitPipeline::start");
+    mPlatform = platform;
+
+    /* 読み込みと解析を別のジョブにして、あるファイルの解析中に次のファイルを読めるようにする */
+    const auto readModel = mJobs.submitWithResult("InitPipeline read", [this] { return openAsset(MODEL_PATH, mModelData); });
+    mModelTask = mJobs.submitWithResult(
+        "InitPipeline parse model", [this, readModel] { return readModel.get() && parseModel(); }, { readModel.getHandle() });
+
+    if (mPlatform.decodeImage)
+    {
+        const char* const imagePaths[IMAGE_COUNT] = { ASTRONAUT_TEXTURE_PATH, PAUSE_TEXTURE_PATH };
+        for (int idx = 0; idx < IMAGE_COUNT; idx++)
+        {
+            const char* path = imagePaths[idx];
+            const auto readImage = mJobs.submitWithResult("InitPipeline read", [this, idx, path] { return openAsset(path, mImageData[idx]); });
+            mImageTasks[idx] = mJobs.submitWithResult(
+                "InitPipeline decode", [this, idx, path, readImage] { return readImage.get() && decodeImage(static_cast<ImageId>(idx), path); },
+                { readImage.getHandle() });
+        }
+    }
+
+    const auto readManifest = mJobs.submitWithResult("InitPipeline read", [this] { return openAsset(MANIFEST_PATH, mManifestData); });
+    mManifestTask = mJobs.submitWithResult(
+        "InitPipeline parse manifest", [this, readManifest] { return readManifest.get() && parseManifestData(); }, { readManifest.getHandle() });
+    mStarted.store(true, std::memory_order_release);
+}
+
+
+bool
+InitPipeline::isReady() const
+{
+    if (!isStarted())
+        return false;
+
+    if (!mModelTask.isDone() || !mManifestTask.isDone())
+        return false;
+    for (const JobSystem::JobFuture<bool>& task : mImageTasks)
+    {
+        if (!task.isDone())
+            return false;
+    }
+    return true;
+}
+
+
+const InitPipeline::Model*
+InitPipeline::getModel()
+{
+    return isStarted() && wait(mModelTask) ? &mModel : nullptr;
+}
+
+
+const InitPipeline::Image*
+InitPipeline::getImage(ImageId id)
+{
+    return isStarted() && wait(mImageTasks[static_cast<int>(id)]) ? &mImages[static_cast<int>(id)] : nullptr;
+}
+
+
+const std::vector<std::string>*
+InitPipeline::getManifestTargetNames()
+{
+    return isStarted() && wait(mManifestTask) ? &mManifestTargetNames : nullptr;
+}
+
+
+bool
+InitPipeline::parseManifest(const char* data, size_t size, std::vector<std::string>& targetNames)
+{
+    /* データセットのXMLは <ImageTarget name="..." size="..." /> の並びだけなので、XMLパーサーは使わない */
+    static constexpr char TAG[] = "<ImageTarget";
+    static constexpr char NAME[] = "name=\"";
+    const char* end = data + size;
+    const char* cursor = data;
+    targetNames.clear();
+    while ((cursor = std::search(cursor, end, TAG, TAG + sizeof(TAG) - 1)) != end)
+    {
+        cursor += sizeof(TAG) - 1;
+        const char* tagEnd = std::find(cursor, end, '>');
+        const char* name = std::search(cursor, tagEnd, NAME, NAME + sizeof(NAME) - 1);
+        if (name == tagEnd)
+            continue;
+        name += sizeof(NAME) - 1;
+        const char* nameEnd = std::find(name, tagEnd, '"');
+        if (nameEnd == tagEnd)
+            return false;
+        targetNames.emplace_back(name, nameEnd);
+        cursor = tagEnd;
+    }
+    return !targetNames.empty();
+}
+
+
+bool
+InitPipeline::openAsset(const char* path, AssetBuffer& data)
+{
+    char phaseName[StartupTimeline::NAME_LENGTH];
+    snprintf(phaseName, sizeof(phaseName), "read %s", path);
+    StartupTimeline::Scope phase(mTimeline, phaseName);
+    if (!mPlatform.assets)
+        return false;
+    data = mPlatform.assets->open(path);
+    return data.isValid();
+}
+
+
+bool
+InitPipeline::parseModel()
+{
+    StartupTimeline::Scope phase(mTimeline, "parse Astronaut.obj");
+    const bool result = loadObjModel(mModelData.data(), mModelData.size(), mModel.numVertices, mModel.vertices, mModel.texCoords);
+    mModelData = AssetBuffer();
+    return result;
+}
+
+
+bool
+InitPipeline::decodeImage(ImageId id, const char* path)
+{
+    const int idx = static_cast<int>(id);
+    char phaseName[StartupTimeline::NAME_LENGTH];
+    snprintf(phaseName, sizeof(phaseName), "decode %s", path);
+    StartupTimeline::Scope phase(mTimeline, phaseName);
+    const bool result = mPlatform.decodeImage(mImageData[idx], mImages[idx]);
+    mImageData[idx] = AssetBuffer();
+    return result;
+}
+
+
+bool
+InitPipeline::parseManifestData()
+{
+    StartupTimeline::Scope phase(mTimeline, "parse manifest");
+    const bool result = parseManifest(mManifestData.data(), mManifestData.size(), mManifestTargetNames);
+    mManifestData = AssetBuffer();
+    return result;
+}
+
+
+bool
+InitPipeline::wait(const JobSystem::JobFuture<bool>& task)
+{
+    if (!task.isValid())
+        return false;
+    mJobs.wait(task.getHandle());
+    return task.get();
+}
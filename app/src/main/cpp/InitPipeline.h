@@ -0,0 +1,135 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __INITPIPELINE_H__
+#define __INITPIPELINE_H__
+
+#include "AssetSource.h"
+#include "JobSystem.h"
+#include "StartupTimeline.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Startup CPU work run on the JobSystem while the engine is created
+/**
+ * start() submits a read job and a dependent parse job for each asset: the Astronaut model, the two
+ * textures (decode) and the target manifest (the ImageTarget names of the dataset XML). The reads and
+ * the parses of different assets overlap on the workers, and each job records its phase in the
+ * StartupTimeline. The GL thread only uploads the results:
+ * it polls isReady() without blocking and calls the get* methods, which wait for their jobs, once the
+ * upload cannot be deferred any longer.
+ *
+ * File access and image decoding are platform code and are passed in as a Platform. The read jobs
+ * only open the assets: the parse jobs work on the mapped bytes (AssetBuffer) without copying them,
+ * and the mapping is released as soon as the parse job is done with it.
+ */
+class InitPipeline
+{
+public:
+    struct Model
+    {
+        int numVertices{ 0 };
+        std::vector<float> vertices;
+        std::vector<float> texCoords;
+    };
+
+    /// Decoded image, 4 bytes (RGBA) per pixel, rows top to bottom without padding
+    struct Image
+    {
+        int width{ 0 };
+        int height{ 0 };
+        std::vector<unsigned char> pixels;
+    };
+
+    enum class ImageId : uint8_t
+    {
+        ASTRONAUT,
+        PAUSE,
+        COUNT
+    };
+
+    struct Platform
+    {
+        /// Opens the assets, from the workers
+        std::shared_ptr<AssetSource> assets;
+        /// Decode an encoded image (PNG, JPEG) to RGBA, nullptr to skip the textures
+        std::function<bool(const AssetBuffer& encoded, Image& image)> decodeImage;
+    };
+
+    static constexpr const char* MODEL_PATH = "ImageTargets/Astronaut.obj";
+    static constexpr const char* ASTRONAUT_TEXTURE_PATH = "ImageTargets/Astronaut.jpg";
+    static constexpr const char* PAUSE_TEXTURE_PATH = "pause.png";
+    static constexpr const char* MANIFEST_PATH = "ai_001.xml";
+
+    InitPipeline(StartupTimeline& timeline, JobSystem& jobs);
+    /// Waits for the submitted jobs
+    ~InitPipeline();
+
+    InitPipeline(const InitPipeline&) = delete;
+    InitPipeline& operator=(const InitPipeline&) = delete;
+
+    /// Submit the jobs, ignored if they were already started (from any thread)
+    void start(const Platform& platform);
+
+    bool isStarted() const { return mStarted.load(std::memory_order_acquire); }
+
+    /// True once every job has finished, never blocks
+    bool isReady() const;
+
+    /// Wait for the model jobs, nullptr if it failed or start() was not called
+    const Model* getModel();
+
+    /// Wait for the decode job of id, nullptr if it failed, was skipped or start() was not called
+    /**
+     * The pixels are kept, the GL thread uploads them again when its context is recreated.
+     */
+    const Image* getImage(ImageId id);
+
+    /// Wait for the manifest jobs, nullptr if it failed or start() was not called
+    const std::vector<std::string>* getManifestTargetNames();
+
+    /// The ImageTarget names of a dataset XML, in file order
+    static bool parseManifest(const char* data, size_t size, std::vector<std::string>& targetNames);
+
+private:
+    static constexpr int IMAGE_COUNT = static_cast<int>(ImageId::COUNT);
+
+    /// Open (map) an asset into data, recorded as phase "read <path>"
+    bool openAsset(const char* path, AssetBuffer& data);
+    bool parseModel();
+    bool decodeImage(ImageId id, const char* path);
+    bool parseManifestData();
+
+    /// Wait for a job, false if it failed or was never submitted
+    bool wait(const JobSystem::JobFuture<bool>& task);
+
+    StartupTimeline& mTimeline;
+    JobSystem& mJobs;
+    Platform mPlatform;
+    std::mutex mStartMutex;
+    /// Set after the jobs are submitted, the futures are only read once it is seen set
+    std::atomic<bool> mStarted{ false };
+
+    /* 最後のジョブ(解析・デコード)。GLスレッドとKotlinのI/Oスレッドから待たれる */
+    JobSystem::JobFuture<bool> mModelTask;
+    JobSystem::JobFuture<bool> mImageTasks[IMAGE_COUNT];
+    JobSystem::JobFuture<bool> mManifestTask;
+
+    /* 読み込みジョブが開いたアセット(コピーしない)。後続のジョブが使い終わったら解放する */
+    AssetBuffer mModelData;
+    AssetBuffer mImageData[IMAGE_COUNT];
+    AssetBuffer mManifestData;
+
+    /* ジョブの結果(各ジョブだけが書き、wait()の後は読むだけ) */
+    Model mModel;
+    Image mImages[IMAGE_COUNT];
+    std::vector<std::string> mManifestTargetNames;
+};
+
+#endif // __INITPIPELINE_H__
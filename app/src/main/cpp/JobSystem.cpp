@@ -0,0 +1,299 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "JobSystem.h"
+#include "ThreadRoles.h"
+#include "Tracer.h"
+
+#include <algorithm>
+
+
+class JobSystem::Job
+{
+public:
+    const char* name{ nullptr };
+    std::function<void()> work;
+    /// Dependencies not done yet, plus one held by submit() until all are registered
+    std::atomic<int> pendingDependencies{ 1 };
+    std::atomic<bool> done{ false };
+    /// Guards continuations against done being set
+    std::mutex mutex;
+    /// Jobs that depend on this one and were submitted before it was done
+    std::vector<std::shared_ptr<Job>> continuations;
+};
+
+
+namespace
+{
+/* ワーカーのスレッドだけが設定する(どのプールの何番目か) */
+thread_local const JobSystem* tJobSystem = nullptr;
+thread_local int tWorkerIndex = -1;
+}
+
+
+bool
+JobSystem::JobHandle::isDone() const
+{
+    return mJob == nullptr || mJob->done.load(std::memory_order_acquire);
+}
+
+
+JobSystem::JobSystem(int numWorkers)
+{
+    if (numWorkers <= 0)
+        numWorkers = getDefaultWorkerCount();
+    mNumWorkers = std::min(numWorkers, MAX_WORKERS);
+
+    mQueues.reset(new WorkerQueue[mNumWorkers]);
+    mWorkers.reserve(mNumWorkers);
+    for (int index = 0; index < mNumWorkers; index++)
+        mWorkers.emplace_back(&JobSystem::workerMain, this, index);
+}
+
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mSleepMutex);
+        mStopping = true;
+    }
+    mSleepCondition.notify_all();
+    for (std::thread& worker : mWorkers)
+        worker.join();
+}
+
+
+JobSystem::JobHandle
+JobSystem::submit(const char* name, std::function<void()> work, const std::vector<JobHandle>& dependencies)
+{
+    auto job = std::make_shared<Job>();
+    job->name = name;
+    job->work = std::move(work);
+
+    /* 終わっていない依存先にだけ後続として登録する。登録中に終わった依存先はexecute()が数を減らす */
+    for (const JobHandle& dependency : dependencies)
+    {
+        if (dependency.mJob == nullptr)
+            continue;
+        std::lock_guard<std::mutex> lock(dependency.mJob->mutex);
+        if (dependency.mJob->done.load(std::memory_order_relaxed))
+            continue;
+        job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+        dependency.mJob->continuations.push_back(job);
+    }
+
+    JobHandle handle(job);
+    if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        enqueue(std::move(job));
+    return handle;
+}
+
+
+void
+JobSystem::wait(const JobHandle& job)
+{
+    if (job.isDone())
+        return;
+
+    const int index = getCurrentWorkerIndex();
+    if (index >= 0)
+    {
+        /* ワーカー上で眠るとプールが詰まりうるので、待つ間は他のジョブを進める */
+        while (!job.isDone())
+        {
+            if (std::shared_ptr<Job> other = takeJob(index))
+                execute(other);
+            else
+                std::this_thread::yield();
+        }
+        return;
+    }
+
+    mWaiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(mDoneMutex);
+        mDoneCondition.wait(lock, [&job] { return job.isDone(); });
+    }
+    mWaiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+void
+JobSystem::parallelFor(const char* name, int count, int grainSize, const std::function<void(int begin, int end)>& body)
+{
+    if (count <= 0)
+        return;
+    grainSize = std::max(grainSize, 1);
+    const int numChunks = (count + grainSize - 1) / grainSize;
+
+    /* チャンクは取り合いにする。遅れて始まったヘルパーは何もせずに終わる */
+    std::atomic<int> nextChunk{ 0 };
+    auto runChunks = [&] {
+        int chunk;
+        while ((chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < numChunks)
+        {
+            const int begin = chunk * grainSize;
+            body(begin, std::min(begin + grainSize, count));
+        }
+    };
+
+    const int numHelpers = std::min(numChunks - 1, getWorkerCount());
+    std::vector<JobHandle> helpers;
+    helpers.reserve(numHelpers);
+    for (int helper = 0; helper < numHelpers; helper++)
+        helpers.push_back(submit(name, runChunks));
+    runChunks();
+    for (const JobHandle& helper : helpers)
+        wait(helper);
+}
+
+
+JobSystem::Stats
+JobSystem::getStats() const
+{
+    Stats stats;
+    stats.executed = mExecuted.load(std::memory_order_relaxed);
+    stats.stolen = mStolen.load(std::memory_order_relaxed);
+    return stats;
+}
+
+
+int
+JobSystem::getDefaultWorkerCount(const CpuTopology& topology)
+{
+    /* 大コア2つは描画スレッドと姿勢計算スレッドに残し、残りのコアに1ワーカーずつ */
+    const int spareBigCpus = std::max(topology.numBigCpus - 2, 0);
+    return std::clamp(topology.numLittleCpus + spareBigCpus, 1, MAX_WORKERS);
+}
+
+
+void
+JobSystem::workerMain(int index)
+{
+    tJobSystem = this;
+    tWorkerIndex = index;
+    VPB_TRACE_THREAD_NAME("JobWorker");
+    ThreadRoles::assign(ThreadRole::WORKER);
+
+    while (true)
+    {
+        if (std::shared_ptr<Job> job = takeJob(index))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mSleepMutex);
+        mSleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        mSleepCondition.wait(lock, [this] { return mStopping || mQueuedJobs.load(std::memory_order_seq_cst) > 0; });
+        mSleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        /* 停止時も積まれたジョブは最後まで実行する */
+        if (mStopping && mQueuedJobs.load(std::memory_order_seq_cst) == 0)
+            return;
+    }
+}
+
+
+void
+JobSystem::enqueue(std::shared_ptr<Job> job)
+{
+    const int index = getCurrentWorkerIndex();
+    WorkerQueue& queue = mQueues[index >= 0 ? index : mNextQueue.fetch_add(1, std::memory_order_relaxed) % mNumWorkers];
+    mQueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    /* 眠っているワーカーがいるときだけ起こす(mQueuedJobsとmSleepingWorkersの順序で取りこぼさない) */
+    if (mSleepingWorkers.load(std::memory_order_seq_cst) > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+        }
+        mSleepCondition.notify_one();
+    }
+}
+
+
+std::shared_ptr<JobSystem::Job>
+JobSystem::takeJob(int index)
+{
+    const int numQueues = getWorkerCount();
+    if (index >= 0)
+    {
+        WorkerQueue& own = mQueues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            std::shared_ptr<Job> job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            mQueuedJobs.fetch_sub(1, std::memory_order_seq_cst);
+            return job;
+        }
+    }
+
+    const int first = index >= 0 ? index + 1 : 0;
+    for (int offset = 0; offset < numQueues; offset++)
+    {
+        const int victim = (first + offset) % numQueues;
+        if (victim == index)
+            continue;
+        WorkerQueue& queue = mQueues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+        std::shared_ptr<Job> job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        mQueuedJobs.fetch_sub(1, std::memory_order_seq_cst);
+        mStolen.fetch_add(1, std::memory_order_relaxed);
+        return job;
+    }
+    return nullptr;
+}
+
+
+void
+JobSystem::execute(const std::shared_ptr<Job>& job)
+{
+    {
+#if defined(VPB_ENABLE_TRACING)
+        TraceScope scope(job->name);
+#endif
+        job->work();
+        /* キャプチャした資源はここで手放す(ハンドルがジョブを長く持っていてもよいように) */
+        job->work = nullptr;
+    }
+    mExecuted.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<std::shared_ptr<Job>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->done.store(true, std::memory_order_release);
+        continuations.swap(job->continuations);
+    }
+    /* doneの書き込みとmWaitersの読み出しの順序をwait()側のフェンスと対にする */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (std::shared_ptr<Job>& continuation : continuations)
+    {
+        if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            enqueue(std::move(continuation));
+    }
+
+    if (mWaiters.load(std::memory_order_seq_cst) > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mDoneMutex);
+        }
+        mDoneCondition.notify_all();
+    }
+}
+
+
+int
+JobSystem::getCurrentWorkerIndex() const
+{
+    return tJobSystem == this ? tWorkerIndex : -1;
+}
@@ -0,0 +1,168 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __JOBSYSTEM_H__
+#define __JOBSYSTEM_H__
+
+#include "CpuTopology.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Work-stealing thread pool for the native background work (asset reads, parsing, decoding, file output)
+/**
+ * Every worker owns a deque: it pops its own jobs from the back (the most recently pushed, still in
+ * cache) and, when it runs dry, steals the oldest job from the front of another worker. Jobs submitted
+ * from outside the pool are spread round-robin over the workers. Idle workers sleep on a condition
+ * variable, so the pool costs nothing while there is no work. Workers run as ThreadRole::WORKER.
+ *
+ * A job may depend on other jobs and is only queued once they are all done, which builds pipelines
+ * such as read -> parse without blocking a worker. submit() returns a JobHandle (submitWithResult() a
+ * JobFuture) that the GL thread polls with isDone() without blocking; wait() blocks, or runs other
+ * jobs when called from a worker so that nested waits cannot deadlock the pool.
+ *
+ * Jobs are for work of tens of microseconds and more: a job is one allocation and a few locks.
+ */
+class JobSystem
+{
+public:
+    static constexpr int MAX_WORKERS = 8;
+
+    class Job;
+
+    /// Completion of a submitted job, an empty handle counts as done
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+
+        bool isValid() const { return mJob != nullptr; }
+
+        /// Never blocks
+        bool isDone() const;
+
+    private:
+        friend class JobSystem;
+        explicit JobHandle(std::shared_ptr<Job> job) : mJob(std::move(job)) {}
+
+        std::shared_ptr<Job> mJob;
+    };
+
+    /// JobHandle of a job returning a T
+    template<typename T>
+    class JobFuture
+    {
+    public:
+        JobFuture() = default;
+
+        const JobHandle& getHandle() const { return mHandle; }
+        bool isValid() const { return mHandle.isValid(); }
+        bool isDone() const { return mHandle.isDone(); }
+
+        /// The result, only once isDone() or after JobSystem::wait()
+        const T& get() const { return *mResult; }
+
+    private:
+        friend class JobSystem;
+
+        JobHandle mHandle;
+        std::shared_ptr<T> mResult;
+    };
+
+    /// Counters since the pool was created
+    struct Stats
+    {
+        uint64_t executed{ 0 };
+        /// Jobs a worker took from the deque of another worker
+        uint64_t stolen{ 0 };
+    };
+
+    /// numWorkers <= 0 for getDefaultWorkerCount()
+    explicit JobSystem(int numWorkers = 0);
+    /// Runs the jobs still queued, then joins the workers
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// Queue work once all dependencies are done, name (a string literal) labels the trace event
+    JobHandle submit(const char* name, std::function<void()> work, const std::vector<JobHandle>& dependencies = {});
+
+    /// submit() for work returning a value
+    template<typename Func>
+    auto submitWithResult(const char* name, Func&& work, const std::vector<JobHandle>& dependencies = {})
+    {
+        using Result = decltype(work());
+        JobFuture<Result> future;
+        future.mResult = std::make_shared<Result>();
+        future.mHandle = submit(
+            name, [result = future.mResult, work = std::forward<Func>(work)]() mutable { *result = work(); }, dependencies);
+        return future;
+    }
+
+    /// Block until job is done, running other jobs meanwhile when called from a worker
+    void wait(const JobHandle& job);
+
+    /// Run body(begin, end) over [0, count) in chunks of grainSize on the workers and the calling thread, returns when all are done
+    void parallelFor(const char* name, int count, int grainSize, const std::function<void(int begin, int end)>& body);
+
+    int getWorkerCount() const { return mNumWorkers; }
+
+    Stats getStats() const;
+
+    /// One worker per little core and per big core beyond the two kept for the render and tracking threads, 1 to MAX_WORKERS
+    static int getDefaultWorkerCount(const CpuTopology& topology = CpuTopology::get());
+
+private:
+    /* 所有者は後ろから、盗む側は前から取る。ロック1つで足りる程度のジョブ粒度を想定 */
+    struct alignas(64) WorkerQueue
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Job>> jobs;
+    };
+
+    void workerMain(int index);
+
+    /// Put a job whose dependencies are done on a queue and wake a worker
+    void enqueue(std::shared_ptr<Job> job);
+
+    /// A job of the own queue (index < 0: none) or one stolen from another worker, nullptr if all are empty
+    std::shared_ptr<Job> takeJob(int index);
+
+    /// Run the job, then queue the jobs that were only waiting for it
+    void execute(const std::shared_ptr<Job>& job);
+
+    /// Index of the calling thread if it is a worker of this pool, -1 otherwise
+    int getCurrentWorkerIndex() const;
+
+    /// Set before the workers start, mWorkers grows while the first ones already run
+    int mNumWorkers{ 0 };
+    std::vector<std::thread> mWorkers;
+    std::unique_ptr<WorkerQueue[]> mQueues;
+    std::atomic<uint32_t> mNextQueue{ 0 };
+
+    /// Jobs in the queues (counted before they are pushed, so it is never below the real count)
+    std::atomic<int> mQueuedJobs{ 0 };
+    std::atomic<int> mSleepingWorkers{ 0 };
+    std::mutex mSleepMutex;
+    std::condition_variable mSleepCondition;
+    bool mStopping{ false };
+
+    /* 外部スレッドのwait()用 */
+    std::atomic<int> mWaiters{ 0 };
+    std::mutex mDoneMutex;
+    std::condition_variable mDoneCondition;
+
+    std::atomic<uint64_t> mExecuted{ 0 };
+    std::atomic<uint64_t> mStolen{ 0 };
+};
+
+#endif // __JOBSYSTEM_H__
@@ -0,0 +1,209 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "LatencyStats.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+
+namespace
+{
+float
+toMicroseconds(int64_t ns)
+{
+    return static_cast<float>(ns) * 1e-3f;
+}
+
+/// Percentiles of count sorted samples
+LatencyStats::Percentiles
+getSortedPercentiles(const int64_t* samples, int count)
+{
+    LatencyStats::Percentiles percentiles;
+    percentiles.count = count;
+    if (count == 0)
+        return percentiles;
+
+    auto at = [samples, count](double p) { return toMicroseconds(samples[std::min(count - 1, static_cast<int>(p * count))]); };
+    percentiles.p50 = at(0.50);
+    percentiles.p95 = at(0.95);
+    percentiles.p99 = at(0.99);
+    percentiles.max = toMicroseconds(samples[count - 1]);
+    return percentiles;
+}
+}
+
+
+LatencyStats::FrameTimer::FrameTimer()
+    : mStart(LatencyStats::now()), mLast(mStart)
+{
+}
+
+
+void
+LatencyStats::FrameTimer::mark(Stage stage)
+{
+    const int64_t time = LatencyStats::now();
+    mStageNs[static_cast<int>(stage)] += time - mLast;
+    mLast = time;
+    if (stage == Stage::PREPARE)
+        mPrepared = time;
+}
+
+
+void
+LatencyStats::record(const FrameTimer& timer, int64_t cameraTimestampNs, int64_t acquireTimeNs)
+{
+    int64_t stageNs[STAGE_COUNT];
+    std::copy(timer.mStageNs, timer.mStageNs + STAGE_COUNT, stageNs);
+    stageNs[static_cast<int>(Stage::FRAME)] = timer.mLast - timer.mStart;
+
+    /* カメラの時刻が別の時計らしい場合は、状態を取得した時刻から測って件数を数える */
+    int64_t captureTime = cameraTimestampNs;
+    const int64_t cameraAge = timer.mPrepared - cameraTimestampNs;
+    const bool acquireTimeFallback = !(cameraTimestampNs > 0 && cameraAge >= 0 && cameraAge <= MAX_CAMERA_AGE_NS);
+    if (acquireTimeFallback)
+        captureTime = acquireTimeNs;
+    const bool hasCameraAge = captureTime > 0 && timer.mPrepared >= captureTime;
+    stageNs[static_cast<int>(Stage::CAMERA_AGE)] = timer.mPrepared - captureTime;
+    stageNs[static_cast<int>(Stage::TOTAL)] = timer.mLast - captureTime;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        if (!hasCameraAge && (stage == static_cast<int>(Stage::CAMERA_AGE) || stage == static_cast<int>(Stage::TOTAL)))
+            continue;
+        mSamples[stage][mNext[stage]] = stageNs[stage];
+        mNext[stage] = (mNext[stage] + 1) % WINDOW_SIZE;
+        mCount[stage] = std::min(mCount[stage] + 1, WINDOW_SIZE);
+    }
+    mFrameCount++;
+    if (acquireTimeFallback)
+        mAcquireTimeFrameCount++;
+}
+
+
+LatencyStats::Percentiles
+LatencyStats::getPercentiles(Stage stage) const
+{
+    int64_t samples[WINDOW_SIZE];
+    int count;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        count = copySamples(stage, samples);
+    }
+    std::sort(samples, samples + count);
+    return getSortedPercentiles(samples, count);
+}
+
+
+uint64_t
+LatencyStats::getFrameCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFrameCount;
+}
+
+
+uint64_t
+LatencyStats::getAcquireTimeFrameCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mAcquireTimeFrameCount;
+}
+
+
+bool
+LatencyStats::dumpToFile(const char* path) const
+{
+    /* 描画スレッドを待たせないよう、ロック中はコピーだけ */
+    int64_t samples[STAGE_COUNT][WINDOW_SIZE];
+    int counts[STAGE_COUNT];
+    uint64_t frameCount;
+    uint64_t acquireTimeFrameCount;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (int stage = 0; stage < STAGE_COUNT; stage++)
+            counts[stage] = copySamples(static_cast<Stage>(stage), samples[stage]);
+        frameCount = mFrameCount;
+        acquireTimeFrameCount = mAcquireTimeFrameCount;
+    }
+
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    fprintf(file, "# frames %llu, window %d, camera_age/total from the acquire in %llu frames\n", static_cast<unsigned long long>(frameCount),
+            WINDOW_SIZE, static_cast<unsigned long long>(acquireTimeFrameCount));
+    fprintf(file, "# stage count p50_us p95_us p99_us max_us\n");
+    int64_t sorted[WINDOW_SIZE];
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        std::copy(samples[stage], samples[stage] + counts[stage], sorted);
+        std::sort(sorted, sorted + counts[stage]);
+        const Percentiles percentiles = getSortedPercentiles(sorted, counts[stage]);
+        fprintf(file, "%s %d %.1f %.1f %.1f %.1f\n", getStageName(static_cast<Stage>(stage)), percentiles.count,
+                percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+    }
+
+    /* 生のサンプル(古い順, us) */
+    for (int stage = 0; stage < STAGE_COUNT; stage++)
+    {
+        fprintf(file, "samples %s", getStageName(static_cast<Stage>(stage)));
+        for (int idx = 0; idx < counts[stage]; idx++)
+            fprintf(file, " %.1f", toMicroseconds(samples[stage][idx]));
+        fprintf(file, "\n");
+    }
+
+    const bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
+
+
+void
+LatencyStats::reset()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::fill(mNext, mNext + STAGE_COUNT, 0);
+    std::fill(mCount, mCount + STAGE_COUNT, 0);
+    mFrameCount = 0;
+    mAcquireTimeFrameCount = 0;
+}
+
+
+const char*
+LatencyStats::getStageName(Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::PREPARE:      return "prepare";
+        case Stage::OBSERVATIONS: return "observations";
+        case Stage::DRAW:         return "draw";
+        case Stage::FINISH:       return "finish";
+        case Stage::FRAME:        return "frame";
+        case Stage::CAMERA_AGE:   return "camera_age";
+        case Stage::TOTAL:        return "total";
+        default:                  return "unknown";
+    }
+}
+
+
+int64_t
+LatencyStats::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+int
+LatencyStats::copySamples(Stage stage, int64_t* samples) const
+{
+    const int index = static_cast<int>(stage);
+    const int count = mCount[index];
+    const int first = (mNext[index] - count + WINDOW_SIZE) % WINDOW_SIZE;
+    for (int idx = 0; idx < count; idx++)
+        samples[idx] = mSamples[index][(first + idx) % WINDOW_SIZE];
+    return count;
+}
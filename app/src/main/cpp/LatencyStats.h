@@ -0,0 +1,118 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __LATENCYSTATS_H__
+#define __LATENCYSTATS_H__
+
+#include <cstdint>
+#include <mutex>
+
+/// Rolling percentiles of the render frame stages and of the camera-to-display latency
+/**
+ * The render thread measures each frame with a FrameTimer (mark() after every stage) and hands it
+ * to record() together with the capture time of the camera frame it drew. The last WINDOW_SIZE
+ * samples of every stage are kept in fixed rings, so recording never allocates; the percentiles are
+ * only computed when they are queried (getPercentiles, dumpToFile), which may happen on any thread.
+ *
+ * The camera timestamp is only comparable with steady_clock if the camera clock is CLOCK_MONOTONIC,
+ * as on Android. Timestamps that give an age outside 0..MAX_CAMERA_AGE_NS are taken to be from another
+ * clock (e.g. CLOCK_BOOTTIME after a suspend), and CAMERA_AGE and TOTAL of that frame are measured from
+ * the steady_clock time its state was acquired instead, like AppController::getPredictionHorizon. Those
+ * samples miss the capture-to-acquire part; getAcquireTimeFrameCount() tells how many frames fell back.
+ */
+class LatencyStats
+{
+public:
+    enum class Stage : uint8_t
+    {
+        /// Acquire the state (unless a tracking thread did) and update the video background texture
+        PREPARE,
+        /// Video background and the loop over the tracked targets
+        OBSERVATIONS,
+        /// Deferred draws after the target loop (pause quads)
+        DRAW,
+        /// Release the state and publish the hit test targets
+        FINISH,
+        /// Whole frame, PREPARE to FINISH
+        FRAME,
+        /// Camera capture to the end of PREPARE
+        CAMERA_AGE,
+        /// Camera capture to the end of FINISH
+        TOTAL,
+        COUNT
+    };
+    static constexpr int STAGE_COUNT = static_cast<int>(Stage::COUNT);
+    static constexpr int WINDOW_SIZE = 512;
+    static constexpr int64_t MAX_CAMERA_AGE_NS = 1000000000;
+
+    /// Percentiles of one stage over the last WINDOW_SIZE samples, in microseconds
+    struct Percentiles
+    {
+        int count{ 0 };
+        float p50{ 0.0f };
+        float p95{ 0.0f };
+        float p99{ 0.0f };
+        float max{ 0.0f };
+    };
+
+    /// Stage durations of one frame, started by the constructor
+    class FrameTimer
+    {
+    public:
+        FrameTimer();
+
+        /// Add the time since the previous mark (or the start) to stage, may be called more than once per stage
+        void mark(Stage stage);
+
+        /// steady_clock time the timer was started
+        int64_t getStartTime() const { return mStart; }
+        /// Time marked for stage so far (FRAME, CAMERA_AGE and TOTAL are only computed by record())
+        int64_t getStageNs(Stage stage) const { return mStageNs[static_cast<int>(stage)]; }
+
+    private:
+        friend class LatencyStats;
+
+        int64_t mStart;
+        int64_t mLast;
+        /// End time of the PREPARE stage
+        int64_t mPrepared{ 0 };
+        int64_t mStageNs[STAGE_COUNT]{};
+    };
+
+    /// Render thread: record a finished frame. cameraTimestampNs is the capture time of its camera frame, 0 if unknown,
+    /// and acquireTimeNs the steady_clock time its state was acquired
+    void record(const FrameTimer& timer, int64_t cameraTimestampNs, int64_t acquireTimeNs);
+
+    Percentiles getPercentiles(Stage stage) const;
+
+    /// Number of frames recorded since the start or the last reset
+    uint64_t getFrameCount() const;
+
+    /// Number of those frames whose camera timestamp was not a steady_clock time (CAMERA_AGE and TOTAL from the acquire)
+    uint64_t getAcquireTimeFrameCount() const;
+
+    /// Write the percentiles of every stage and the raw samples of the window as text, false on an I/O error
+    bool dumpToFile(const char* path) const;
+
+    void reset();
+
+    static const char* getStageName(Stage stage);
+
+    /// steady_clock time in ns, the clock of FrameTimer
+    static int64_t now();
+
+private:
+    /// Copy the samples of stage in recording order, returns the count. mMutex must be held.
+    int copySamples(Stage stage, int64_t* samples) const;
+
+    mutable std::mutex mMutex;
+    int64_t mSamples[STAGE_COUNT][WINDOW_SIZE]{};
+    /// Index of the next sample of each stage
+    int mNext[STAGE_COUNT]{};
+    int mCount[STAGE_COUNT]{};
+    uint64_t mFrameCount{ 0 };
+    uint64_t mAcquireTimeFrameCount{ 0 };
+};
+
+#endif // __LATENCYSTATS_H__
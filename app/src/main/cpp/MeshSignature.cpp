@@ -0,0 +1,70 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "MeshSignature.h"
+
+#include <cstring>
+
+namespace
+{
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+/* FNV-1aを32bitワード単位で4レーン並列に回す(乗算の依存チェーンを切るため)。変更検出には十分 */
+constexpr int NUM_LANES = 4;
+
+void
+hashWords(uint64_t (&lanes)[NUM_LANES], const void* data, size_t numWords)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    size_t idx = 0;
+    for (; idx + NUM_LANES <= numWords; idx += NUM_LANES)
+    {
+        uint32_t words[NUM_LANES];
+        std::memcpy(words, bytes + idx * sizeof(uint32_t), sizeof(words));
+        for (int lane = 0; lane < NUM_LANES; lane++)
+        {
+            lanes[lane] = (lanes[lane] ^ words[lane]) * FNV_PRIME;
+        }
+    }
+    for (; idx < numWords; idx++)
+    {
+        uint32_t word;
+        std::memcpy(&word, bytes + idx * sizeof(word), sizeof(word));
+        lanes[0] = (lanes[0] ^ word) * FNV_PRIME;
+    }
+}
+}
+
+
+MeshSignature
+computeMeshSignature(const void* mesh, const float* positions, const float* textureCoordinates, int32_t numVertices,
+                     const uint32_t* indices, int32_t numFaces)
+{
+    MeshSignature signature;
+    signature.mesh = mesh;
+    signature.numVertices = numVertices;
+    signature.numFaces = numFaces;
+
+    uint64_t lanes[NUM_LANES];
+    for (int lane = 0; lane < NUM_LANES; lane++)
+    {
+        lanes[lane] = FNV_OFFSET_BASIS + lane;
+    }
+    hashWords(lanes, positions, static_cast<size_t>(numVertices) * 3);
+    hashWords(lanes, textureCoordinates, static_cast<size_t>(numVertices) * 2);
+    hashWords(lanes, indices, static_cast<size_t>(numFaces) * 3);
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (uint64_t lane : lanes)
+    {
+        hash = (hash ^ lane) * FNV_PRIME;
+    }
+    signature.hash = hash;
+    return signature;
+}
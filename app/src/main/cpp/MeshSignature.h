@@ -0,0 +1,37 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __MESHSIGNATURE_H__
+#define __MESHSIGNATURE_H__
+
+#include <cstdint>
+
+/// Identifies the content of a mesh so that GPU copies are only refreshed when it changes
+/**
+ * The engine hands out the video background mesh through a pointer that usually stays the same for
+ * the whole session, but it may rewrite the data in place when the view configuration changes.
+ * Comparing the pointer, the sizes and a hash of the data catches both cases.
+ */
+struct MeshSignature
+{
+    const void* mesh{ nullptr };
+    int32_t numVertices{ 0 };
+    int32_t numFaces{ 0 };
+    uint64_t hash{ 0 };
+
+    bool operator==(const MeshSignature& other) const
+    {
+        return mesh == other.mesh && numVertices == other.numVertices && numFaces == other.numFaces && hash == other.hash;
+    }
+    bool operator!=(const MeshSignature& other) const { return !(*this == other); }
+};
+
+/// Compute the signature of a triangle mesh (3 floats per position, 2 per texture coordinate, 3 indices per face)
+/**
+ * mesh is only used as identity and never dereferenced.
+ */
+MeshSignature computeMeshSignature(const void* mesh, const float* positions, const float* textureCoordinates, int32_t numVertices,
+                                   const uint32_t* indices, int32_t numFaces);
+
+#endif // __MESHSIGNATURE_H__
@@ -0,0 +1,80 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "ObjModel.h"
+
+#include "Log.h"
+#include "MemoryStream.h"
+#include "tiny_obj_loader.h"
+
+#include <string>
+
+
+bool
+loadObjModel(const char* data, size_t size, int& numVertices, std::vector<float>& vertices, std::vector<float>& texCoords)
+{
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+
+    std::string warn;
+    std::string err;
+
+    MemoryInputStream aFileDataStream(data, size);
+    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &aFileDataStream);
+    if (!ret || !err.empty())
+    {
+        LOG("Error loading model (%s)", err.c_str());
+        return false;
+    }
+    if (!warn.empty())
+    {
+        LOG("Warning loading model (%s)", warn.c_str());
+    }
+
+    numVertices = 0;
+    vertices.clear();
+    texCoords.clear();
+    // Loop over shapes
+    // s is the index into the shapes vector
+    // f is the index of the current face
+    // v is the index of the current vertex
+    for (size_t s = 0; s < shapes.size(); ++s)
+    {
+        // Loop over faces(polygon)
+        size_t index_offset = 0;
+        for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); ++f)
+        {
+            size_t fv = shapes[s].mesh.num_face_vertices[f];
+            numVertices += static_cast<int>(fv);
+
+            // Loop over vertices in the face.
+            for (size_t v = 0; v < fv; ++v)
+            {
+                // access to vertex
+                tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
+
+                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 0]);
+                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 1]);
+                vertices.push_back(attrib.vertices[3 * idx.vertex_index + 2]);
+
+                // The model may not have texture coordinates for every vertex
+                // If a texture coordinate is missing we just set it to 0,0
+                // This may not be suitable for rendering some OBJ model files
+                if (idx.texcoord_index < 0)
+                {
+                    texCoords.push_back(0.f);
+                    texCoords.push_back(0.f);
+                }
+                else
+                {
+                    texCoords.push_back(attrib.texcoords[2 * idx.texcoord_index + 0]);
+                    texCoords.push_back(attrib.texcoords[2 * idx.texcoord_index + 1]);
+                }
+            }
+            index_offset += fv;
+        }
+    }
+    return true;
+}
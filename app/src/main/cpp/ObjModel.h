@@ -0,0 +1,18 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __OBJMODEL_H__
+#define __OBJMODEL_H__
+
+#include <cstddef>
+#include <vector>
+
+/// Load a model from an OBJ file
+/*
+ * The model is input as the data buffer, the vertex and texture coordinate
+ * vectors are populated by this method as it reads the input.
+ */
+bool loadObjModel(const char* data, size_t size, int& numVertices, std::vector<float>& vertices, std::vector<float>& texCoords);
+
+#endif // __OBJMODEL_H__
@@ -0,0 +1,102 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "PosePredictor.h"
+
+#include "glm/gtc/quaternion.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+PoseMotion
+PosePredictor::update(int key, const float* pose, int64_t timestampNs)
+{
+    PoseMotion motion;
+    if (key < 0 || key >= TargetRegistry::MAX_TARGETS)
+        return motion;
+
+    History& history = mHistories[key];
+    /* 時刻が戻った・間が空きすぎた場合は履歴を捨てる */
+    if (history.count > 0)
+    {
+        const int64_t sinceNewest = timestampNs - history.samples[history.newest].timestamp;
+        /* 同じカメラフレームをもう一度渡されたときはサンプルを増やさず、前回の速度を返す */
+        if (sinceNewest == 0)
+            return history.motion;
+        if (sinceNewest < 0 || sinceNewest > MAX_SAMPLE_GAP_NS)
+            history.count = 0;
+    }
+
+    history.newest = (history.newest + 1) % HISTORY_SIZE;
+    history.samples[history.newest] = Sample{ timestampNs, glm::make_mat4(pose) };
+    history.count = std::min(history.count + 1, HISTORY_SIZE);
+    history.motion = motion;
+    if (history.count < 2)
+        return motion;
+
+    /* 一番古いサンプルと最新の差分から速度を出す(2フレーム間の差分よりノイズに強い) */
+    const Sample& oldest = history.samples[(history.newest + HISTORY_SIZE - history.count + 1) % HISTORY_SIZE];
+    const Sample& newest = history.samples[history.newest];
+    const float seconds = static_cast<float>(newest.timestamp - oldest.timestamp) * 1e-9f;
+
+    motion.linearVelocity = (glm::vec3(newest.pose[3]) - glm::vec3(oldest.pose[3])) / seconds;
+
+    /* 親座標系での回転差分 newest = delta * oldest */
+    glm::quat delta = glm::quat_cast(glm::mat3(newest.pose) * glm::transpose(glm::mat3(oldest.pose)));
+    if (delta.w < 0.0f)
+        delta = -delta;
+    const float angle = 2.0f * std::acos(std::min(delta.w, 1.0f));
+    const glm::vec3 axis(delta.x, delta.y, delta.z);
+    const float axisLength = glm::length(axis);
+    if (axisLength > 1e-6f)
+        motion.angularVelocity = axis * (angle / (axisLength * seconds));
+
+    motion.valid = true;
+    history.motion = motion;
+    return motion;
+}
+
+
+PoseMotion
+PosePredictor::getMotion(int key) const
+{
+    if (key < 0 || key >= TargetRegistry::MAX_TARGETS || mHistories[key].count == 0)
+        return PoseMotion{};
+    return mHistories[key].motion;
+}
+
+
+void
+PosePredictor::reset()
+{
+    for (History& history : mHistories)
+    {
+        history.count = 0;
+        history.motion = PoseMotion{};
+    }
+}
+
+
+void
+PosePredictor::extrapolate(const float* pose, const PoseMotion& motion, float seconds, float* out)
+{
+    glm::mat4 result = glm::make_mat4(pose);
+    seconds = std::clamp(seconds, 0.0f, MAX_HORIZON_SECONDS);
+    if (motion.valid && seconds > 0.0f)
+    {
+        const glm::vec3 rotationVector = motion.angularVelocity * seconds;
+        const float angle = glm::length(rotationVector);
+        if (angle > 1e-6f)
+        {
+            const glm::mat3 rotation = glm::mat3_cast(glm::angleAxis(angle, rotationVector / angle)) * glm::mat3(result);
+            result[0] = glm::vec4(rotation[0], 0.0f);
+            result[1] = glm::vec4(rotation[1], 0.0f);
+            result[2] = glm::vec4(rotation[2], 0.0f);
+        }
+        result[3] = glm::vec4(glm::vec3(result[3]) + motion.linearVelocity * seconds, 1.0f);
+    }
+    std::copy(glm::value_ptr(result), glm::value_ptr(result) + 16, out);
+}
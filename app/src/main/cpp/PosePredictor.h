@@ -0,0 +1,81 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __POSEPREDICTOR_H__
+#define __POSEPREDICTOR_H__
+
+#include "TargetRegistry.h"
+
+#include <array>
+#include <cstdint>
+
+#include "glm/glm.hpp"
+
+/// Velocity of a rigid pose, estimated by PosePredictor
+struct PoseMotion
+{
+    /// False until the pose has at least two recent samples
+    bool valid{ false };
+    /// Translation rate in m/s, in the parent space of the pose
+    glm::vec3 linearVelocity{ 0.0f };
+    /// Rotation rate as axis * rad/s, in the parent space of the pose
+    glm::vec3 angularVelocity{ 0.0f };
+};
+
+/// Short per-pose history used to extrapolate target poses to the display time
+/**
+ * Poses are rigid column-major 4x4 matrices (rotation and translation only, e.g. the unscaled
+ * model-view of a target). update() is called once per camera frame with the camera timestamp
+ * and returns the velocity over the last HISTORY_SIZE samples; extrapolate() then moves the pose
+ * forward by a time horizon at constant velocity. A gap in the samples longer than
+ * MAX_SAMPLE_GAP_NS or a timestamp going backwards restarts the history of that key. A repeated
+ * timestamp (the engine hands out the same camera frame until the next one arrives) adds no sample
+ * and returns the motion of the newest sample.
+ *
+ * Keys are target IDs (0..MAX_TARGETS-1). Only one thread may call update().
+ */
+class PosePredictor
+{
+public:
+    static constexpr int HISTORY_SIZE = 4;
+    /// Samples further apart than this are not used to estimate a velocity (ns)
+    static constexpr int64_t MAX_SAMPLE_GAP_NS = 200000000;
+    /// extrapolate() never looks further ahead than this (s)
+    static constexpr float MAX_HORIZON_SECONDS = 0.1f;
+
+    /// Add the pose of key observed at timestampNs and return its current motion
+    PoseMotion update(int key, const float* pose, int64_t timestampNs);
+
+    /// Motion of key at its newest sample, not valid if key has no history
+    PoseMotion getMotion(int key) const;
+
+    /// Forget the history of every key
+    void reset();
+
+    /// Move pose forward by seconds (clamped to 0..MAX_HORIZON_SECONDS) at the given motion.
+    /// out may alias pose. Copies pose if motion is not valid.
+    static void extrapolate(const float* pose, const PoseMotion& motion, float seconds, float* out);
+
+private:
+    struct Sample
+    {
+        int64_t timestamp{ 0 };
+        glm::mat4 pose{ 1.0f };
+    };
+
+    /* キーごとの直近の姿勢(リングバッファ) */
+    struct History
+    {
+        std::array<Sample, HISTORY_SIZE> samples{};
+        /// Index of the newest sample
+        int newest{ 0 };
+        int count{ 0 };
+        /// Motion at the newest sample
+        PoseMotion motion{};
+    };
+
+    std::array<History, TargetRegistry::MAX_TARGETS> mHistories{};
+};
+
+#endif // __POSEPREDICTOR_H__
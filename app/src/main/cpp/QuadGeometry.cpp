@@ -0,0 +1,82 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "QuadGeometry.h"
+#include "SimdMath.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+
+glm::vec2
+computeVideoQuadHalfExtent(bool fullscreen, float videoWidth, float videoHeight, float screenWidth, float screenHeight,
+                           const glm::vec2& markerSize)
+{
+    float scaleX = 0.5f;
+    float scaleY = 0.5f;
+
+    if (fullscreen)
+    {
+        scaleX = 1.0f;
+        scaleY = 1.0f;
+
+        float videoAspect = videoWidth / videoHeight;
+        float screenAspect = screenWidth / screenHeight;
+
+        if (screenAspect > videoAspect) /* 横長動画 → 横を1.0にして縦を縮める */
+            scaleX = videoAspect / screenAspect;
+        else /* 縦長動画 → 縦を1.0にして横を縮める */
+            scaleY = screenAspect / videoAspect;
+    }
+    else
+    {
+        /* Calculation of vertex coordinates considering the aspect ratio. */
+        float markerAspect = markerSize.x / markerSize.y;
+        float videoAspect = videoWidth / videoHeight;
+
+        if (markerAspect > videoAspect) /* When the marker is wider than the video. */
+            scaleX = scaleX * (videoAspect / markerAspect);
+        else /* When the marker is taller than the video or has the same aspect ratio. */
+            scaleY = scaleY * (markerAspect / videoAspect);
+    }
+
+    return glm::vec2(scaleX, scaleY);
+}
+
+
+void
+makeQuadVertices(const glm::vec2& halfExtent, float vertices[12])
+{
+    const float strip[12] = {
+        -halfExtent.x, -halfExtent.y, 0.0f, /* 左下 */
+         halfExtent.x, -halfExtent.y, 0.0f, /* 右下 */
+        -halfExtent.x,  halfExtent.y, 0.0f, /* 左上 */
+         halfExtent.x,  halfExtent.y, 0.0f  /* 右上 */
+    };
+    std::copy(std::begin(strip), std::end(strip), vertices);
+}
+
+
+std::array<glm::vec2, 4>
+projectQuadToNdc(const float* mvp, const glm::vec2& halfExtent)
+{
+    std::array<glm::vec2, 4> ndcQuadPoints;
+    projectQuadsToNdc(mvp, &halfExtent, 1, &ndcQuadPoints);
+    return ndcQuadPoints;
+}
+
+
+void
+projectQuadsToNdc(const float* mvps, const glm::vec2* halfExtents, int count, std::array<glm::vec2, 4>* ndcQuadPoints)
+{
+    for (int idx = 0; idx < count; idx++)
+    {
+        /* 左下→右下→右上→左上の順番で(x, y)が4組並んで出てくる */
+        static_assert(sizeof(std::array<glm::vec2, 4>) == 8 * sizeof(float), "quad must be 8 packed floats");
+        float ndcXY[8];
+        projectQuadCornersToNdc(mvps + 16 * idx, halfExtents[idx].x, halfExtents[idx].y, ndcXY);
+        std::memcpy(ndcQuadPoints[idx].data(), ndcXY, sizeof(ndcXY));
+    }
+}
@@ -0,0 +1,40 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __QUADGEOMETRY_H__
+#define __QUADGEOMETRY_H__
+
+#include "glm/glm.hpp"
+
+#include <array>
+
+/// Half size of the pause overlay quad (a unit quad centered on the target)
+static const float PAUSE_QUAD_HALF_EXTENT = 0.5f;
+
+/// Compute the half size of the video quad so that the video keeps its aspect ratio.
+/**
+ * In fullscreen mode the quad is fitted into the screen (identity projection), otherwise it is fitted
+ * into the marker (unit quad scaled by the marker size).
+ */
+glm::vec2 computeVideoQuadHalfExtent(bool fullscreen, float videoWidth, float videoHeight, float screenWidth, float screenHeight,
+                                     const glm::vec2& markerSize);
+
+/// Fill a triangle strip (left bottom, right bottom, left top, right top) of 3D positions for a quad on the z=0 plane
+void makeQuadVertices(const glm::vec2& halfExtent, float vertices[12]);
+
+/// Project the corners of a quad on the z=0 plane to NDC
+/**
+ * mvp is a column-major 4x4 matrix. The corners are returned in outline order
+ * (left bottom -> right bottom -> right top -> left top) as required by checkPolygonHit.
+ */
+std::array<glm::vec2, 4> projectQuadToNdc(const float* mvp, const glm::vec2& halfExtent);
+
+/// Project the quads of several targets to NDC in one batch
+/**
+ * mvps holds count column-major 4x4 matrices back to back (16 floats each), halfExtents and
+ * ndcQuadPoints hold count entries. Same result as calling projectQuadToNdc for each quad.
+ */
+void projectQuadsToNdc(const float* mvps, const glm::vec2* halfExtents, int count, std::array<glm::vec2, 4>* ndcQuadPoints);
+
+#endif // __QUADGEOMETRY_H__
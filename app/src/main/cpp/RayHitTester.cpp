@@ -0,0 +1,116 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "RayHitTester.h"
+
+#include "glm/gtc/matrix_inverse.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <cmath>
+
+
+namespace
+{
+/// Texture coordinates of a point on the quad (v runs top to bottom as in the quad texcoords)
+glm::vec2
+quadUv(float x, float y, const glm::vec2& halfExtent)
+{
+    return glm::vec2(0.5f * (x / halfExtent.x + 1.0f), 0.5f * (1.0f - y / halfExtent.y));
+}
+}
+
+
+void
+RayHitTester::setProjection(const float* projection)
+{
+    mProjection = glm::make_mat4(projection);
+}
+
+
+void
+RayHitTester::addTarget(int targetId, const float* scaledModelView, const glm::vec2& halfExtent)
+{
+    Snapshot& snapshot = mSnapshots.writeBuffer();
+    if (snapshot.count >= TargetRegistry::MAX_TARGETS)
+        return;
+
+    Target& target = snapshot.targets[snapshot.count++];
+    target.targetId = targetId;
+    target.halfExtent = halfExtent;
+    /* モデルビューはアフィン変換なので一般の逆行列より安い */
+    target.inverseModelView = glm::affineInverse(glm::make_mat4(scaledModelView));
+}
+
+
+void
+RayHitTester::setFullscreenTarget(int targetId, const glm::vec2& halfExtent)
+{
+    Snapshot& snapshot = mSnapshots.writeBuffer();
+    snapshot.fullscreenTargetId = targetId;
+    snapshot.fullscreenHalfExtent = halfExtent;
+}
+
+
+void
+RayHitTester::publish()
+{
+    mSnapshots.writeBuffer().inverseProjection = glm::inverse(mProjection);
+    mSnapshots.publish();
+
+    /* 次のフレーム用の面を空にしておく */
+    Snapshot& next = mSnapshots.writeBuffer();
+    next.count = 0;
+    next.fullscreenTargetId = TargetRegistry::INVALID_ID;
+}
+
+
+bool
+RayHitTester::hitTest(const glm::vec2& ndcPoint, Hit& hit)
+{
+    const Snapshot& snapshot = mSnapshots.read();
+
+    /* 全画面の動画は単位行列で描いているのでNDCのまま判定し、他のターゲットより手前とみなす */
+    if (snapshot.fullscreenTargetId != TargetRegistry::INVALID_ID &&
+        std::abs(ndcPoint.x) <= snapshot.fullscreenHalfExtent.x && std::abs(ndcPoint.y) <= snapshot.fullscreenHalfExtent.y)
+    {
+        hit.targetId = snapshot.fullscreenTargetId;
+        hit.uv = quadUv(ndcPoint.x, ndcPoint.y, snapshot.fullscreenHalfExtent);
+        hit.distance = 0.0f;
+        return true;
+    }
+
+    /* タッチ位置をカメラ座標系のレイ(ニア面 → ファー面)に戻す */
+    glm::vec4 nearPoint = snapshot.inverseProjection * glm::vec4(ndcPoint, -1.0f, 1.0f);
+    glm::vec4 farPoint = snapshot.inverseProjection * glm::vec4(ndcPoint, 1.0f, 1.0f);
+    const glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+    const glm::vec3 direction = glm::vec3(farPoint) / farPoint.w - origin;
+
+    float nearestT = INFINITY;
+    for (int idx = 0; idx < snapshot.count; idx++)
+    {
+        const Target& target = snapshot.targets[idx];
+
+        /* ターゲット座標系ではターゲット面がz=0 */
+        const glm::vec3 localOrigin = glm::vec3(target.inverseModelView * glm::vec4(origin, 1.0f));
+        const glm::vec3 localDirection = glm::vec3(target.inverseModelView * glm::vec4(direction, 0.0f));
+        if (localDirection.z == 0.0f)
+            continue;
+        const float t = -localOrigin.z / localDirection.z;
+        if (t < 0.0f || t >= nearestT)
+            continue;
+
+        const glm::vec3 point = localOrigin + t * localDirection;
+        if (std::abs(point.x) > target.halfExtent.x || std::abs(point.y) > target.halfExtent.y)
+            continue;
+
+        nearestT = t;
+        hit.targetId = target.targetId;
+        hit.uv = quadUv(point.x, point.y, target.halfExtent);
+    }
+
+    if (nearestT == INFINITY)
+        return false;
+    hit.distance = nearestT * glm::length(direction);
+    return true;
+}
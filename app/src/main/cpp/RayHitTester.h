@@ -0,0 +1,78 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __RAYHITTESTER_H__
+#define __RAYHITTESTER_H__
+
+#include "TargetRegistry.h"
+#include "TripleBuffer.h"
+
+#include "glm/glm.hpp"
+
+/// Touch hit testing by casting a ray through the touch point against the target planes
+/**
+ * Every frame the render thread hands over the camera projection and, per tracked target, the
+ * scaled model-view matrix and the half size of the quad drawn on it, then calls publish(). The
+ * inverse matrices are computed there, so hitTest() on the UI thread only unprojects the touch once
+ * and intersects the ray with the z=0 plane of each target in target space: a fixed cost per target
+ * and the nearest target wins, whatever order the quads were drawn in.
+ *
+ * Each publish() replaces the whole set, so a target that is not tracked any more cannot be hit
+ * and no expiry timer is needed. A video drawn fullscreen (identity projection) is tested in NDC
+ * and covers everything else.
+ */
+class RayHitTester
+{
+public:
+    /// Result of hitTest
+    struct Hit
+    {
+        int targetId{ TargetRegistry::INVALID_ID };
+        /// Position on the quad in texture coordinates: (0, 0) left top, (1, 1) right bottom
+        glm::vec2 uv{ 0.0f };
+        /// Distance from the near plane along the ray in camera space units, 0 for the fullscreen video
+        float distance{ 0.0f };
+    };
+
+    /// Render thread: camera projection (column-major 4x4) of the frame being collected
+    void setProjection(const float* projection);
+
+    /// Render thread: add the quad |x| <= halfExtent.x, |y| <= halfExtent.y on the z=0 plane of a target.
+    /// scaledModelView (column-major 4x4) maps the target space to camera space.
+    void addTarget(int targetId, const float* scaledModelView, const glm::vec2& halfExtent);
+
+    /// Render thread: the video of targetId is drawn fullscreen with the given half size in NDC
+    void setFullscreenTarget(int targetId, const glm::vec2& halfExtent);
+
+    /// Render thread: make the targets added since the last publish() the ones hitTest() sees
+    void publish();
+
+    /// UI thread (single reader): find the nearest target under ndcPoint, false if there is none
+    bool hitTest(const glm::vec2& ndcPoint, Hit& hit);
+
+private:
+    struct Target
+    {
+        int targetId{ 0 };
+        glm::vec2 halfExtent{ 0.0f };
+        /// Camera space to target space
+        glm::mat4 inverseModelView{ 1.0f };
+    };
+
+    /* UIスレッドに渡す1フレーム分の逆行列一式 */
+    struct Snapshot
+    {
+        glm::mat4 inverseProjection{ 1.0f };
+        int fullscreenTargetId{ TargetRegistry::INVALID_ID };
+        glm::vec2 fullscreenHalfExtent{ 0.0f };
+        int count{ 0 };
+        Target targets[TargetRegistry::MAX_TARGETS]{};
+    };
+
+    /// Projection of the frame being collected, inverted in publish()
+    glm::mat4 mProjection{ 1.0f };
+    TripleBuffer<Snapshot> mSnapshots;
+};
+
+#endif // __RAYHITTESTER_H__
@@ -0,0 +1,41 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __RENDERCOMMAND_H__
+#define __RENDERCOMMAND_H__
+
+#include "SpscQueue.h"
+
+#include <cstdint>
+
+/// Renderer setting posted from the UI thread and applied by the render thread at the start of a frame
+struct RenderCommand
+{
+    enum class Type : uint8_t
+    {
+        /// Size of the playing video, width and height
+        SET_VIDEO_SIZE,
+        /// Size of the GL surface, width and height
+        SET_SCREEN_SIZE,
+        /// Fullscreen playback on (enabled) or off
+        SET_FULLSCREEN,
+        /// Performance HUD on (enabled) or off
+        SET_HUD,
+    };
+
+    Type type{ Type::SET_VIDEO_SIZE };
+    bool enabled{ false };
+    float width{ 0.0f };
+    float height{ 0.0f };
+
+    static RenderCommand videoSize(float width, float height) { return { Type::SET_VIDEO_SIZE, false, width, height }; }
+    static RenderCommand screenSize(float width, float height) { return { Type::SET_SCREEN_SIZE, false, width, height }; }
+    static RenderCommand fullscreen(bool enabled) { return { Type::SET_FULLSCREEN, enabled, 0.0f, 0.0f }; }
+    static RenderCommand hud(bool enabled) { return { Type::SET_HUD, enabled, 0.0f, 0.0f }; }
+};
+
+/// Commands are settings, so a few pending ones are plenty even if the render thread is paused for a while
+using RenderCommandQueue = SpscQueue<RenderCommand, 64>;
+
+#endif // __RENDERCOMMAND_H__
@@ -10,14 +10,16 @@ countries.
 
 /////////////////////////////////////////////////////////////////////////////////////////
 // texture shader: vertexTexCoord in vertex shader, textureOES sample
+// a_Position is the unit quad (+-1), u_HalfExtent scales it to the aspect-dependent size
 /////////////////////////////////////////////////////////////////////////////////////////
 static const char* VERTEX_SHADER =
         "attribute vec4 a_Position;\n"
         "attribute vec2 a_TexCoord;\n"
         "uniform mat4 u_ProjectionMatrix;\n"
+        "uniform vec2 u_HalfExtent;\n"
         "varying vec2 v_TexCoord;\n"
         "void main() {\n"
-        "  gl_Position = u_ProjectionMatrix * a_Position;\n"
+        "  gl_Position = u_ProjectionMatrix * vec4(a_Position.xy * u_HalfExtent, a_Position.zw);\n"
         "  v_TexCoord = a_TexCoord;\n"
         "}\n";
 
@@ -30,13 +32,15 @@ static const char* FRAGMENT_SHADER =
         "  gl_FragColor = texture2D(u_SamplerOES, v_TexCoord);\n"
         "}\n";
 
+/* pause.pngは全ターゲット分を1回のインスタンス描画で出す。MVPはインスタンスごとの属性 */
 static const char* VERTEX_SHADER_PAUSE =
         "attribute vec4 a_Position;\n"
         "attribute vec2 a_TexCoord;\n"
-        "uniform mat4 u_ProjectionMatrix;\n"
+        "attribute mat4 a_ModelViewProjection;\n"
+        "uniform vec2 u_HalfExtent;\n"
         "varying vec2 v_TexCoord;\n"
         "void main() {\n"
-        "  gl_Position = u_ProjectionMatrix * a_Position;\n"
+        "  gl_Position = a_ModelViewProjection * vec4(a_Position.xy * u_HalfExtent, a_Position.zw);\n"
         "  v_TexCoord = a_TexCoord;\n"
         "}\n";
 
@@ -48,6 +52,28 @@ static const char* FRAGMENT_SHADER_PAUSE =
         "  gl_FragColor = texture2D(u_Sampler2D, v_TexCoord);\n"
         "}\n";
 
+/* 性能HUD: 頂点はNDCで、色は頂点ごと。フォントアトラスの被覆率をアルファに掛ける */
+static const char* VERTEX_SHADER_HUD =
+        "attribute vec2 a_Position;\n"
+        "attribute vec2 a_TexCoord;\n"
+        "attribute vec4 a_Color;\n"
+        "varying vec2 v_TexCoord;\n"
+        "varying vec4 v_Color;\n"
+        "void main() {\n"
+        "  gl_Position = vec4(a_Position, 0.0, 1.0);\n"
+        "  v_TexCoord = a_TexCoord;\n"
+        "  v_Color = a_Color;\n"
+        "}\n";
+
+static const char* FRAGMENT_SHADER_HUD =
+        "precision mediump float;\n"
+        "varying vec2 v_TexCoord;\n"
+        "varying vec4 v_Color;\n"
+        "uniform sampler2D u_Atlas;\n"
+        "void main() {\n"
+        "  gl_FragColor = vec4(v_Color.rgb, v_Color.a * texture2D(u_Atlas, v_TexCoord).r);\n"
+        "}\n";
+
 
 /////////////////////////////////////////////////////////////////////////////////////////
 // texture shader: vertexTexCoord in vertex shader, texture2D sample
@@ -0,0 +1,172 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __SIMDMATH_H__
+#define __SIMDMATH_H__
+
+/// Inline 4x4 matrix kernels for the per-frame target math
+/**
+ * All matrices are column-major float[16] (same layout as VuMatrix44F and glm::mat4). The kernels use
+ * NEON on ARM, SSE2 on x86 hosts and plain C++ otherwise. Everything is inline so the compiler can keep
+ * the columns in registers across calls, unlike the opaque vuMatrix44F* calls into the engine library.
+ * Accuracy against glm is checked by vpb_corebench.
+ */
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define VPB_SIMD_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VPB_SIMD_SSE 1
+#endif
+
+namespace simdmath
+{
+#if defined(VPB_SIMD_NEON)
+using Float4 = float32x4_t;
+
+inline Float4 load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 splat(float s) { return vdupq_n_f32(s); }
+inline Float4 set(float a, float b, float c, float d)
+{
+    const float values[4] = { a, b, c, d };
+    return vld1q_f32(values);
+}
+inline Float4 mul(Float4 a, float s) { return vmulq_n_f32(a, s); }
+/// acc + v * s
+inline Float4 madd(Float4 acc, Float4 v, float s)
+{
+#if defined(__aarch64__)
+    return vfmaq_n_f32(acc, v, s);
+#else
+    return vmlaq_n_f32(acc, v, s);
+#endif
+}
+inline Float4 mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 reciprocal(Float4 v)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(vdupq_n_f32(1.0f), v);
+#else
+    /* ARMv7には除算命令がないので推定値をニュートン法で2回詰める */
+    Float4 r = vrecpeq_f32(v);
+    r = vmulq_f32(vrecpsq_f32(v, r), r);
+    return vmulq_f32(vrecpsq_f32(v, r), r);
+#endif
+}
+/// Store x0 y0 x1 y1 x2 y2 x3 y3
+inline void storeInterleaved(float* p, Float4 x, Float4 y) { vst2q_f32(p, float32x4x2_t{ { x, y } }); }
+
+#elif defined(VPB_SIMD_SSE)
+using Float4 = __m128;
+
+inline Float4 load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 splat(float s) { return _mm_set1_ps(s); }
+inline Float4 set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+inline Float4 mul(Float4 a, float s) { return _mm_mul_ps(a, _mm_set1_ps(s)); }
+/// acc + v * s
+inline Float4 madd(Float4 acc, Float4 v, float s) { return _mm_add_ps(acc, _mm_mul_ps(v, _mm_set1_ps(s))); }
+inline Float4 mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 reciprocal(Float4 v) { return _mm_div_ps(_mm_set1_ps(1.0f), v); }
+/// Store x0 y0 x1 y1 x2 y2 x3 y3
+inline void storeInterleaved(float* p, Float4 x, Float4 y)
+{
+    _mm_storeu_ps(p, _mm_unpacklo_ps(x, y));
+    _mm_storeu_ps(p + 4, _mm_unpackhi_ps(x, y));
+}
+
+#else
+struct Float4
+{
+    float v[4];
+};
+
+inline Float4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void store(float* p, Float4 a)
+{
+    for (int i = 0; i < 4; i++)
+        p[i] = a.v[i];
+}
+inline Float4 splat(float s) { return { { s, s, s, s } }; }
+inline Float4 set(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+inline Float4 mul(Float4 a, float s) { return { { a.v[0] * s, a.v[1] * s, a.v[2] * s, a.v[3] * s } }; }
+/// acc + v * s
+inline Float4 madd(Float4 acc, Float4 a, float s)
+{
+    return { { acc.v[0] + a.v[0] * s, acc.v[1] + a.v[1] * s, acc.v[2] + a.v[2] * s, acc.v[3] + a.v[3] * s } };
+}
+inline Float4 mul(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+inline Float4 reciprocal(Float4 a) { return { { 1.0f / a.v[0], 1.0f / a.v[1], 1.0f / a.v[2], 1.0f / a.v[3] } }; }
+/// Store x0 y0 x1 y1 x2 y2 x3 y3
+inline void storeInterleaved(float* p, Float4 x, Float4 y)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        p[2 * i] = x.v[i];
+        p[2 * i + 1] = y.v[i];
+    }
+}
+#endif
+}
+
+
+/// out = a * b (out may alias a or b)
+inline void
+multiplyMatrix44(const float* a, const float* b, float* out)
+{
+    using namespace simdmath;
+    const Float4 a0 = load(a);
+    const Float4 a1 = load(a + 4);
+    const Float4 a2 = load(a + 8);
+    const Float4 a3 = load(a + 12);
+    for (int column = 0; column < 4; column++)
+    {
+        const float* bColumn = b + 4 * column;
+        const float b0 = bColumn[0], b1 = bColumn[1], b2 = bColumn[2], b3 = bColumn[3];
+        Float4 result = mul(a0, b0);
+        result = madd(result, a1, b1);
+        result = madd(result, a2, b2);
+        result = madd(result, a3, b3);
+        store(out + 4 * column, result);
+    }
+}
+
+
+/// out = m * scale(x, y, z), same as glm::scale and vuMatrix44FScale (out may alias m)
+inline void
+scaleMatrix44(const float* m, float x, float y, float z, float* out)
+{
+    using namespace simdmath;
+    store(out, mul(load(m), x));
+    store(out + 4, mul(load(m + 4), y));
+    store(out + 8, mul(load(m + 8), z));
+    store(out + 12, load(m + 12));
+}
+
+
+/// Project the corners of the quad (+-halfX, +-halfY, 0) to NDC
+/**
+ * Structure of arrays: the 4 corners are the 4 SIMD lanes, so one quad is 6 multiply-adds, one
+ * reciprocal and 2 multiplies. The result is written as 4 (x, y) pairs in outline order
+ * (left bottom -> right bottom -> right top -> left top).
+ */
+inline void
+projectQuadCornersToNdc(const float* mvp, float halfX, float halfY, float ndcXY[8])
+{
+    using namespace simdmath;
+    const Float4 cornerX = mul(set(-1.0f, 1.0f, 1.0f, -1.0f), halfX);
+    const Float4 cornerY = mul(set(-1.0f, -1.0f, 1.0f, 1.0f), halfY);
+
+    /* z=0, w=1なので3列目は不要 */
+    const Float4 clipX = madd(madd(splat(mvp[12]), cornerX, mvp[0]), cornerY, mvp[4]);
+    const Float4 clipY = madd(madd(splat(mvp[13]), cornerX, mvp[1]), cornerY, mvp[5]);
+    const Float4 clipW = madd(madd(splat(mvp[15]), cornerX, mvp[3]), cornerY, mvp[7]);
+
+    const Float4 inverseW = reciprocal(clipW);
+    storeInterleaved(ndcXY, mul(clipX, inverseW), mul(clipY, inverseW));
+}
+
+#endif // __SIMDMATH_H__
@@ -0,0 +1,68 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __SPSCQUEUE_H__
+#define __SPSCQUEUE_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/// Bounded lock-free single producer / single consumer FIFO
+/**
+ * A ring of Capacity slots (power of two) with monotonically increasing head and tail counters.
+ * Each side only writes its own counter and keeps a cached copy of the other one, so a push or
+ * pop normally touches no cache line owned by the other thread. Neither side ever blocks:
+ * tryPush fails when the queue is full and tryPop when it is empty.
+ */
+template<typename T, uint32_t Capacity>
+class SpscQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /// Producer side: append value, false if the queue is full
+    bool tryPush(const T& value)
+    {
+        const uint32_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mCachedHead == Capacity)
+        {
+            mCachedHead = mHead.load(std::memory_order_acquire);
+            if (tail - mCachedHead == Capacity)
+            {
+                return false;
+            }
+        }
+        mSlots[tail & (Capacity - 1)] = value;
+        mTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer side: take the oldest value, false if the queue is empty
+    bool tryPop(T& value)
+    {
+        const uint32_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mCachedTail)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head == mCachedTail)
+            {
+                return false;
+            }
+        }
+        value = mSlots[head & (Capacity - 1)];
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> mSlots{};
+    /* 生産者側と消費者側のカウンタを別々のキャッシュラインに置く */
+    alignas(64) std::atomic<uint32_t> mTail{ 0 };
+    uint32_t mCachedHead{ 0 };
+    alignas(64) std::atomic<uint32_t> mHead{ 0 };
+    uint32_t mCachedTail{ 0 };
+};
+
+#endif // __SPSCQUEUE_H__
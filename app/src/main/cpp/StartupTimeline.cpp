@@ -0,0 +1,143 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "StartupTimeline.h"
+#include "Tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+int
+StartupTimeline::begin(const char* name)
+{
+    const int64_t start = now();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mNumPhases == MAX_PHASES)
+        return NO_PHASE;
+
+    Phase& phase = mPhases[mNumPhases];
+    strncpy(phase.name, name, NAME_LENGTH - 1);
+    phase.name[NAME_LENGTH - 1] = '\0';
+    phase.tid = static_cast<int32_t>(syscall(SYS_gettid));
+    phase.start = start;
+    phase.end = 0;
+    return mNumPhases++;
+}
+
+
+void
+StartupTimeline::end(int phase)
+{
+    if (phase == NO_PHASE)
+        return;
+
+    const int64_t end = now();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (phase >= mNumPhases)
+        return;
+    mPhases[phase].end = end;
+#if defined(VPB_ENABLE_TRACING)
+    Tracer::recordEvent(mPhases[phase].name, mPhases[phase].start, end, TraceScope::NO_ID);
+#endif
+}
+
+
+void
+StartupTimeline::record(const char* name, int64_t start, int64_t end)
+{
+    const int phase = begin(name);
+    if (phase == NO_PHASE)
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPhases[phase].start = start;
+    mPhases[phase].end = end;
+#if defined(VPB_ENABLE_TRACING)
+    Tracer::recordEvent(mPhases[phase].name, start, end, TraceScope::NO_ID);
+#endif
+}
+
+
+int
+StartupTimeline::getPhaseCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumPhases;
+}
+
+
+std::string
+StartupTimeline::format() const
+{
+    Phase phases[MAX_PHASES];
+    int numPhases;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::copy(mPhases, mPhases + mNumPhases, phases);
+        numPhases = mNumPhases;
+    }
+    if (numPhases == 0)
+        return "# no startup phases\n";
+
+    /* 開始順に並べ、最初のフェーズの開始を0msとする */
+    std::stable_sort(phases, phases + numPhases, [](const Phase& a, const Phase& b) { return a.start < b.start; });
+    const int64_t origin = phases[0].start;
+    int64_t last = origin;
+    for (int idx = 0; idx < numPhases; idx++)
+        last = std::max(last, std::max(phases[idx].start, phases[idx].end));
+
+    auto toMs = [origin](int64_t time) { return static_cast<double>(time - origin) * 1e-6; };
+    std::string text;
+    char line[160];
+    snprintf(line, sizeof(line), "# startup %.1f ms, %d phases\n# start_ms end_ms duration_ms tid phase\n", toMs(last), numPhases);
+    text += line;
+    for (int idx = 0; idx < numPhases; idx++)
+    {
+        const Phase& phase = phases[idx];
+        /* 名前は数値の列とは別に足す(lineに収まる長さは数値の列だけで決まる) */
+        if (phase.end == 0)
+            snprintf(line, sizeof(line), "%8.1f        -           - %6d ", toMs(phase.start), phase.tid);
+        else
+            snprintf(line, sizeof(line), "%8.1f %8.1f %11.1f %6d ", toMs(phase.start), toMs(phase.end),
+                     static_cast<double>(phase.end - phase.start) * 1e-6, phase.tid);
+        text += line;
+        text += phase.name;
+        text += phase.end == 0 ? " (open)\n" : "\n";
+    }
+    return text;
+}
+
+
+bool
+StartupTimeline::dumpToFile(const char* path) const
+{
+    const std::string text = format();
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+    fputs(text.c_str(), file);
+    const bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
+
+
+void
+StartupTimeline::reset()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNumPhases = 0;
+}
+
+
+int64_t
+StartupTimeline::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
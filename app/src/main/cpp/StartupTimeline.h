@@ -0,0 +1,81 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __STARTUPTIMELINE_H__
+#define __STARTUPTIMELINE_H__
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/// Start and end times of the cold start phases, from any thread
+/**
+ * A phase is opened with begin() and closed with end() (or StartupTimeline::Scope) on the same thread.
+ * Times are steady_clock, printed relative to the first phase. The timeline is only written during
+ * startup, so a mutex is fine; at most MAX_PHASES phases are kept, later ones are dropped.
+ *
+ * With VPB_ENABLE_TRACING every closed phase is also recorded as a trace event of its thread.
+ */
+class StartupTimeline
+{
+public:
+    static constexpr int MAX_PHASES = 64;
+    static constexpr int NAME_LENGTH = 48;
+    /// Returned by begin() when the timeline is full
+    static constexpr int NO_PHASE = -1;
+
+    struct Phase
+    {
+        char name[NAME_LENGTH];
+        int32_t tid;
+        int64_t start;
+        /// 0 while the phase is open
+        int64_t end;
+    };
+
+    /// Closes the phase opened by the constructor when it goes out of scope
+    class Scope
+    {
+    public:
+        Scope(StartupTimeline& timeline, const char* name) : mTimeline(timeline), mPhase(timeline.begin(name)) {}
+        ~Scope() { mTimeline.end(mPhase); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StartupTimeline& mTimeline;
+        int mPhase;
+    };
+
+    /// Open a phase on the calling thread, name is copied
+    int begin(const char* name);
+
+    /// Close a phase returned by begin(), NO_PHASE is ignored
+    void end(int phase);
+
+    /// Add a phase that has already ended (times from now()), e.g. one measured before it was known to be of interest
+    void record(const char* name, int64_t start, int64_t end);
+
+    /// Number of phases recorded
+    int getPhaseCount() const;
+
+    /// The phases ordered by start as a text table (ms since the first phase), headed by the time to the last end
+    std::string format() const;
+
+    /// Write format() to path, false on an I/O error
+    bool dumpToFile(const char* path) const;
+
+    void reset();
+
+    /// steady_clock time in ns
+    static int64_t now();
+
+private:
+    mutable std::mutex mMutex;
+    Phase mPhases[MAX_PHASES]{};
+    int mNumPhases{ 0 };
+};
+
+#endif // __STARTUPTIMELINE_H__
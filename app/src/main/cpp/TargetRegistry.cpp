@@ -0,0 +1,65 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "TargetRegistry.h"
+
+#include "Log.h"
+
+
+namespace
+{
+/// Observer IDs beyond this are not expected, it only bounds the direct lookup table
+constexpr int32_t MAX_OBSERVER_ID = 1024;
+}
+
+
+int
+TargetRegistry::add(const char* name, const char* uniqueId, int32_t observerId, const glm::vec2& targetSize)
+{
+    if (size() == MAX_TARGETS)
+    {
+        LOG("TargetRegistry: more than %d targets, %s is not registered", MAX_TARGETS, name);
+        return INVALID_ID;
+    }
+    if (observerId < 0 || observerId >= MAX_OBSERVER_ID)
+    {
+        LOG("TargetRegistry: observer ID %d of %s is out of range", observerId, name);
+        return INVALID_ID;
+    }
+    if (findByObserverId(observerId) != INVALID_ID)
+    {
+        return INVALID_ID;
+    }
+
+    int id = size();
+    mNames.emplace_back(name);
+    mUniqueIds.emplace_back(uniqueId);
+    mTargetSizes.push_back(targetSize);
+    if (observerId >= static_cast<int32_t>(mIdByObserverId.size()))
+        mIdByObserverId.resize(observerId + 1, INVALID_ID);
+    mIdByObserverId[observerId] = id;
+    return id;
+}
+
+
+void
+TargetRegistry::clear()
+{
+    mNames.clear();
+    mUniqueIds.clear();
+    mTargetSizes.clear();
+    mIdByObserverId.clear();
+}
+
+
+int
+TargetRegistry::findByName(const char* name) const
+{
+    for (int id = 0; id < size(); id++)
+    {
+        if (mNames[id] == name)
+            return id;
+    }
+    return INVALID_ID;
+}
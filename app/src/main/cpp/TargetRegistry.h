@@ -0,0 +1,61 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __TARGETREGISTRY_H__
+#define __TARGETREGISTRY_H__
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Interns the image targets into dense IDs 0..size()-1
+/**
+ * Built once when the observers are created. Per-target data is kept in flat arrays indexed by the
+ * target ID, so the per-frame lookups (observer ID -> target ID, target ID -> name/size) are O(1)
+ * array accesses without string compares or allocation.
+ */
+class TargetRegistry
+{
+public:
+    /// Upper bound of registered targets, per-target arrays elsewhere may be sized with it
+    static constexpr int MAX_TARGETS = 32;
+    /// Returned by the lookups when there is no such target
+    static constexpr int INVALID_ID = -1;
+
+    /// Register a target and return its ID, INVALID_ID if the registry is full or the observer is already registered
+    int add(const char* name, const char* uniqueId, int32_t observerId, const glm::vec2& targetSize);
+
+    /// Drop all targets
+    void clear();
+
+    /// Number of registered targets
+    int size() const { return static_cast<int>(mNames.size()); }
+
+    /// Target ID of a Vuforia observer ID, INVALID_ID if unknown
+    int findByObserverId(int32_t observerId) const
+    {
+        if (observerId < 0 || observerId >= static_cast<int32_t>(mIdByObserverId.size()))
+            return INVALID_ID;
+        return mIdByObserverId[observerId];
+    }
+
+    /// Target ID of a target name, INVALID_ID if unknown. Linear, not meant for per-frame use.
+    int findByName(const char* name) const;
+
+    /// Accessors, id must be in 0..size()-1
+    const std::string& name(int id) const { return mNames[id]; }
+    const std::string& uniqueId(int id) const { return mUniqueIds[id]; }
+    const glm::vec2& targetSize(int id) const { return mTargetSizes[id]; }
+
+private:
+    std::vector<std::string> mNames;
+    std::vector<std::string> mUniqueIds;
+    std::vector<glm::vec2> mTargetSizes;
+    /* Vuforiaのobserver ID → ターゲットID (observer IDは小さな連番なので直接引く) */
+    std::vector<int> mIdByObserverId;
+};
+
+#endif // __TARGETREGISTRY_H__
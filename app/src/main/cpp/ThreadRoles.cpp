@@ -0,0 +1,286 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "ThreadRoles.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include <dirent.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+namespace
+{
+/* Androidの THREAD_PRIORITY_URGENT_DISPLAY / DISPLAY / DEFAULT / BACKGROUND と同じ値 */
+constexpr int RENDER_NICE = -8;
+constexpr int TRACKING_NICE = -4;
+constexpr int WORKER_NICE = 0;
+constexpr int BACKGROUND_NICE = 10;
+
+struct RoleEntry
+{
+    int32_t tid;
+    ThreadRole role;
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    RoleEntry entries[ThreadRoles::MAX_THREADS];
+    int numEntries{ 0 };
+};
+
+Registry&
+getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+thread_local ThreadRole tRole = ThreadRole::COUNT;
+
+/* 失敗は役割ごとに一度だけログに出す(ワーカーの数だけ同じ行が並ばないように) */
+std::atomic<uint32_t> gLoggedFailures{ 0 };
+
+void
+logFailureOnce(ThreadRole role, const char* what, int error)
+{
+    const uint32_t bit = 1u << static_cast<int>(role);
+    if ((gLoggedFailures.fetch_or(bit, std::memory_order_relaxed) & bit) == 0)
+        LOG("ThreadRoles: %s of %s failed: %s", what, ThreadRoles::getName(role), strerror(error));
+}
+
+bool
+isThreadAlive(int32_t tid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d", tid);
+    return access(path, F_OK) == 0;
+}
+
+/// utime + stime of a thread of this process in clock ticks, false if it is gone
+bool
+readThreadCpuTicks(int32_t tid, uint64_t& ticks)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%d/stat", tid);
+    FILE* file = fopen(path, "r");
+    if (file == nullptr)
+        return false;
+    char line[512];
+    const bool read = fgets(line, sizeof(line), file) != nullptr;
+    fclose(file);
+    if (!read)
+        return false;
+
+    /* comm は空白や括弧を含みうるので、最後の ')' の後から数える。その次が3番目(state)、utime/stime は14/15番目 */
+    const char* cursor = strrchr(line, ')');
+    if (cursor == nullptr)
+        return false;
+    cursor++;
+    for (int field = 3; field < 14; field++)
+    {
+        cursor = strchr(cursor + 1, ' ');
+        if (cursor == nullptr)
+            return false;
+    }
+    char* end;
+    const uint64_t utime = strtoull(cursor, &end, 10);
+    const uint64_t stime = strtoull(end, nullptr, 10);
+    ticks = utime + stime;
+    return true;
+}
+}
+
+
+ThreadRoles::Policy
+ThreadRoles::getDefaultPolicy(ThreadRole role, const CpuTopology& topology)
+{
+    const uint64_t allCpus = topology.bigCpuMask | topology.littleCpuMask;
+    /* 小コアがなければ、バックグラウンドも全コアで優先度だけ下げる */
+    const uint64_t littleCpus = topology.littleCpuMask != 0 ? topology.littleCpuMask : allCpus;
+
+    Policy policy;
+    switch (role)
+    {
+        case ThreadRole::RENDER:
+            policy.cpuMask = topology.bigCpuMask;
+            policy.nice = RENDER_NICE;
+            break;
+        case ThreadRole::TRACKING:
+            policy.cpuMask = topology.bigCpuMask;
+            policy.nice = TRACKING_NICE;
+            break;
+        case ThreadRole::WORKER:
+            policy.cpuMask = allCpus;
+            policy.nice = WORKER_NICE;
+            break;
+        case ThreadRole::BACKGROUND:
+        default:
+            policy.cpuMask = littleCpus;
+            policy.nice = BACKGROUND_NICE;
+            break;
+    }
+    return policy;
+}
+
+
+bool
+ThreadRoles::assign(ThreadRole role)
+{
+    return assign(role, getDefaultPolicy(role));
+}
+
+
+bool
+ThreadRoles::assign(ThreadRole role, const Policy& policy)
+{
+    const int32_t tid = static_cast<int32_t>(syscall(SYS_gettid));
+    bool result = true;
+
+    if (policy.cpuMask != 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; cpu < CpuTopology::MAX_CPUS; cpu++)
+        {
+            if (policy.cpuMask & (1ULL << cpu))
+                CPU_SET(cpu, &cpus);
+        }
+        if (sched_setaffinity(tid, sizeof(cpus), &cpus) != 0)
+        {
+            logFailureOnce(role, "sched_setaffinity", errno);
+            result = false;
+        }
+    }
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), policy.nice) != 0)
+    {
+        logFailureOnce(role, "setpriority", errno);
+        result = false;
+    }
+
+    tRole = role;
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (int idx = 0; idx < registry.numEntries; idx++)
+    {
+        if (registry.entries[idx].tid == tid)
+        {
+            registry.entries[idx].role = role;
+            return result;
+        }
+    }
+    if (registry.numEntries == MAX_THREADS)
+    {
+        /* 終了したスレッドの分を詰める(tidは再利用されるので残しておくと取り違える) */
+        int kept = 0;
+        for (int idx = 0; idx < registry.numEntries; idx++)
+        {
+            if (isThreadAlive(registry.entries[idx].tid))
+                registry.entries[kept++] = registry.entries[idx];
+        }
+        registry.numEntries = kept;
+    }
+    if (registry.numEntries < MAX_THREADS)
+        registry.entries[registry.numEntries++] = RoleEntry{ tid, role };
+    return result;
+}
+
+
+ThreadRole
+ThreadRoles::getCurrentRole()
+{
+    return tRole;
+}
+
+
+void
+ThreadRoles::getUsage(Usage (&usage)[ROLE_COUNT + 1])
+{
+    for (Usage& roleUsage : usage)
+        roleUsage = Usage();
+
+    RoleEntry entries[MAX_THREADS];
+    int numEntries;
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::copy(registry.entries, registry.entries + registry.numEntries, entries);
+        numEntries = registry.numEntries;
+    }
+
+    DIR* tasks = opendir("/proc/self/task");
+    if (tasks == nullptr)
+        return;
+    const double secondsPerTick = 1.0 / static_cast<double>(sysconf(_SC_CLK_TCK));
+    while (const dirent* task = readdir(tasks))
+    {
+        if (task->d_name[0] < '0' || task->d_name[0] > '9')
+            continue;
+        const int32_t tid = static_cast<int32_t>(atoi(task->d_name));
+        uint64_t ticks;
+        if (!readThreadCpuTicks(tid, ticks))
+            continue;
+
+        int role = OTHER_ROLE;
+        for (int idx = 0; idx < numEntries; idx++)
+        {
+            if (entries[idx].tid == tid)
+            {
+                role = static_cast<int>(entries[idx].role);
+                break;
+            }
+        }
+        usage[role].numThreads++;
+        usage[role].cpuSeconds += static_cast<double>(ticks) * secondsPerTick;
+    }
+    closedir(tasks);
+}
+
+
+std::string
+ThreadRoles::formatUsage()
+{
+    Usage usage[ROLE_COUNT + 1];
+    getUsage(usage);
+
+    std::string text = "# role threads cpu_s\n";
+    char line[96];
+    for (int role = 0; role <= ROLE_COUNT; role++)
+    {
+        snprintf(line, sizeof(line), "%-10s %7d %8.2f\n", role == OTHER_ROLE ? "other" : getName(static_cast<ThreadRole>(role)),
+                 usage[role].numThreads, usage[role].cpuSeconds);
+        text += line;
+    }
+    return text;
+}
+
+
+const char*
+ThreadRoles::getName(ThreadRole role)
+{
+    switch (role)
+    {
+        case ThreadRole::RENDER:
+            return "render";
+        case ThreadRole::TRACKING:
+            return "tracking";
+        case ThreadRole::WORKER:
+            return "worker";
+        case ThreadRole::BACKGROUND:
+            return "background";
+        default:
+            return "none";
+    }
+}
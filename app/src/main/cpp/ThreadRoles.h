@@ -0,0 +1,106 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __THREADROLES_H__
+#define __THREADROLES_H__
+
+#include "CpuTopology.h"
+
+#include <cstdint>
+#include <string>
+
+/// What a native thread is for, which decides its cores and its priority
+enum class ThreadRole : uint8_t
+{
+    /// GL thread: draws every frame, must not be preempted
+    RENDER,
+    /// TrackingThread: pose computation for the next frame
+    TRACKING,
+    /// JobSystem workers: startup and on-demand work the frame may wait for
+    WORKER,
+    /// Work nobody waits for (file output, prefetching)
+    BACKGROUND,
+    COUNT
+};
+
+/// Pins native threads to core clusters by role, sets their nice value and reports CPU time per role
+/**
+ * assign() applies the policy of a role to the calling thread with sched_setaffinity and setpriority
+ * and remembers its thread id. The default policies (getDefaultPolicy) keep the render and tracking
+ * threads on the big cores at a raised priority, let the workers run anywhere at the normal priority,
+ * and move the background threads to the little cores at a lowered one, so that Kotlin coroutines and
+ * the decoder threads of the player compete with the frame less. On a single cluster every mask is all
+ * cores and only the priorities differ.
+ *
+ * getUsage() sums utime + stime of /proc/self/task per role (threads without a role as OTHER_ROLE), for
+ * the threads alive at the time of the call.
+ */
+class ThreadRoles
+{
+public:
+    static constexpr int ROLE_COUNT = static_cast<int>(ThreadRole::COUNT);
+    /// Index of the threads without a role in the usage array
+    static constexpr int OTHER_ROLE = ROLE_COUNT;
+    /// Threads with a role that are remembered, more are still pinned but counted as other
+    static constexpr int MAX_THREADS = 64;
+
+    struct Policy
+    {
+        /// Bit n for CPU n, 0 to leave the affinity alone
+        uint64_t cpuMask{ 0 };
+        /// setpriority value (-20 highest to 19 lowest), Android THREAD_PRIORITY_* scale
+        int nice{ 0 };
+    };
+
+    struct Usage
+    {
+        int numThreads{ 0 };
+        /// utime + stime (s)
+        double cpuSeconds{ 0.0 };
+    };
+
+    /// Gives the calling thread a role until the end of the scope, e.g. a worker running a background job
+    class Scope
+    {
+    public:
+        explicit Scope(ThreadRole role) : mPrevious(getCurrentRole()) { assign(role); }
+        ~Scope()
+        {
+            if (mPrevious != ThreadRole::COUNT)
+                assign(mPrevious);
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ThreadRole mPrevious;
+    };
+
+    /// Policy of role on the given cores
+    static Policy getDefaultPolicy(ThreadRole role, const CpuTopology& topology = CpuTopology::get());
+
+    /// Apply the default policy of role to the calling thread, false if the affinity or the priority could not be set
+    /**
+     * A failure is logged once per role and leaves the thread as it was for that part: a raised
+     * priority needs CAP_SYS_NICE on a Linux host, Android allows it down to the display priorities.
+     */
+    static bool assign(ThreadRole role);
+
+    /// assign() with an explicit policy
+    static bool assign(ThreadRole role, const Policy& policy);
+
+    /// Role given to the calling thread, COUNT if none
+    static ThreadRole getCurrentRole();
+
+    /// CPU time of the live threads per role, usage[OTHER_ROLE] for the threads without one
+    static void getUsage(Usage (&usage)[ROLE_COUNT + 1]);
+
+    /// getUsage() as a text table, one line per role
+    static std::string formatUsage();
+
+    static const char* getName(ThreadRole role);
+};
+
+#endif // __THREADROLES_H__
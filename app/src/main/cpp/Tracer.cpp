@@ -0,0 +1,192 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "Tracer.h"
+
+#if defined(VPB_ENABLE_TRACING)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+struct Event
+{
+    const char* name;
+    int64_t start;
+    int64_t duration;
+    int32_t id;
+};
+
+/* スレッドごとのリングバッファ。書くのは持ち主のスレッドだけ */
+struct ThreadBuffer
+{
+    Event events[Tracer::EVENTS_PER_THREAD];
+    /// Number of events written since the buffer was claimed, published with release
+    std::atomic<uint64_t> head{ 0 };
+    std::atomic<const char*> threadName{ nullptr };
+    int32_t tid{ 0 };
+    /// False once the owning thread has exited, the buffer is then reused by the next new thread
+    bool inUse{ false };
+};
+
+/// Buffers of all threads that traced, never freed so that writeChromeTrace can read them at any time
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<ThreadBuffer*> buffers;
+};
+
+Registry&
+getRegistry()
+{
+    /* 終了時の破棄順に左右されないよう解放しない */
+    static Registry* registry = new Registry();
+    return *registry;
+}
+
+/// Claims a buffer for the thread on first use and hands it back when the thread exits
+struct ThreadBufferHolder
+{
+    ThreadBuffer* buffer{ nullptr };
+
+    ThreadBuffer* get()
+    {
+        if (buffer == nullptr)
+            buffer = claim();
+        return buffer;
+    }
+
+    ~ThreadBufferHolder()
+    {
+        if (buffer == nullptr)
+            return;
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        buffer->inUse = false;
+    }
+
+    static ThreadBuffer* claim()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        ThreadBuffer* claimed = nullptr;
+        for (ThreadBuffer* candidate : registry.buffers)
+        {
+            if (!candidate->inUse)
+            {
+                claimed = candidate;
+                break;
+            }
+        }
+        if (claimed == nullptr)
+        {
+            claimed = new ThreadBuffer();
+            registry.buffers.push_back(claimed);
+        }
+
+        /* 書き出しも同じロックで読むので、ここで前の持ち主のイベントを捨てて良い */
+        claimed->head.store(0, std::memory_order_relaxed);
+        claimed->threadName.store(nullptr, std::memory_order_relaxed);
+        claimed->tid = static_cast<int32_t>(syscall(SYS_gettid));
+        claimed->inUse = true;
+        return claimed;
+    }
+};
+
+thread_local ThreadBufferHolder tBuffer;
+
+/// Copy the events still in buffer that were not overwritten while copying, oldest first
+void
+copyEvents(const ThreadBuffer& buffer, std::vector<Event>& events)
+{
+    const uint64_t head = buffer.head.load(std::memory_order_acquire);
+    const uint64_t first = head > Tracer::EVENTS_PER_THREAD ? head - Tracer::EVENTS_PER_THREAD : 0;
+    events.clear();
+    for (uint64_t index = first; index < head; index++)
+        events.push_back(buffer.events[index % Tracer::EVENTS_PER_THREAD]);
+
+    /* コピー中に持ち主が上書きし始めた分は壊れている可能性があるので捨てる */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t headAfter = buffer.head.load(std::memory_order_relaxed);
+    const uint64_t firstIntact = headAfter >= Tracer::EVENTS_PER_THREAD ? headAfter - Tracer::EVENTS_PER_THREAD + 1 : 0;
+    if (firstIntact > first)
+        events.erase(events.begin(), events.begin() + std::min<uint64_t>(firstIntact - first, events.size()));
+}
+}
+
+
+void
+Tracer::setThreadName(const char* name)
+{
+    tBuffer.get()->threadName.store(name, std::memory_order_relaxed);
+}
+
+
+bool
+Tracer::writeChromeTrace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (file == nullptr)
+        return false;
+
+    const int pid = static_cast<int>(getpid());
+    std::vector<Event> events;
+    events.reserve(EVENTS_PER_THREAD);
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    Registry& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const ThreadBuffer* buffer : registry.buffers)
+    {
+        if (const char* threadName = buffer->threadName.load(std::memory_order_relaxed))
+        {
+            fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",", pid, buffer->tid, threadName);
+            first = false;
+        }
+
+        copyEvents(*buffer, events);
+        for (const Event& event : events)
+        {
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f", first ? "" : ",",
+                    event.name, pid, buffer->tid, static_cast<double>(event.start) * 1e-3, static_cast<double>(event.duration) * 1e-3);
+            if (event.id != TraceScope::NO_ID)
+                fprintf(file, ",\"args\":{\"id\":%d}", event.id);
+            fprintf(file, "}");
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    const bool ok = ferror(file) == 0;
+    return fclose(file) == 0 && ok;
+}
+
+
+void
+Tracer::recordEvent(const char* name, int64_t start, int64_t end, int32_t id)
+{
+    ThreadBuffer* buffer = tBuffer.get();
+    const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head % EVENTS_PER_THREAD] = Event{ name, start, end - start, id };
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+
+int64_t
+Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // VPB_ENABLE_TRACING
@@ -0,0 +1,92 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __TRACER_H__
+#define __TRACER_H__
+
+#include <cstdint>
+
+/// Opt-in scoped trace events written as a Chrome / Perfetto JSON trace (configure with -DVPB_ENABLE_TRACING=ON)
+/**
+ * VPB_TRACE_SCOPE(name) records a complete event from the macro to the end of the enclosing scope,
+ * VPB_TRACE_SCOPE_ID(name, id) also records an integer argument (e.g. the target ID). name must be a
+ * string literal, only the pointer is stored. Each thread appends its events to its own ring of
+ * Tracer::EVENTS_PER_THREAD events without locking; Tracer::writeChromeTrace() copies the rings of all
+ * threads on demand and writes the events still in them, so a trace holds the last few seconds.
+ *
+ * Without VPB_ENABLE_TRACING (release builds) the macros expand to nothing and writeChromeTrace() only
+ * returns false, so the instrumentation can stay in the shipping code.
+ */
+
+#if defined(VPB_ENABLE_TRACING)
+
+class Tracer
+{
+public:
+    static constexpr int EVENTS_PER_THREAD = 8192;
+
+    /// Name shown for the calling thread in the trace, a string literal
+    static void setThreadName(const char* name);
+
+    /// Write the events of all threads to path as Chrome trace JSON, false on an I/O error
+    static bool writeChromeTrace(const char* path);
+
+    /// Record a complete event of the calling thread (times in steady_clock ns)
+    static void recordEvent(const char* name, int64_t start, int64_t end, int32_t id);
+
+    /// steady_clock time in ns
+    static int64_t now();
+};
+
+/// Records an event from construction to destruction, used by VPB_TRACE_SCOPE
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name, int32_t id = NO_ID) : mName(name), mId(id), mStart(Tracer::now()) {}
+    ~TraceScope() { Tracer::recordEvent(mName, mStart, Tracer::now(), mId); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    /// id of events without an argument
+    static constexpr int32_t NO_ID = INT32_MIN;
+
+private:
+    const char* mName;
+    int32_t mId;
+    int64_t mStart;
+};
+
+#define VPB_TRACE_CONCAT_INNER(a, b) a##b
+#define VPB_TRACE_CONCAT(a, b) VPB_TRACE_CONCAT_INNER(a, b)
+#define VPB_TRACE_SCOPE(name) TraceScope VPB_TRACE_CONCAT(vpbTraceScope, __LINE__)(name)
+#define VPB_TRACE_SCOPE_ID(name, id) TraceScope VPB_TRACE_CONCAT(vpbTraceScope, __LINE__)(name, static_cast<int32_t>(id))
+#define VPB_TRACE_THREAD_NAME(name) Tracer::setThreadName(name)
+
+#else
+
+class Tracer
+{
+public:
+    static bool writeChromeTrace(const char*) { return false; }
+};
+
+#define VPB_TRACE_SCOPE(name)
+#define VPB_TRACE_SCOPE_ID(name, id)
+#define VPB_TRACE_THREAD_NAME(name)
+
+#endif
+
+/// Whether trace events are compiled in
+constexpr bool
+isTracingEnabled()
+{
+#if defined(VPB_ENABLE_TRACING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#endif // __TRACER_H__
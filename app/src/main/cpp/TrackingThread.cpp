@@ -0,0 +1,75 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "TrackingThread.h"
+
+#include "Log.h"
+#include "ThreadRoles.h"
+#include "Tracer.h"
+
+
+void
+TrackingThread::start(AppController& controller)
+{
+    std::lock_guard<std::mutex> lock(mReaderMutex);
+    if (mRunning)
+    {
+        return;
+    }
+
+    mController = &controller;
+    mStopRequested.store(false, std::memory_order_relaxed);
+    mPublishedFrames.store(0, std::memory_order_relaxed);
+    mThread = std::thread(&TrackingThread::run, this);
+    mRunning = true;
+    LOG("Tracking thread started");
+}
+
+
+void
+TrackingThread::stop()
+{
+    std::lock_guard<std::mutex> lock(mReaderMutex);
+    if (!mRunning)
+    {
+        return;
+    }
+
+    mStopRequested.store(true, std::memory_order_relaxed);
+    mThread.join();
+    mRunning = false;
+
+    /* ワーカーも描画スレッドも触っていないので、3面すべての状態を解放できる */
+    mFrames.forEachBuffer([this](AppController::TrackingFrame& frame) { mController->releaseTrackingFrame(frame); });
+    LOG("Tracking thread stopped after %llu frames", static_cast<unsigned long long>(getPublishedFrames()));
+}
+
+
+bool
+TrackingThread::isRunning()
+{
+    std::lock_guard<std::mutex> lock(mReaderMutex);
+    return mRunning;
+}
+
+
+void
+TrackingThread::run()
+{
+    VPB_TRACE_THREAD_NAME("TrackingThread");
+    ThreadRoles::assign(ThreadRole::TRACKING);
+    int64_t lastCameraFrameIndex = -1;
+    while (!mStopRequested.load(std::memory_order_relaxed))
+    {
+        /* 書き込み面は読み手が手放した面なので、前の状態を解放して詰め直してよい(同じカメラフレームなら触らない) */
+        AppController::TrackingFrame& frame = mFrames.writeBuffer();
+        if (mController->updateTrackingFrameIfNew(frame, lastCameraFrameIndex))
+        {
+            lastCameraFrameIndex = frame.cameraFrameIndex;
+            mFrames.publish();
+            mPublishedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+}
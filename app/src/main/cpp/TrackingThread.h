@@ -0,0 +1,79 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __TRACKINGTHREAD_H__
+#define __TRACKINGTHREAD_H__
+
+#include "AppController.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+/// Computes the target poses on a worker thread, off the render thread's critical path
+/**
+ * The worker polls AppController::updateTrackingFrameIfNew, which releases a repeated camera frame
+ * right after reading its index and, for every new camera frame, computes the frame (observation
+ * iteration, target lookups, pose math, device pose and relocalization timer) into a triple buffer. The render thread only takes the newest frame
+ * through a Reader and draws it, updating the video background from the state held by that frame.
+ *
+ * The triple buffer hand-over is wait-free. The Reader also holds a mutex that is only contended
+ * while stop() runs, so that stop() never releases a state the render thread is still drawing.
+ */
+class TrackingThread
+{
+public:
+    /// Delay between two polls of the engine state
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{ 2 };
+
+    /// Render thread access to the latest frame, valid for the lifetime of the Reader
+    class Reader
+    {
+    public:
+        explicit Reader(TrackingThread& thread)
+            : mLock(thread.mReaderMutex), mFrame(thread.mRunning ? &thread.mFrames.read() : nullptr)
+        {
+        }
+
+        /// The latest published frame, nullptr if the thread is not running.
+        /// frame()->state is nullptr until the first camera frame has been published.
+        const AppController::TrackingFrame* frame() const { return mFrame; }
+
+    private:
+        std::lock_guard<std::mutex> mLock;
+        const AppController::TrackingFrame* mFrame;
+    };
+
+    ~TrackingThread() { stop(); }
+
+    /// Start the worker. The AR session must be started and stay started until stop().
+    void start(AppController& controller);
+
+    /// Stop the worker and release the states held by the frames. Call before AppController::stopAR.
+    void stop();
+
+    /// Whether the worker is running
+    bool isRunning();
+
+    /// Number of frames published since start()
+    uint64_t getPublishedFrames() const { return mPublishedFrames.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    AppController* mController{ nullptr };
+    TripleBuffer<AppController::TrackingFrame> mFrames;
+    std::thread mThread;
+    std::atomic<bool> mStopRequested{ false };
+    std::atomic<uint64_t> mPublishedFrames{ 0 };
+
+    /// Guards mRunning and the frame the Reader looks at against stop()
+    std::mutex mReaderMutex;
+    bool mRunning{ false };
+};
+
+#endif // __TRACKINGTHREAD_H__
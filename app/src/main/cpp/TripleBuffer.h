@@ -0,0 +1,66 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __TRIPLEBUFFER_H__
+#define __TRIPLEBUFFER_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/// Wait-free single writer / single reader hand-over of the latest value
+/**
+ * The writer fills writeBuffer() and calls publish(), the reader calls read() and gets the most
+ * recently published value. Neither side ever blocks or retries: the three buffers are exchanged
+ * with a single atomic swap of the "middle" index. Values published while the reader is not looking
+ * are simply overwritten, so the reader always sees a complete, consistent value (or the initial one).
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    /// Writer side: the buffer to fill before the next publish()
+    T& writeBuffer() { return mBuffers[mWriteIndex]; }
+
+    /// Writer side: make writeBuffer() the latest value
+    void publish()
+    {
+        mWriteIndex = mMiddle.exchange(mWriteIndex | DIRTY_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /// Reader side: the latest published value, valid until the next read() call
+    const T& read()
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & DIRTY_BIT) != 0)
+        {
+            mReadIndex = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return mBuffers[mReadIndex];
+    }
+
+    /// Reader side: whether a value was published since the last read()
+    bool hasNewValue() const { return (mMiddle.load(std::memory_order_relaxed) & DIRTY_BIT) != 0; }
+
+    /// Apply f to all three buffers, e.g. to release what they hold. Neither side may be active.
+    template<typename F>
+    void forEachBuffer(F&& f)
+    {
+        for (T& buffer : mBuffers)
+        {
+            f(buffer);
+        }
+    }
+
+private:
+    static constexpr uint32_t INDEX_MASK = 0x3;
+    static constexpr uint32_t DIRTY_BIT = 0x4;
+
+    std::array<T, 3> mBuffers{};
+    /* 書き手と読み手が別々のキャッシュラインを触るように分けておく */
+    alignas(64) std::atomic<uint32_t> mMiddle{ 1 };
+    alignas(64) uint32_t mWriteIndex{ 0 };
+    alignas(64) uint32_t mReadIndex{ 2 };
+};
+
+#endif // __TRIPLEBUFFER_H__
@@ -0,0 +1,31 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __VUFORIAMATH_H__
+#define __VUFORIAMATH_H__
+
+#include "SimdMath.h"
+
+#include <VuforiaEngine/VuforiaEngine.h>
+
+/// Inline replacements for the engine's vuMatrix44FMultiplyMatrix / vuMatrix44FScale (same argument order)
+
+inline VuMatrix44F
+multiplyMatrix(const VuMatrix44F& a, const VuMatrix44F& b)
+{
+    VuMatrix44F result;
+    multiplyMatrix44(a.data, b.data, result.data);
+    return result;
+}
+
+
+inline VuMatrix44F
+scaleMatrix(const VuVector3F& scale, const VuMatrix44F& m)
+{
+    VuMatrix44F result;
+    scaleMatrix44(m.data, scale.data[0], scale.data[1], scale.data[2], result.data);
+    return result;
+}
+
+#endif // __VUFORIAMATH_H__
@@ -8,20 +8,35 @@ countries.
 #include <jni.h>
 
 #include "GLESRenderer.h"
+#include "AllocationTracker.h"
+#include "AndroidAssetSource.h"
 #include "AppController.h"
+#include "FrameLoop.h"
+#include "FrameMetrics.h"
+#include "FrameResult.h"
+#include "HitTest.h"
+#include "InitPipeline.h"
+#include "JobSystem.h"
+#include "LatencyStats.h"
 #include "Log.h"
+#include "StartupTimeline.h"
+#include "ThreadRoles.h"
+#include "Tracer.h"
+#include "TrackingThread.h"
 
 #include "VuforiaEngine/VuforiaEngine.h"
 
 #include <GLES3/gl31.h>
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
+#include <android/imagedecoder.h>
 #include <android/log.h>
 
 #include <cassert>
 #include <chrono>
 #include <mutex>
 #include <optional>
+#include <string>
 #include <vector>
 
 // Cross-platform AppController providing high level Vuforia Engine operations
@@ -41,17 +56,139 @@ struct
 
     GLESRenderer renderer;
 
+    // Computes the target poses off the render thread when enabled with setTrackingThreadEnabled
+    TrackingThread trackingThread;
+    bool useTrackingThread = false;
+
+    // Metrics block mapped by Kotlin (getMetricsBuffer) and its writer
+    FrameMetrics metrics{};
+    FrameMetricsRecorder metricsRecorder{ metrics };
+
+    // Workers for the background work: startup asset reads, parsing and decoding, trace output
+    JobSystem jobs;
+    // Cold start phases, and the startup CPU work run on the jobs while the engine is created
+    StartupTimeline startupTimeline;
+    InitPipeline initPipeline{ startupTimeline, jobs };
+    // The results of initPipeline are in the textures and buffers of the current GL context
+    bool startupAssetsUploaded = false;
+
+    // Frame bookkeeping shared with vpb_replay: latency stats, HUD, hit test quads and the frame arena
+    FrameLoop frameLoop{ controller, trackingThread, metricsRecorder, &startupTimeline };
+    // Frames that allocated on the heap after the warm-up (only counted with VPB_TRACK_ALLOCATIONS)
+    int allocatingFrames = 0;
+
     bool usingARCore{ false };
 } gWrapperData;
 
-bool checkPolygonHit(const glm::vec2& targetPoint, const std::array<glm::vec2, 4>& ndcQuadPoints);
-
 // Provider pointers that allow for interacting with ARCore
 std::optional<VuPlatformARCoreInfo> gARCoreInfo{};
 
 // Mutex protecting access to the provider pointers in gARCoreInfo
 std::mutex gARCoreInfoMutex;
 
+// Frames rendered before steady-state allocations are reported, and the log interval after that
+constexpr int ALLOCATION_WARMUP_FRAMES = 60;
+constexpr int ALLOCATION_LOG_INTERVAL = 300;
+
+// Per-frame result buffer registered by setFrameResultBuffer, owned by Kotlin
+FrameResult* gFrameResult = nullptr;
+// Global reference keeping the direct ByteBuffer behind gFrameResult alive
+jobject gFrameResultBuffer = nullptr;
+
+
+/// Decode a PNG or JPEG to RGBA (premultiplied like the BitmapFactory bitmaps used before), on an InitPipeline worker
+static bool
+decodeImage(const AssetBuffer& encoded, InitPipeline::Image& image)
+{
+    AImageDecoder* decoder = nullptr;
+    if (AImageDecoder_createFromBuffer(encoded.data(), encoded.size(), &decoder) != ANDROID_IMAGE_DECODER_SUCCESS)
+    {
+        LOG("Error creating the image decoder");
+        return false;
+    }
+    AImageDecoder_setAndroidBitmapFormat(decoder, ANDROID_BITMAP_FORMAT_RGBA_8888);
+    const AImageDecoderHeaderInfo* header = AImageDecoder_getHeaderInfo(decoder);
+    image.width = AImageDecoderHeaderInfo_getWidth(header);
+    image.height = AImageDecoderHeaderInfo_getHeight(header);
+    const size_t stride = static_cast<size_t>(image.width) * 4;
+    image.pixels.resize(stride * image.height);
+    const int result = AImageDecoder_decodeImage(decoder, image.pixels.data(), stride, image.pixels.size());
+    AImageDecoder_delete(decoder);
+    if (result != ANDROID_IMAGE_DECODER_SUCCESS)
+    {
+        LOG("Error decoding an image: %d", result);
+        return false;
+    }
+    return true;
+}
+
+
+/// Start the InitPipeline on the assets of assetManager (the first call wins)
+static void
+startInitPipeline(AAssetManager* assetManager)
+{
+    if (gWrapperData.initPipeline.isStarted())
+        return;
+
+    InitPipeline::Platform platform;
+    platform.assets = std::make_shared<AndroidAssetSource>(assetManager);
+    platform.decodeImage = decodeImage;
+    gWrapperData.initPipeline.start(platform);
+}
+
+
+/// GL thread: upload the InitPipeline results into the current context, waiting for them if needed
+static void
+uploadStartupAssets()
+{
+    StartupTimeline::Scope phase(gWrapperData.startupTimeline, "upload startup assets");
+    if (!gWrapperData.renderer.uploadStartupAssets(gWrapperData.initPipeline))
+        LOG("Failed to load the startup assets");
+    /* 失敗しても毎フレームやり直さない */
+    gWrapperData.startupAssetsUploaded = true;
+}
+
+
+/// Render one frame: video background, then the video on the playing target and the pause image on the others
+/**
+ * Shared by the renderFrame and renderFrameIds JNI entries. The frame itself is FrameLoop::renderFrame, the same
+ * code vpb_replay runs on the host; this only adds the device side around it.
+ * nowPlayingId is the target the video is played on, NO_TARGET_ID to start playing on the first tracked target.
+ * The tracked targets are written to result.
+ * @return the target the video was rendered on, NO_TARGET_ID if it is not tracked.
+ */
+static int32_t
+renderFrameInternal(int32_t nowPlayingId, FrameResult& result)
+{
+    /* initRenderingの時点で間に合わなかった起動時のアセットは、描く前に待って転送する */
+    if (!gWrapperData.startupAssetsUploaded)
+        uploadStartupAssets();
+
+    const int32_t playingId = gWrapperData.frameLoop.renderFrame(gWrapperData.renderer, nowPlayingId, result);
+
+    /* ウォームアップ後に確保したフレームは間引いてログに出す(トラッキング無効時は何もしない) */
+    const AllocationCounts& allocations = gWrapperData.frameLoop.getFrameAllocations();
+    if (allocations.allocations != 0 && result.frameCount > ALLOCATION_WARMUP_FRAMES &&
+        gWrapperData.allocatingFrames++ % ALLOCATION_LOG_INTERVAL == 0)
+    {
+        LOG("Frame %d allocated %llu times (%llu bytes)", result.frameCount,
+            static_cast<unsigned long long>(allocations.allocations), static_cast<unsigned long long>(allocations.bytes));
+    }
+    return playingId;
+}
+
+
+/// Hit test a touch point in NDC against the targets of the last rendered frame, timed into the metrics block
+static bool
+hitTestTouch(const glm::vec2& touchPoint, RayHitTester::Hit& hit)
+{
+    AllocationScope allocationScope(AllocationTag::CHECK_HIT);
+    const int64_t start = LatencyStats::now();
+    const bool isHit = gWrapperData.frameLoop.getHitTester().hitTest(touchPoint, hit);
+    gWrapperData.metricsRecorder.recordHitTest(LatencyStats::now() - start);
+    return isHit;
+}
+
 
 // JNI Implementation
 #ifdef __cplusplus
@@ -108,6 +245,8 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_initAR(JNIEnv *env, jclass claz,
                                                               jobject activity,
                                                               jobject assetManager,
                                                               jint target) {
+    VPB_TRACE_SCOPE("JNI initAR");
+    StartupTimeline::Scope phase(gWrapperData.startupTimeline, "initAR");
     // Store the Java VM pointer so we can get a JNIEnv in callbacks
     if (env->GetJavaVM(&gWrapperData.vm) != 0)
     {
@@ -122,6 +261,7 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_initAR(JNIEnv *env, jclass claz,
     AppController::InitConfig initConfig;
     initConfig.vbRenderBackend = VuRenderVBBackendType::VU_RENDER_VB_BACKEND_GLES3;
     initConfig.appData = activity;
+    initConfig.timeline = &gWrapperData.startupTimeline;
 
     // Setup callbacks
     initConfig.errorMessageCallback = [](const char* errorString) {
@@ -174,6 +314,8 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_initAR(JNIEnv *env, jclass claz,
         initConfig.errorMessageCallback("Error: Failed to get the asset manager");
         return;
     }
+    /* startInitPipelineが呼ばれていなければここで始める(エンジン生成とは並行) */
+    startInitPipeline(gWrapperData.assetManager);
 
     // Start Vuforia initialization
     controller.initAR(initConfig, target);
@@ -182,6 +324,7 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_initAR(JNIEnv *env, jclass claz,
 
 JNIEXPORT jboolean JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_startAR(JNIEnv *env, jclass clazz) {
+    VPB_TRACE_SCOPE("JNI startAR");
     // Update usingARCore flag to avoid checking this every frame
     auto platformController = controller.getPlatformController();
     assert(platformController);
@@ -195,6 +338,11 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_startAR(JNIEnv *env, jclass clazz)
         return JNI_FALSE;
     }
 
+    if (gWrapperData.useTrackingThread)
+    {
+        gWrapperData.trackingThread.start(controller);
+    }
+
     if (gWrapperData.usingARCore)
     {
         if (!getFusionProviderPointers())
@@ -210,12 +358,17 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_startAR(JNIEnv *env, jclass clazz)
 
 JNIEXPORT void JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_stopAR(JNIEnv *env, jclass clazz) {
+    VPB_TRACE_SCOPE("JNI stopAR");
+    /* トラッキングスレッドが持っている状態をエンジン停止前に解放する */
+    gWrapperData.trackingThread.stop();
     controller.stopAR();
 }
 
 
 JNIEXPORT void JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_deinitAR(JNIEnv *env, jclass clazz) {
+    VPB_TRACE_SCOPE("JNI deinitAR");
+    gWrapperData.trackingThread.stop();
     controller.deinitAR();
 
     gWrapperData.assetManager = nullptr;
@@ -238,27 +391,23 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_cameraRestoreAutoFocus(JNIEnv *env,
 
 JNIEXPORT void JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_initRendering(JNIEnv *env, jclass clazz) {
+    VPB_TRACE_SCOPE("JNI initRendering");
+    VPB_TRACE_THREAD_NAME("GLThread");
+    /* GLSurfaceViewのGLスレッドは作り直されうるので、初期化のたびに役割を付ける */
+    ThreadRoles::assign(ThreadRole::RENDER);
+    StartupTimeline::Scope phase(gWrapperData.startupTimeline, "initRendering");
     // Define clear color
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
 
-    if (!gWrapperData.renderer.init(gWrapperData.assetManager))
+    if (!gWrapperData.renderer.init())
     {
         __android_log_print(ANDROID_LOG_ERROR, "aaaaa", "Error initialising renderer");
     }
-}
-
-
-JNIEXPORT void JNICALL
-Java_com_tks_videophotobook_VuforiaWrapperKt_setTextures(JNIEnv *env, jclass clazz,
-                                                        jint astronautWidth, jint astronautHeight, jobject astronautByteBuffer,
-                                                        jint pauseWidth, jint pauseHeight, jobject pauseByteBuffer) {
-    // Textures are loaded using the BitmapFactory which isn't available from the NDK.
-    // They are loaded in the Kotlin code and passed to this method to create GLES textures.
-    auto astronautBytes = static_cast<unsigned char*>(env->GetDirectBufferAddress(astronautByteBuffer));
-    gWrapperData.renderer.setAstronautTexture(astronautWidth, astronautHeight, astronautBytes);
-    auto pauseBytes = static_cast<unsigned char*>(env->GetDirectBufferAddress(pauseByteBuffer));
-    gWrapperData.renderer.setPauseTexture(pauseWidth, pauseHeight, pauseBytes);
 
+    /* 新しいコンテキストには起動時のアセットがまだない。準備済みなら今転送し、まだなら最初のフレームで待つ */
+    gWrapperData.startupAssetsUploaded = false;
+    if (gWrapperData.initPipeline.isReady())
+        uploadStartupAssets();
 }
 
 
@@ -274,10 +423,10 @@ Java_com_tks_videophotobook_VuforiaWrapperKt_configureRendering(JNIEnv *env, jcl
                                                                                      jint height,
                                                                                      jint orientation,
                                                                                      jint rotation) {
-    std::vector<int> androidOrientation{ orientation, rotation };
-    gWrapperData.renderer._screenWidth = width;
-    gWrapperData.renderer._screenHeight= height;
-    return controller.configureRendering(width, height, androidOrientation.data()) ? JNI_TRUE : JNI_FALSE;
+    VPB_TRACE_SCOPE("JNI configureRendering");
+    int androidOrientation[2] = { orientation, rotation };
+    gWrapperData.renderer.setScreenSize(static_cast<float>(width), static_cast<float>(height));
+    return controller.configureRendering(width, height, androidOrientation) ? JNI_TRUE : JNI_FALSE;
 }
 
 
@@ -294,79 +443,28 @@ jobjectArray makeRetString(JNIEnv *env, std::vector<std::string> strs) {
 
 JNIEXPORT jstring JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_renderFrame(JNIEnv *env, jclass clazz, jstring now_playing_target) {
+    VPB_TRACE_SCOPE("JNI renderFrame");
     if (!controller.isARStarted())
     {
         return env->NewStringUTF("waiting...");
     }
 
-    /* 戻り値定義 */
-    std::string retDetectedTarget = "";
-    /* 引数jstring を std::string に変換 */
-    const char* nativeStr = env->GetStringUTFChars(now_playing_target, nullptr);
-    std::string nowPlayingTarget(nativeStr);
-    env->ReleaseStringUTFChars(now_playing_target, nativeStr);
-
-    // Clear colour and depth buffers
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-    int vbTextureUnit = 0;
-    VuRenderVideoBackgroundData renderVideoBackgroundData;
-    renderVideoBackgroundData.renderData = nullptr;
-    renderVideoBackgroundData.textureData = nullptr;
-    renderVideoBackgroundData.textureUnitData = &vbTextureUnit;
-    double viewport[6];
-    if (controller.prepareToRender(viewport, &renderVideoBackgroundData))
-    {
-        // Set viewport for current view
-        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-//        __android_log_print(ANDROID_LOG_DEBUG, "aaaaa", "viewport(%f, %f, %f, %f)", viewport[0], viewport[1], viewport[2], viewport[3]);
-
-        auto renderState = controller.getRenderState();
-        gWrapperData.renderer.renderVideoBackground(renderState.vbProjectionMatrix, renderState.vbMesh->pos, renderState.vbMesh->tex,
-                                                    renderState.vbMesh->numFaces, renderState.vbMesh->faceIndices, vbTextureUnit);
-
-        auto [imageTargetList, CNT] = controller.createImageTargetList();
-        for (int idx = 0; idx < CNT; idx++) {
-            VuObservation* observation = nullptr;
-            if (vuObservationListGetElement(imageTargetList.get(), idx, &observation) != VU_SUCCESS)
-                continue;
-
-            assert(observation);
-            assert(vuObservationIsType(observation, VU_OBSERVATION_IMAGE_TARGET_TYPE) == VU_TRUE);
-            assert(vuObservationHasPoseInfo(observation) == VU_TRUE);
-
-            VuMatrix44F trackableProjection;
-            VuMatrix44F trackableModelView;
-            VuMatrix44F trackableModelViewScaled;
-
-            VuImageTargetObservationTargetInfo imageTargetInfo;
-            VuResult vuret = vuImageTargetObservationGetTargetInfo(observation, &imageTargetInfo);
-            assert(vuret == VU_SUCCESS);
-            VuVector2F markerSize{.data{imageTargetInfo.size.data[0], imageTargetInfo.size.data[1]}};
-
-            if (controller.getImageTargetResult(observation, markerSize, trackableProjection, trackableModelView, trackableModelViewScaled))
-            {
-//                __android_log_print(ANDROID_LOG_DEBUG, "aaaaa", "owPlayingTarget=%s detected!!!! target name=%s", nowPlayingTarget.c_str(), imageTargetInfo.name);
-                if(nowPlayingTarget.empty()) {
-                    nowPlayingTarget = imageTargetInfo.name;
-                    retDetectedTarget = imageTargetInfo.name;
-                    gWrapperData.renderer.renderVideoPlayback(trackableProjection, trackableModelView, trackableModelViewScaled, markerSize, imageTargetInfo.name);
-                }
-                else if(nowPlayingTarget != imageTargetInfo.name)
-                    gWrapperData.renderer.renderPause(trackableProjection, trackableModelView, trackableModelViewScaled, markerSize, imageTargetInfo.name);
-                else if(nowPlayingTarget == imageTargetInfo.name) {
-                    retDetectedTarget = imageTargetInfo.name;
-                    gWrapperData.renderer.renderVideoPlayback(trackableProjection, trackableModelView, trackableModelViewScaled, markerSize, imageTargetInfo.name);
-                }
-//              gWrapperData.renderer.renderImageTarget(trackableProjection, trackableModelView, trackableModelViewScaled);
-            }
-        }
-        imageTargetList.reset();
+    /* 引数jstring を ターゲットIDに変換 (未知の名前はどのターゲットにも一致させない) */
+    int32_t nowPlayingId = NO_TARGET_ID;
+    /* GetStringUTFCharsはコピーを確保するので、フレーム用アリーナにコピーしてもらう */
+    jsize utfLength = env->GetStringUTFLength(now_playing_target);
+    char* nativeStr = gWrapperData.frameLoop.getFrameArena().allocateArray<char>(utfLength + 1);
+    if (nativeStr != nullptr && utfLength > 0) {
+        env->GetStringUTFRegion(now_playing_target, 0, env->GetStringLength(now_playing_target), nativeStr);
+        nativeStr[utfLength] = '\0';
+        nowPlayingId = controller.getTargetRegistry().findByName(nativeStr);
+        if (nowPlayingId == TargetRegistry::INVALID_ID)
+            nowPlayingId = controller.getTargetCount();
     }
 
-    controller.finishRender();
-
-    return env->NewStringUTF(retDetectedTarget.c_str());
+    FrameResult frameResult{};
+    int32_t playingId = renderFrameInternal(nowPlayingId, frameResult);
+    return env->NewStringUTF(playingId == NO_TARGET_ID ? "" : controller.getTargetName(playingId));
 }
 
 
@@ -476,6 +574,7 @@ accessFusionProviderPointers()
 extern "C"
 JNIEXPORT jint JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_initVideoTexture(JNIEnv *env, jclass clazz) {
+    VPB_TRACE_SCOPE("JNI initVideoTexture");
     gWrapperData.renderer._vTextureId = -1;
     glGenTextures(1, &gWrapperData.renderer._vTextureId);
     glBindTexture(GL_TEXTURE_EXTERNAL_OES, gWrapperData.renderer._vTextureId);
@@ -490,60 +589,275 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_nativeOnSurfaceChanged(JNIEnv *env, jclass clazz,
                                                      jint width, jint height) {
+    /* onSurfaceChangedから呼ばれるので描画スレッド上。直接設定してよい */
     glViewport(0, 0, width, height);
-    gWrapperData.renderer._screenWidth = static_cast<float>(width);
-    gWrapperData.renderer._screenHeight= static_cast<float>(height);
+    gWrapperData.renderer.setScreenSize(static_cast<float>(width), static_cast<float>(height));
 }
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_nativeSetVideoSize(JNIEnv *env, jclass clazz,
                                                  jint width, jint height) {
-    gWrapperData.renderer._vVideoWidth = static_cast<float>(width);
-    gWrapperData.renderer._vVideoHeight= static_cast<float>(height);
+    /* ExoPlayerのリスナー(UIスレッド)から呼ばれるので、描画スレッドへはキュー経由で渡す */
+    if (!gWrapperData.renderer.postCommand(RenderCommand::videoSize(static_cast<float>(width), static_cast<float>(height))))
+        LOG("Render command queue full, video size dropped");
 }
 extern "C"
 JNIEXPORT jstring JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_checkHit(JNIEnv *env, jclass clazz,
                                                       jfloat x, jfloat y, jfloat screenW, jfloat screenH) {
-    for (const auto& [targetName, timeAndQuad] : gWrapperData.renderer._ndcQuadPoints) {
-        const auto& [lastUpdate, ndcQuadPoints] = timeAndQuad;
-        /* 最終更新時刻が1秒以上ならそのデータは無効 */
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - lastUpdate);
-        if(duration.count() > 1000) continue;
-
-        /* タッチ座標を スクリーン座標 → NDC(正規化デバイス座標-1～1)に変換 */
-        float ndcX = (2.0f * x / screenW) - 1.0f;
-        float ndcY = 1.0f - (2.0f * y / screenH); /* Y軸は反転してOpenGL系に合わせる */
-
-        /* タッチ座標と板ポリ座標でコリジョン判定 */
-        glm::vec2 touchPoint = glm::vec2(ndcX, ndcY);
-        bool ret = checkPolygonHit(touchPoint, ndcQuadPoints);
-        /* 見つかったらreturn */
-        if(ret) return env->NewStringUTF(targetName.c_str());;
-    }
-    return env->NewStringUTF(std::string("").c_str());
+    VPB_TRACE_SCOPE("JNI checkHit");
+    /* タッチ座標を スクリーン座標 → NDC(正規化デバイス座標-1～1)に変換 */
+    glm::vec2 touchPoint = screenToNdc(x, y, screenW, screenH);
+
+    /* タッチ位置からのレイとターゲット面の交差判定(一番手前のターゲット) */
+    RayHitTester::Hit hit;
+    if (hitTestTouch(touchPoint, hit))
+        return env->NewStringUTF(controller.getTargetName(hit.targetId));
+    return env->NewStringUTF("");
 }
 
-/* 2Dベクトルの外積(z成分)の算出関数 */
-float cross2D(const glm::vec2& v1, const glm::vec2& v2) {
-    return v1.x * v2.y - v1.y * v2.x;
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_checkHitId(JNIEnv *env, jclass clazz,
+                                                        jfloat x, jfloat y, jfloat screenW, jfloat screenH) {
+    VPB_TRACE_SCOPE("JNI checkHitId");
+    /* checkHit()のターゲットID版。当たりが無ければNO_TARGET_ID */
+    glm::vec2 touchPoint = screenToNdc(x, y, screenW, screenH);
+    RayHitTester::Hit hit;
+    if (!hitTestTouch(touchPoint, hit))
+        return NO_TARGET_ID;
+    return hit.targetId;
 }
 
-/* タッチ座標と四角形頂点座標からコリジョン判定 */
-/* 0 → 1 → 2 → 3 → 0 の淳で判定 */
-bool checkPolygonHit(const glm::vec2& targetPoint, const std::array<glm::vec2, 4>& ndcQuadPoints) {
-    float z0 = cross2D(ndcQuadPoints[1] - ndcQuadPoints[0], targetPoint - ndcQuadPoints[0]);
-    float z1 = cross2D(ndcQuadPoints[2] - ndcQuadPoints[1], targetPoint - ndcQuadPoints[1]);
-    float z2 = cross2D(ndcQuadPoints[3] - ndcQuadPoints[2], targetPoint - ndcQuadPoints[2]);
-    float z3 = cross2D(ndcQuadPoints[0] - ndcQuadPoints[3], targetPoint - ndcQuadPoints[3]);
-    return (z0 >= 0 && z1 >= 0 && z2 >= 0 && z3 >= 0) || /* 全部が0以上　もしくは */
-           (z0 <= 0 && z1 <= 0 && z2 <= 0 && z3 <= 0);   /* 全部が0以下 */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_checkHitUv(JNIEnv *env, jclass clazz,
+                                                        jfloat x, jfloat y, jfloat screenW, jfloat screenH, jfloatArray uv) {
+    VPB_TRACE_SCOPE("JNI checkHitUv");
+    /* checkHitId()に加えて、当たった位置を動画のテクスチャ座標(左上0,0～右下1,1)でuv[0],uv[1]に返す */
+    glm::vec2 touchPoint = screenToNdc(x, y, screenW, screenH);
+    RayHitTester::Hit hit;
+    if (!hitTestTouch(touchPoint, hit))
+        return NO_TARGET_ID;
+    if (uv != nullptr && env->GetArrayLength(uv) >= 2)
+    {
+        const jfloat hitUv[2] = { hit.uv.x, hit.uv.y };
+        env->SetFloatArrayRegion(uv, 0, 2, hitUv);
+    }
+    return hit.targetId;
 }
 
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_tks_videophotobook_VuforiaWrapperKt_setFullScreenMode(JNIEnv *env, jclass clazz,
                                                                jboolean is_full_screen_mode) {
-    gWrapperData.renderer._fullscreenFlg = (is_full_screen_mode == JNI_TRUE);
-    __android_log_print(ANDROID_LOG_DEBUG, "aaaaa", "_fullscreenFlg=%d", gWrapperData.renderer._fullscreenFlg);
+    bool fullscreen = (is_full_screen_mode == JNI_TRUE);
+    if (!gWrapperData.renderer.postCommand(RenderCommand::fullscreen(fullscreen)))
+        LOG("Render command queue full, fullscreen mode dropped");
+    __android_log_print(ANDROID_LOG_DEBUG, "aaaaa", "_fullscreenFlg=%d", fullscreen);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_setFrameResultBuffer(JNIEnv *env, jclass clazz, jobject buffer) {
+    if (gFrameResultBuffer != nullptr)
+        env->DeleteGlobalRef(gFrameResultBuffer);
+    gFrameResultBuffer = nullptr;
+    gFrameResult = nullptr;
+
+    if (buffer == nullptr)
+        return;
+
+    /* DirectByteBufferのみ。容量がFrameResultに満たなければ登録しない */
+    void* address = env->GetDirectBufferAddress(buffer);
+    if (address == nullptr || env->GetDirectBufferCapacity(buffer) < static_cast<jlong>(sizeof(FrameResult))) {
+        LOG("setFrameResultBuffer: a direct buffer of at least %zu bytes is required", sizeof(FrameResult));
+        return;
+    }
+    gFrameResultBuffer = env->NewGlobalRef(buffer);
+    gFrameResult = static_cast<FrameResult*>(address);
+    *gFrameResult = FrameResult{};
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_renderFrameIds(JNIEnv *env, jclass clazz, jint now_playing_id) {
+    VPB_TRACE_SCOPE("JNI renderFrameIds");
+    if (!controller.isARStarted())
+        return FRAME_WAITING_ID;
+
+    /* バッファ未登録時は結果を捨てる */
+    static FrameResult discardedResult{};
+    return renderFrameInternal(now_playing_id, gFrameResult != nullptr ? *gFrameResult : discardedResult);
+}
+
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_getTargetNames(JNIEnv *env, jclass clazz) {
+    /* ターゲットID順の名前一覧。初期化後に一度だけ取得する想定 */
+    std::vector<std::string> targetNames;
+    for (int targetId = 0; targetId < controller.getTargetCount(); targetId++)
+        targetNames.emplace_back(controller.getTargetName(targetId));
+    return makeRetString(env, targetNames);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_setTrackingThreadEnabled(JNIEnv *env, jclass clazz, jboolean enabled) {
+    /* startAR済みなら即座に切り替え、そうでなければ次のstartARで反映 */
+    gWrapperData.useTrackingThread = (enabled == JNI_TRUE);
+    if (!gWrapperData.useTrackingThread)
+        gWrapperData.trackingThread.stop();
+    else if (controller.isARStarted())
+        gWrapperData.trackingThread.start(controller);
+}
+
+
+JNIEXPORT jfloatArray JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_getLatencyStats(JNIEnv *env, jclass clazz) {
+    /* ステージごとに [count, p50, p95, p99, max] (us)、並びは LatencyStats::Stage の順 (LATENCY_STATS_* in VuforiaWrapper.kt) */
+    constexpr int VALUES_PER_STAGE = 5;
+    static_assert(LatencyStats::STAGE_COUNT == 7 && static_cast<int>(LatencyStats::Stage::CAMERA_AGE) == 5 &&
+                  static_cast<int>(LatencyStats::Stage::TOTAL) == 6, "Update LATENCY_STATS_* in VuforiaWrapper.kt");
+    jfloat values[LatencyStats::STAGE_COUNT * VALUES_PER_STAGE];
+    for (int stage = 0; stage < LatencyStats::STAGE_COUNT; stage++)
+    {
+        const LatencyStats::Percentiles percentiles = gWrapperData.frameLoop.getLatencyStats().getPercentiles(static_cast<LatencyStats::Stage>(stage));
+        jfloat* stageValues = values + stage * VALUES_PER_STAGE;
+        stageValues[0] = static_cast<jfloat>(percentiles.count);
+        stageValues[1] = percentiles.p50;
+        stageValues[2] = percentiles.p95;
+        stageValues[3] = percentiles.p99;
+        stageValues[4] = percentiles.max;
+    }
+    jfloatArray result = env->NewFloatArray(LatencyStats::STAGE_COUNT * VALUES_PER_STAGE);
+    if (result != nullptr)
+        env->SetFloatArrayRegion(result, 0, LatencyStats::STAGE_COUNT * VALUES_PER_STAGE, values);
+    return result;
+}
+
+
+JNIEXPORT jfloatArray JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_getThreadRoleUsage(JNIEnv *env, jclass clazz) {
+    /* 役割ごとに [スレッド数, CPU時間(s)]、並びは ThreadRole の順で最後が役割のないスレッド */
+    constexpr int VALUES_PER_ROLE = 2;
+    constexpr int NUM_VALUES = (ThreadRoles::ROLE_COUNT + 1) * VALUES_PER_ROLE;
+    ThreadRoles::Usage usage[ThreadRoles::ROLE_COUNT + 1];
+    ThreadRoles::getUsage(usage);
+    jfloat values[NUM_VALUES];
+    for (int role = 0; role <= ThreadRoles::ROLE_COUNT; role++)
+    {
+        values[role * VALUES_PER_ROLE] = static_cast<jfloat>(usage[role].numThreads);
+        values[role * VALUES_PER_ROLE + 1] = static_cast<jfloat>(usage[role].cpuSeconds);
+    }
+    jfloatArray result = env->NewFloatArray(NUM_VALUES);
+    if (result != nullptr)
+        env->SetFloatArrayRegion(result, 0, NUM_VALUES, values);
+    return result;
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_dumpLatencyStats(JNIEnv *env, jclass clazz, jstring path) {
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr)
+        return JNI_FALSE;
+    const bool result = gWrapperData.frameLoop.getLatencyStats().dumpToFile(pathChars);
+    if (!result)
+        LOG("Failed to write the latency stats to %s", pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+    return result ? JNI_TRUE : JNI_FALSE;
+}
+
+
+JNIEXPORT jobject JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_getMetricsBuffer(JNIEnv *env, jclass clazz) {
+    /* ブロックはプロセス終了まで生きているので、一度取得すればKotlin側で持ち続けてよい */
+    return env->NewDirectByteBuffer(&gWrapperData.metrics, sizeof(FrameMetrics));
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_dumpTrace(JNIEnv *env, jclass clazz, jstring path) {
+    /* トレース無効のビルド(リリース)では何もせずfalse */
+    if (!isTracingEnabled())
+        return JNI_FALSE;
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr)
+        return JNI_FALSE;
+    /* 数MBのJSONになるのでUIスレッドでは書かず、ワーカーに任せる */
+    gWrapperData.jobs.submit("write trace", [tracePath = std::string(pathChars)] {
+        ThreadRoles::Scope role(ThreadRole::BACKGROUND);
+        if (Tracer::writeChromeTrace(tracePath.c_str()))
+            LOG("Wrote the trace to %s", tracePath.c_str());
+        else
+            LOG("Failed to write the trace to %s", tracePath.c_str());
+    });
+    env->ReleaseStringUTFChars(path, pathChars);
+    return JNI_TRUE;
+}
+
+
+JNIEXPORT void JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_setPosePrediction(JNIEnv *env, jclass clazz, jboolean enabled, jint display_latency_ms) {
+    /* 次に取得するフレームから有効 */
+    controller.setPosePrediction(enabled == JNI_TRUE, display_latency_ms);
+}
+
+
+JNIEXPORT void JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_setHudEnabled(JNIEnv *env, jclass clazz, jboolean enabled) {
+    if (!gWrapperData.renderer.postCommand(RenderCommand::hud(enabled == JNI_TRUE)))
+        LOG("Render command queue full, HUD setting dropped");
+}
+
+
+JNIEXPORT void JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_startInitPipeline(JNIEnv *env, jclass clazz, jobject assetManager) {
+    /* AssetManagerはActivityが持ち続けるのでポインタだけ控える(initARと同じ) */
+    AAssetManager* nativeAssetManager = AAssetManager_fromJava(env, assetManager);
+    if (nativeAssetManager == nullptr)
+    {
+        LOG("Error: Failed to get the asset manager");
+        return;
+    }
+    startInitPipeline(nativeAssetManager);
+}
+
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_getManifestTargetNames(JNIEnv *env, jclass clazz) {
+    /* マニフェストの読み込みが終わるまで待つので、UIスレッドからは呼ばない */
+    const std::vector<std::string>* targetNames = gWrapperData.initPipeline.getManifestTargetNames();
+    return makeRetString(env, targetNames != nullptr ? *targetNames : std::vector<std::string>());
+}
+
+
+JNIEXPORT jint JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_beginStartupPhase(JNIEnv *env, jclass clazz, jstring name) {
+    const char* nameChars = env->GetStringUTFChars(name, nullptr);
+    if (nameChars == nullptr)
+        return StartupTimeline::NO_PHASE;
+    const int phase = gWrapperData.startupTimeline.begin(nameChars);
+    env->ReleaseStringUTFChars(name, nameChars);
+    return phase;
+}
+
+
+JNIEXPORT void JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_endStartupPhase(JNIEnv *env, jclass clazz, jint phase) {
+    gWrapperData.startupTimeline.end(phase);
+}
+
+
+JNIEXPORT jboolean JNICALL
+Java_com_tks_videophotobook_VuforiaWrapperKt_dumpStartupTimeline(JNIEnv *env, jclass clazz, jstring path) {
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr)
+        return JNI_FALSE;
+    const bool result = gWrapperData.startupTimeline.dumpToFile(pathChars);
+    if (!result)
+        LOG("Failed to write the startup timeline to %s", pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+    return result ? JNI_TRUE : JNI_FALSE;
 }
@@ -0,0 +1,45 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <chrono>
+#include <cstdio>
+
+/// Minimal timing helper for the Linux host benchmarks
+/**
+ * Runs func iterations times after a short warm up and prints the mean cost per call.
+ * Returns the mean cost in nanoseconds.
+ */
+template<typename Func>
+double
+runBenchmark(const char* name, int iterations, Func&& func)
+{
+    for (int i = 0; i < iterations / 10 + 1; i++)
+    {
+        func();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        func();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double nsPerCall = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    printf("%-40s %12.1f ns/op  (%d iterations)\n", name, nsPerCall, iterations);
+    return nsPerCall;
+}
+
+/// Keep the compiler from optimizing away a benchmarked result
+template<typename T>
+inline void
+doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // __BENCH_H__
@@ -0,0 +1,571 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "Bench.h"
+
+#include "AssetSource.h"
+#include "HitTest.h"
+#include "HudOverlay.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "MeshSignature.h"
+#include "ObjModel.h"
+#include "QuadGeometry.h"
+#include "RayHitTester.h"
+#include "RenderCommand.h"
+#include "SimdMath.h"
+#include "TargetRegistry.h"
+#include "Tracer.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+bool
+readFile(const std::string& path, std::vector<char>& data)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/// FNV-1a over 64 bit words, the checksum spread over the JobSystem workers in the scaling benchmark
+uint64_t
+checksumWords(const uint64_t* words, size_t numWords)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t idx = 0; idx < numWords; idx++)
+        hash = (hash ^ words[idx]) * 0x100000001b3ULL;
+    return hash;
+}
+
+/// Dependencies run in order, parallelFor covers every index once and a worker can wait for another job
+bool
+checkJobSystem(JobSystem& jobs)
+{
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto append = [&](int value) {
+        return [&, value] {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(value);
+        };
+    };
+    // Diamond: 0 -> (1, 2) -> 3
+    const JobSystem::JobHandle first = jobs.submit("check", append(0));
+    const JobSystem::JobHandle left = jobs.submit("check", append(1), { first });
+    const JobSystem::JobHandle right = jobs.submit("check", append(2), { first });
+    const JobSystem::JobHandle last = jobs.submit("check", append(3), { left, right });
+    jobs.wait(last);
+    if (order.size() != 4 || order[0] != 0 || order[3] != 3)
+        return false;
+
+    std::vector<std::atomic<int>> visits(10007);
+    jobs.parallelFor("check", static_cast<int>(visits.size()), 100, [&](int begin, int end) {
+        for (int idx = begin; idx < end; idx++)
+            visits[idx].fetch_add(1, std::memory_order_relaxed);
+    });
+    if (!std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& count) { return count.load() == 1; }))
+        return false;
+
+    const auto nested = jobs.submitWithResult("check", [&jobs] {
+        const auto inner = jobs.submitWithResult("check", [] { return 42; });
+        jobs.wait(inner.getHandle());
+        return inner.get() + 1;
+    });
+    jobs.wait(nested.getHandle());
+    return nested.get() == 43;
+}
+
+/// A plausible scaled model-view-projection matrix of a target about 30cm in front of the camera
+glm::mat4
+makeTargetMvp(float offsetX)
+{
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 9.0f / 16.0f, 0.01f, 5.0f);
+    glm::mat4 modelView = glm::translate(glm::mat4(1.0f), glm::vec3(offsetX, 0.0f, -0.3f));
+    modelView = glm::rotate(modelView, glm::radians(20.0f), glm::vec3(1.0f, 0.0f, 0.0f));
+    return projection * glm::scale(modelView, glm::vec3(0.1f, 0.15f, 0.15f));
+}
+
+/// Reference projection with glm, as projectQuadToNdc was implemented before the SIMD kernels
+std::array<glm::vec2, 4>
+projectQuadToNdcReference(const glm::mat4& mvp, const glm::vec2& halfExtent)
+{
+    const glm::vec2 corners[4] = {
+        { -halfExtent.x, -halfExtent.y },
+        { halfExtent.x, -halfExtent.y },
+        { halfExtent.x, halfExtent.y },
+        { -halfExtent.x, halfExtent.y },
+    };
+    std::array<glm::vec2, 4> ndcQuadPoints = {};
+    for (int idx = 0; idx < 4; idx++)
+    {
+        glm::vec4 glpos = mvp * glm::vec4(corners[idx], 0.0f, 1.0f);
+        ndcQuadPoints[idx] = glm::vec2(glpos) / glpos.w;
+    }
+    return ndcQuadPoints;
+}
+
+/// Largest difference relative to max(1, |expected|)
+float
+relativeError(const float* actual, const float* expected, int count)
+{
+    float maxError = 0.0f;
+    for (int idx = 0; idx < count; idx++)
+    {
+        maxError = std::max(maxError, std::fabs(actual[idx] - expected[idx]) / std::max(1.0f, std::fabs(expected[idx])));
+    }
+    return maxError;
+}
+
+/// Compare the SIMD kernels with glm over a sweep of target poses. Returns false if any result is off.
+bool
+checkSimdMathAccuracy()
+{
+    constexpr float TOLERANCE = 1e-5f;
+    float multiplyError = 0.0f;
+    float scaleError = 0.0f;
+    float projectError = 0.0f;
+    for (int step = 0; step < 1000; step++)
+    {
+        const float angle = 0.37f * step;
+        glm::mat4 projection = glm::perspective(glm::radians(40.0f + 0.03f * step), 9.0f / 16.0f, 0.01f, 5.0f);
+        glm::mat4 modelView = glm::translate(glm::mat4(1.0f), glm::vec3(0.2f * std::sin(angle), 0.3f * std::cos(angle), -0.2f - 0.001f * step));
+        modelView = glm::rotate(modelView, angle, glm::normalize(glm::vec3(1.0f, std::sin(angle), 0.5f)));
+        const glm::vec3 scale(0.05f + 0.0001f * step, 0.08f, 0.08f);
+        const glm::vec2 halfExtent(0.5f + 0.0005f * step, 0.5f);
+
+        glm::mat4 product;
+        multiplyMatrix44(glm::value_ptr(projection), glm::value_ptr(modelView), glm::value_ptr(product));
+        const glm::mat4 expectedProduct = projection * modelView;
+        multiplyError = std::max(multiplyError, relativeError(glm::value_ptr(product), glm::value_ptr(expectedProduct), 16));
+
+        glm::mat4 scaled;
+        scaleMatrix44(glm::value_ptr(modelView), scale.x, scale.y, scale.z, glm::value_ptr(scaled));
+        const glm::mat4 expectedScaled = glm::scale(modelView, scale);
+        scaleError = std::max(scaleError, relativeError(glm::value_ptr(scaled), glm::value_ptr(expectedScaled), 16));
+
+        const glm::mat4 mvp = projection * expectedScaled;
+        std::array<glm::vec2, 4> quad;
+        projectQuadsToNdc(glm::value_ptr(mvp), &halfExtent, 1, &quad);
+        const auto expectedQuad = projectQuadToNdcReference(mvp, halfExtent);
+        projectError = std::max(projectError, relativeError(&quad[0].x, &expectedQuad[0].x, 8));
+    }
+    printf("SIMD math max relative error vs glm: multiply %.2g, scale %.2g, project %.2g\n", multiplyError, scaleError,
+           projectError);
+    return multiplyError <= TOLERANCE && scaleError <= TOLERANCE && projectError <= TOLERANCE;
+}
+
+/// Tap points projected from known quad positions must come back as the same target and UV, points
+/// off the quad must miss, and of two overlapping targets the nearer one must win. Returns false on failure.
+bool
+checkRayHitTester()
+{
+    constexpr float UV_TOLERANCE = 1e-3f;
+    RayHitTester hitTester;
+    RayHitTester::Hit hit;
+    float uvError = 0.0f;
+    int failures = 0;
+    for (int step = 0; step < 1000; step++)
+    {
+        const float angle = 0.37f * step;
+        glm::mat4 projection = glm::perspective(glm::radians(40.0f + 0.03f * step), 9.0f / 16.0f, 0.01f, 5.0f);
+        glm::mat4 modelView = glm::translate(glm::mat4(1.0f), glm::vec3(0.05f * std::sin(angle), 0.05f * std::cos(angle), -0.2f - 0.001f * step));
+        modelView = glm::rotate(modelView, 0.8f * std::sin(angle), glm::normalize(glm::vec3(1.0f, std::sin(angle), 0.5f)));
+        const glm::mat4 scaledModelView = glm::scale(modelView, glm::vec3(0.05f + 0.0001f * step, 0.08f, 0.08f));
+        const glm::vec2 halfExtent(0.5f + 0.0005f * step, 0.5f);
+
+        hitTester.setProjection(glm::value_ptr(projection));
+        hitTester.addTarget(step % TargetRegistry::MAX_TARGETS, glm::value_ptr(scaledModelView), halfExtent);
+        hitTester.publish();
+
+        const glm::vec2 uv(0.1f + 0.0008f * step, 0.9f - 0.0008f * step);
+        for (bool onQuad : { true, false })
+        {
+            /* 外す方は右端から少し外側 */
+            const float x = onQuad ? 2.0f * uv.x - 1.0f : 1.05f + uv.x;
+            const glm::vec4 local(x * halfExtent.x, (1.0f - 2.0f * uv.y) * halfExtent.y, 0.0f, 1.0f);
+            const glm::vec4 clip = projection * scaledModelView * local;
+            const bool isHit = hitTester.hitTest(glm::vec2(clip) / clip.w, hit);
+            if (!onQuad)
+            {
+                failures += isHit ? 1 : 0;
+                continue;
+            }
+            if (!isHit || hit.targetId != step % TargetRegistry::MAX_TARGETS)
+            {
+                failures++;
+                continue;
+            }
+            uvError = std::max(uvError, std::max(std::fabs(hit.uv.x - uv.x), std::fabs(hit.uv.y - uv.y)));
+        }
+    }
+
+    // A page held in front of another one: the tap must go to the front page whatever the order
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 9.0f / 16.0f, 0.01f, 5.0f);
+    const glm::mat4 front = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -0.2f)), glm::vec3(0.1f));
+    const glm::mat4 back = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -0.4f)), glm::vec3(0.1f));
+    hitTester.setProjection(glm::value_ptr(projection));
+    hitTester.addTarget(1, glm::value_ptr(back), glm::vec2(0.5f));
+    hitTester.addTarget(2, glm::value_ptr(front), glm::vec2(0.5f));
+    hitTester.publish();
+    if (!hitTester.hitTest(glm::vec2(0.0f), hit) || hit.targetId != 2)
+        failures++;
+
+    printf("RayHitTester: max UV error %.2g, %d failures\n", uvError, failures);
+    return failures == 0 && uvError <= UV_TOLERANCE;
+}
+}
+
+
+int
+main(int argc, char** argv)
+{
+    std::string objPath = argc > 1 ? argv[1] : VPB_ASSET_DIR "/ImageTargets/Astronaut.obj";
+
+    /* InitPipelineと同じく、コピーせずにマッピングから解析する */
+    const AssetBuffer objData = PosixAssetSource::mapFile(objPath.c_str());
+    std::vector<char> objCopy;
+    if (!objData.isValid() || !readFile(objPath, objCopy))
+    {
+        LOG("Error reading %s", objPath.c_str());
+        return 1;
+    }
+    if (objCopy.size() != objData.size() || !std::equal(objCopy.begin(), objCopy.end(), objData.begin()))
+    {
+        LOG("AssetSource: the mapping of %s differs from the file", objPath.c_str());
+        return 1;
+    }
+    runBenchmark("read Astronaut.obj (copy)", 100, [&] {
+        readFile(objPath, objCopy);
+        doNotOptimize(objCopy.data());
+    });
+    runBenchmark("map Astronaut.obj (AssetSource)", 100, [&] {
+        doNotOptimize(PosixAssetSource::mapFile(objPath.c_str()).data());
+    });
+
+    int numVertices = 0;
+    std::vector<float> vertices;
+    std::vector<float> texCoords;
+    runBenchmark("loadObjModel(Astronaut.obj)", 20, [&] {
+        loadObjModel(objData.data(), objData.size(), numVertices, vertices, texCoords);
+    });
+    printf("  %d vertices\n", numVertices);
+
+    const glm::mat4 mvp = makeTargetMvp(0.0f);
+    const glm::vec2 markerSize(0.1f, 0.15f);
+
+    runBenchmark("computeVideoQuadHalfExtent", 1000000, [&] {
+        doNotOptimize(computeVideoQuadHalfExtent(false, 1920.0f, 1080.0f, 1080.0f, 2400.0f, markerSize));
+    });
+
+    if (!checkSimdMathAccuracy())
+    {
+        LOG("SIMD math: results differ from glm");
+        return 1;
+    }
+    if (!checkRayHitTester())
+    {
+        LOG("RayHitTester: wrong hits");
+        return 1;
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 9.0f / 16.0f, 0.01f, 5.0f);
+    glm::mat4 product;
+    runBenchmark("glm::mat4 multiply", 1000000, [&] {
+        product = projection * mvp;
+        doNotOptimize(product);
+    });
+    runBenchmark("multiplyMatrix44", 1000000, [&] {
+        multiplyMatrix44(glm::value_ptr(projection), glm::value_ptr(mvp), glm::value_ptr(product));
+        doNotOptimize(product);
+    });
+
+    runBenchmark("projectQuadToNdc", 1000000, [&] {
+        doNotOptimize(projectQuadToNdc(glm::value_ptr(mvp), glm::vec2(PAUSE_QUAD_HALF_EXTENT)));
+    });
+
+    // All corners of five visible targets, per frame
+    glm::mat4 targetMvps[5];
+    glm::vec2 targetHalfExtents[5];
+    for (int idx = 0; idx < 5; idx++)
+    {
+        targetMvps[idx] = makeTargetMvp(-0.2f + 0.1f * idx);
+        targetHalfExtents[idx] = glm::vec2(PAUSE_QUAD_HALF_EXTENT);
+    }
+    std::array<glm::vec2, 4> targetQuads[5];
+    runBenchmark("glm reference projection x5", 1000000, [&] {
+        for (int idx = 0; idx < 5; idx++)
+        {
+            targetQuads[idx] = projectQuadToNdcReference(targetMvps[idx], targetHalfExtents[idx]);
+        }
+        doNotOptimize(targetQuads);
+    });
+    runBenchmark("projectQuadsToNdc (5 quads)", 1000000, [&] {
+        projectQuadsToNdc(glm::value_ptr(targetMvps[0]), targetHalfExtents, 5, targetQuads);
+        doNotOptimize(targetQuads);
+    });
+
+    // Same five targets through the ray cast hit test
+    RayHitTester hitTester;
+    const glm::mat4 targetProjection = glm::perspective(glm::radians(60.0f), 9.0f / 16.0f, 0.01f, 5.0f);
+    glm::mat4 targetModelViews[5];
+    for (int idx = 0; idx < 5; idx++)
+    {
+        targetModelViews[idx] = glm::inverse(targetProjection) * targetMvps[idx];
+    }
+    runBenchmark("RayHitTester addTarget x5 + publish", 1000000, [&] {
+        hitTester.setProjection(glm::value_ptr(targetProjection));
+        for (int idx = 0; idx < 5; idx++)
+        {
+            hitTester.addTarget(idx, glm::value_ptr(targetModelViews[idx]), targetHalfExtents[idx]);
+        }
+        hitTester.publish();
+    });
+    RayHitTester::Hit rayHit;
+    const glm::vec2 rayTouchPoint(0.01f, 0.02f);
+    runBenchmark("RayHitTester::hitTest (5 targets)", 1000000, [&] {
+        doNotOptimize(hitTester.hitTest(rayTouchPoint, rayHit));
+    });
+
+    // Taps on the UI thread while the render thread keeps publishing: every read must see a whole frame
+    std::atomic<bool> rendering{ true };
+    std::thread renderThread([&] {
+        while (rendering.load(std::memory_order_relaxed))
+        {
+            hitTester.setProjection(glm::value_ptr(targetProjection));
+            for (int idx = 0; idx < 5; idx++)
+            {
+                hitTester.addTarget(idx, glm::value_ptr(targetModelViews[idx]), targetHalfExtents[idx]);
+            }
+            hitTester.publish();
+        }
+    });
+    const int expectedTargetId = rayHit.targetId;
+    long misses = 0;
+    runBenchmark("RayHitTester::hitTest (concurrent publish)", 1000000, [&] {
+        if (!hitTester.hitTest(rayTouchPoint, rayHit) || rayHit.targetId != expectedTargetId)
+            misses++;
+    });
+    rendering = false;
+    renderThread.join();
+    if (misses != 0)
+    {
+        LOG("RayHitTester: %ld inconsistent snapshots", misses);
+        return 1;
+    }
+
+    const auto quad = projectQuadToNdc(glm::value_ptr(mvp), glm::vec2(PAUSE_QUAD_HALF_EXTENT));
+    const glm::vec2 touchPoint = screenToNdc(540.0f, 1200.0f, 1080.0f, 2400.0f);
+    runBenchmark("checkPolygonHit", 1000000, [&] {
+        doNotOptimize(checkPolygonHit(touchPoint, quad));
+    });
+
+    // Five tracked pages, as with vuEngineSetMaximumSimultaneousTrackedImages(5)
+    const char* targetNames[] = { "000_frm", "001_frm", "002_frm", "003_frm", "004_frm" };
+    TargetRegistry registry;
+    for (int idx = 0; idx < 5; idx++)
+    {
+        registry.add(targetNames[idx], targetNames[idx], idx + 2, glm::vec2(0.07f, 0.039375f));
+    }
+    runBenchmark("TargetRegistry::findByObserverId x5", 1000000, [&] {
+        for (int32_t observerId = 2; observerId < 7; observerId++)
+        {
+            doNotOptimize(registry.findByObserverId(observerId));
+        }
+    });
+
+    // Video background: the signature is computed every frame to decide whether to upload the mesh again
+    constexpr int GRID = 16;
+    std::vector<float> gridPositions;
+    std::vector<float> gridTexCoords;
+    std::vector<uint32_t> gridIndices;
+    for (int row = 0; row <= GRID; row++)
+    {
+        for (int col = 0; col <= GRID; col++)
+        {
+            gridPositions.insert(gridPositions.end(), { -1.0f + 2.0f * col / GRID, -1.0f + 2.0f * row / GRID, 0.0f });
+            gridTexCoords.insert(gridTexCoords.end(), { static_cast<float>(col) / GRID, 1.0f - static_cast<float>(row) / GRID });
+        }
+    }
+    for (uint32_t row = 0; row < GRID; row++)
+    {
+        for (uint32_t col = 0; col < GRID; col++)
+        {
+            uint32_t base = row * (GRID + 1) + col;
+            gridIndices.insert(gridIndices.end(), { base, base + 1, base + GRID + 2, base, base + GRID + 2, base + GRID + 1 });
+        }
+    }
+    const int32_t gridVertices = static_cast<int32_t>(gridPositions.size() / 3);
+    const int32_t gridFaces = static_cast<int32_t>(gridIndices.size() / 3);
+    runBenchmark("computeMeshSignature (16x16 grid)", 100000, [&] {
+        doNotOptimize(computeMeshSignature(&gridPositions, gridPositions.data(), gridTexCoords.data(), gridVertices,
+                                           gridIndices.data(), gridFaces));
+    });
+
+    RenderCommandQueue commands;
+    RenderCommand command;
+    runBenchmark("RenderCommandQueue push + pop", 1000000, [&] {
+        commands.tryPush(RenderCommand::fullscreen(true));
+        doNotOptimize(commands.tryPop(command));
+    });
+
+    // UI thread posting while the render thread drains: commands must arrive complete and in order
+    std::atomic<bool> draining{ true };
+    long outOfOrder = 0;
+    std::thread drainThread([&] {
+        RenderCommand received;
+        float expected = 0.0f;
+        while (draining.load(std::memory_order_relaxed))
+        {
+            while (commands.tryPop(received))
+            {
+                if (received.width != expected || received.height != -expected)
+                    outOfOrder++;
+                expected = received.width + 1.0f;
+            }
+            std::this_thread::yield();
+        }
+    });
+    float sequence = 0.0f;
+    long queueFull = 0;
+    runBenchmark("RenderCommandQueue::tryPush (concurrent drain)", 100000, [&] {
+        while (!commands.tryPush(RenderCommand::videoSize(sequence, -sequence)))
+        {
+            queueFull++;
+            std::this_thread::yield();
+        }
+        sequence += 1.0f;
+    });
+    draining = false;
+    drainThread.join();
+    LOG("RenderCommandQueue: %.0f commands, %ld retries on a full queue", sequence, queueFull);
+    if (outOfOrder != 0)
+    {
+        LOG("RenderCommandQueue: %ld commands out of order", outOfOrder);
+        return 1;
+    }
+
+    // Performance HUD: laying out a full overlay every frame must stay far below its 0.2 ms budget
+    HudOverlay hud;
+    FrameResult hudResult{};
+    hudResult.numTracked = 3;
+    hudResult.trackedIds[0] = 0;
+    hudResult.trackedIds[1] = 2;
+    hudResult.trackedIds[2] = 5;
+    hudResult.playingId = 2;
+    for (int frame = 0; frame < HudOverlay::GRAPH_FRAMES + 10; frame++)
+    {
+        LatencyStats::FrameTimer timer;
+        timer.mark(LatencyStats::Stage::PREPARE);
+        timer.mark(LatencyStats::Stage::OBSERVATIONS);
+        timer.mark(LatencyStats::Stage::DRAW);
+        timer.mark(LatencyStats::Stage::FINISH);
+        hud.addFrame(timer, hudResult);
+    }
+    int hudVertices = 0;
+    runBenchmark("HudOverlay::build", 10000, [&] {
+        hudVertices = hud.build(1080.0f, 2400.0f);
+        doNotOptimize(hudVertices);
+    });
+    printf("  %d vertices (%d quads)\n", hudVertices, hudVertices / HudOverlay::VERTICES_PER_QUAD);
+    const HudOverlay::Vertex* hudVertex = hud.getVertices();
+    const bool hudOnScreen = hudVertices > 0 && std::all_of(hudVertex, hudVertex + hudVertices, [](const HudOverlay::Vertex& vertex) {
+        return std::abs(vertex.x) <= 1.0f && std::abs(vertex.y) <= 1.0f && vertex.u >= 0.0f && vertex.u <= 1.0f &&
+               vertex.v >= 0.0f && vertex.v <= 1.0f;
+    });
+    if (!hudOnScreen)
+    {
+        LOG("HudOverlay: vertices outside the screen or the atlas");
+        return 1;
+    }
+
+    // Job system: task overhead, and a checksum spread over more and more workers
+    const CpuTopology& topology = CpuTopology::get();
+    printf("CpuTopology: %d cpus (%d big, %d little), %d default workers\n", topology.numCpus, topology.numBigCpus,
+           topology.numLittleCpus, JobSystem::getDefaultWorkerCount());
+    {
+        JobSystem jobs;
+        if (!checkJobSystem(jobs))
+        {
+            LOG("JobSystem: dependencies or parallelFor wrong");
+            return 1;
+        }
+        runBenchmark("JobSystem submit + wait (empty job)", 100000, [&] {
+            jobs.wait(jobs.submit("bench", [] {}));
+        });
+        constexpr int BATCH_JOBS = 1000;
+        std::vector<JobSystem::JobHandle> batch(BATCH_JOBS);
+        const double batchNs = runBenchmark("JobSystem 1000 empty jobs + join", 200, [&] {
+            for (JobSystem::JobHandle& job : batch)
+                job = jobs.submit("bench", [] {});
+            jobs.wait(jobs.submit("bench join", [] {}, batch));
+        });
+        const JobSystem::Stats stats = jobs.getStats();
+        printf("  %.1f ns/job, %llu executed, %llu stolen\n", batchNs / BATCH_JOBS, static_cast<unsigned long long>(stats.executed),
+               static_cast<unsigned long long>(stats.stolen));
+    }
+
+    constexpr size_t CHECKSUM_WORDS = 8 << 20;
+    constexpr int CHECKSUM_CHUNKS = 64;
+    constexpr size_t CHUNK_WORDS = CHECKSUM_WORDS / CHECKSUM_CHUNKS;
+    std::vector<uint64_t> checksumData(CHECKSUM_WORDS);
+    for (size_t idx = 0; idx < CHECKSUM_WORDS; idx++)
+        checksumData[idx] = idx * 0x9e3779b97f4a7c15ULL;
+    uint64_t chunkHashes[CHECKSUM_CHUNKS];
+    for (int chunk = 0; chunk < CHECKSUM_CHUNKS; chunk++)
+        chunkHashes[chunk] = checksumWords(checksumData.data() + chunk * CHUNK_WORDS, CHUNK_WORDS);
+    const uint64_t expectedChecksum = checksumWords(chunkHashes, CHECKSUM_CHUNKS);
+
+    const int maxWorkers = std::min(std::max(static_cast<int>(std::thread::hardware_concurrency()), 1), JobSystem::MAX_WORKERS);
+    double singleWorkerNs = 0.0;
+    for (int numWorkers = 1; numWorkers <= maxWorkers; numWorkers *= 2)
+    {
+        JobSystem jobs(numWorkers);
+        uint64_t checksum = 0;
+        char name[64];
+        snprintf(name, sizeof(name), "parallel checksum 64 MB, %d workers", numWorkers);
+        const double ns = runBenchmark(name, 10, [&] {
+            jobs.parallelFor("checksum", CHECKSUM_CHUNKS, 1, [&](int begin, int end) {
+                for (int chunk = begin; chunk < end; chunk++)
+                    chunkHashes[chunk] = checksumWords(checksumData.data() + chunk * CHUNK_WORDS, CHUNK_WORDS);
+            });
+            checksum = checksumWords(chunkHashes, CHECKSUM_CHUNKS);
+        });
+        if (numWorkers == 1)
+            singleWorkerNs = ns;
+        printf("  %.2fx of 1 worker\n", singleWorkerNs / ns);
+        if (checksum != expectedChecksum)
+        {
+            LOG("JobSystem: parallel checksum differs");
+            return 1;
+        }
+    }
+
+    // Cost of an instrumented scope (VPB_TRACE_SCOPE), nothing in builds without VPB_ENABLE_TRACING
+    int traced = 0;
+    runBenchmark(isTracingEnabled() ? "VPB_TRACE_SCOPE" : "VPB_TRACE_SCOPE (compiled out)", 1000000, [&] {
+        VPB_TRACE_SCOPE_ID("CoreBench scope", traced);
+        traced++;
+        doNotOptimize(traced);
+    });
+
+    return 0;
+}
@@ -0,0 +1,1314 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "FakeVuforiaEngine.h"
+
+#include "Log.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+/// Capacity of the fixed per-state and per-list storage, acquiring a state never allocates
+constexpr int MAX_OBSERVATIONS = 32;
+/// Number of states that may be held by the client at the same time
+constexpr int STATE_POOL_SIZE = 4;
+/// Synthetic camera frame interval (30fps camera)
+constexpr int64_t SYNTHETIC_FRAME_INTERVAL_NS = 33333333;
+/// Default time from the capture of a camera frame to its first acquire
+constexpr int64_t DEFAULT_CAPTURE_AGE_NS = 20000000;
+
+struct StreamTarget
+{
+    std::string name;
+    VuObservationPoseStatus poseStatus{ VU_OBSERVATION_POSE_STATUS_TRACKED };
+    VuMatrix44F pose{};
+};
+
+struct StreamFrame
+{
+    int64_t timestamp{ 0 };
+    VuObservationPoseStatus devicePoseStatus{ VU_OBSERVATION_POSE_STATUS_TRACKED };
+    VuDevicePoseObservationStatusInfo deviceStatusInfo{ VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_NORMAL };
+    VuMatrix44F devicePose{};
+    std::vector<StreamTarget> targets;
+};
+
+/// Configuration set through the vuFakeEngine* functions before the engine is created
+struct
+{
+    std::vector<StreamFrame> stream;
+    /// Number of targets in the synthetic stream, -1 to use every created image target
+    int32_t syntheticTargets{ -1 };
+    /// Number of acquires that return the same camera frame
+    int32_t cameraFrameRepeat{ 1 };
+    /// Camera frames are stamped this long before their first acquire, negative for the stream timestamps
+    int64_t captureAgeNs{ DEFAULT_CAPTURE_AGE_NS };
+    std::string assetDirectory{ "." };
+} gFakeConfig;
+
+const struct
+{
+    const char* name;
+    int32_t value;
+} POSE_STATUS_NAMES[] = {
+    { "NO_POSE", VU_OBSERVATION_POSE_STATUS_NO_POSE },
+    { "LIMITED", VU_OBSERVATION_POSE_STATUS_LIMITED },
+    { "TRACKED", VU_OBSERVATION_POSE_STATUS_TRACKED },
+    { "EXTENDED_TRACKED", VU_OBSERVATION_POSE_STATUS_EXTENDED_TRACKED },
+},
+  DEVICE_STATUS_INFO_NAMES[] = {
+      { "NORMAL", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_NORMAL },
+      { "NOT_OBSERVED", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_NOT_OBSERVED },
+      { "UNKNOWN", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_UNKNOWN },
+      { "INITIALIZING", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_INITIALIZING },
+      { "RELOCALIZING", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_RELOCALIZING },
+      { "EXCESSIVE_MOTION", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_EXCESSIVE_MOTION },
+      { "INSUFFICIENT_FEATURES", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_INSUFFICIENT_FEATURES },
+      { "INSUFFICIENT_LIGHT", VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_INSUFFICIENT_LIGHT },
+  };
+
+template<typename Table>
+const char*
+nameOf(const Table& names, int32_t value)
+{
+    for (const auto& entry : names)
+    {
+        if (entry.value == value)
+        {
+            return entry.name;
+        }
+    }
+    return "UNKNOWN";
+}
+
+template<typename Table, typename T>
+bool
+lookup(const Table& names, const std::string& token, T& value)
+{
+    for (const auto& entry : names)
+    {
+        if (token == entry.name)
+        {
+            value = static_cast<T>(entry.value);
+            return true;
+        }
+    }
+    return false;
+}
+
+VuMatrix44F
+toVu(const glm::mat4& m)
+{
+    VuMatrix44F result;
+    std::memcpy(result.data, glm::value_ptr(m), sizeof(result.data));
+    return result;
+}
+
+glm::mat4
+toGlm(const VuMatrix44F& m)
+{
+    return glm::make_mat4(m.data);
+}
+
+bool
+readPose(std::istringstream& line, VuMatrix44F& pose)
+{
+    for (float& value : pose.data)
+    {
+        if (!(line >> value))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Look up the size of targetName in an image target database (.xml)
+bool
+readTargetSize(const std::string& databasePath, const std::string& targetName, VuVector2F& size)
+{
+    std::ifstream file(gFakeConfig.assetDirectory + "/" + databasePath);
+    if (!file)
+    {
+        return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string xml = contents.str();
+
+    const std::string key = "name=\"" + targetName + "\"";
+    auto pos = xml.find(key);
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    pos = xml.find("size=\"", pos);
+    if (pos == std::string::npos)
+    {
+        return false;
+    }
+    return sscanf(xml.c_str() + pos, "size=\"%f %f\"", &size.data[0], &size.data[1]) == 2;
+}
+}
+
+
+/*===============================================================================
+ Opaque handle types
+ ===============================================================================*/
+
+struct VuEngineConfigSet_
+{
+    VuRenderConfig renderConfig{};
+    VuErrorHandlerConfig errorHandlerConfig{};
+    bool hasLicenseConfig{ false };
+};
+
+struct VuController_
+{
+    VuEngine* engine{ nullptr };
+};
+
+struct VuObserver_
+{
+    VuEngine* engine{ nullptr };
+    int32_t id{ 0 };
+    VuObserverType type{ 0 };
+    std::string targetName;
+    std::string uniqueId;
+    VuVector2F targetSize{};
+    bool active{ false };
+};
+
+struct VuObservation_
+{
+    VuObservationType type{ 0 };
+    const VuObserver* observer{ nullptr };
+    VuPoseInfo poseInfo{};
+    int32_t statusInfo{ 0 };
+};
+
+struct VuObservationList_
+{
+    int32_t size{ 0 };
+    const VuObservation* elements[MAX_OBSERVATIONS]{};
+};
+
+struct VuCameraFrame_
+{
+    int64_t index{ 0 };
+    int64_t timestamp{ 0 };
+};
+
+struct VuState_
+{
+    int refCount{ 0 };
+    bool hasCameraFrame{ false };
+    VuCameraFrame cameraFrame{};
+    VuRenderState renderState{};
+    VuObservation devicePose{};
+    int32_t numImageTargets{ 0 };
+    VuObservation imageTargets[MAX_OBSERVATIONS]{};
+};
+
+struct VuEngine_
+{
+    bool running{ false };
+    VuController cameraController{};
+    VuController renderController{};
+    VuController platformController{};
+    VuErrorHandlerConfig errorHandlerConfig{};
+
+    std::vector<std::unique_ptr<VuObserver>> observers;
+    int32_t nextObserverId{ 1 };
+    int32_t maxSimultaneousTrackedImages{ 1 };
+
+    float nearPlane{ 0.01f };
+    float farPlane{ 5.0f };
+    bool hasRenderViewConfig{ false };
+    VuVector2I resolution{};
+    VuViewOrientation viewOrientation{ VU_VIEW_ORIENTATION_PORTRAIT };
+
+    int64_t acquiredStates{ 0 };
+    /// Last camera frame handed out and its timestamp, repeated acquires of the frame keep it
+    int64_t stampedFrameIndex{ -1 };
+    int64_t stampedTimestamp{ 0 };
+    VuState states[STATE_POOL_SIZE];
+
+    /// Full screen quad used as video background mesh
+    float meshPositions[12]{ -1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, 0 };
+    float meshTexCoords[8]{ 0, 1, 1, 1, 1, 0, 0, 0 };
+    uint32_t meshIndices[6]{ 0, 1, 2, 0, 2, 3 };
+    VuMesh mesh{};
+};
+
+namespace
+{
+VuEngine* gEngine = nullptr;
+
+void
+fillSyntheticFrame(const VuEngine* engine, int64_t frameIndex, StreamFrame& frame)
+{
+    frame.timestamp = frameIndex * SYNTHETIC_FRAME_INTERVAL_NS;
+    frame.devicePoseStatus = VU_OBSERVATION_POSE_STATUS_TRACKED;
+    frame.deviceStatusInfo = VU_DEVICE_POSE_OBSERVATION_STATUS_INFO_NORMAL;
+    frame.devicePose = toVu(glm::mat4(1.0f));
+
+    int32_t numTargets = 0;
+    for (const auto& observer : engine->observers)
+    {
+        if (observer->type == VU_OBSERVER_IMAGE_TARGET_TYPE)
+        {
+            numTargets++;
+        }
+    }
+    if (gFakeConfig.syntheticTargets >= 0 && gFakeConfig.syntheticTargets < numTargets)
+    {
+        numTargets = gFakeConfig.syntheticTargets;
+    }
+
+    frame.targets.resize(numTargets);
+    const float t = static_cast<float>(frameIndex) / 30.0f;
+    int32_t idx = 0;
+    for (const auto& observer : engine->observers)
+    {
+        if (idx == numTargets)
+        {
+            break;
+        }
+        if (observer->type != VU_OBSERVER_IMAGE_TARGET_TYPE)
+        {
+            continue;
+        }
+
+        // Targets side by side 35cm in front of the camera, facing it and slowly wobbling
+        float x = (static_cast<float>(idx) - 0.5f * static_cast<float>(numTargets - 1)) * 0.09f;
+        glm::mat4 pose = glm::translate(glm::mat4(1.0f), glm::vec3(x, 0.01f * std::sin(t + idx), -0.35f));
+        pose = glm::rotate(pose, glm::radians(5.0f * std::sin(0.7f * t + idx)), glm::vec3(1.0f, 0.0f, 0.0f));
+        pose = glm::rotate(pose, glm::radians(5.0f * std::cos(0.5f * t + idx)), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        frame.targets[idx].name = observer->targetName;
+        frame.targets[idx].poseStatus = VU_OBSERVATION_POSE_STATUS_TRACKED;
+        frame.targets[idx].pose = toVu(pose);
+        idx++;
+    }
+}
+
+const VuObserver*
+findActiveImageTarget(const VuEngine* engine, const std::string& name)
+{
+    for (const auto& observer : engine->observers)
+    {
+        if (observer->type == VU_OBSERVER_IMAGE_TARGET_TYPE && observer->active && observer->targetName == name)
+        {
+            return observer.get();
+        }
+    }
+    return nullptr;
+}
+
+const VuObserver*
+findDevicePoseObserver(const VuEngine* engine)
+{
+    for (const auto& observer : engine->observers)
+    {
+        if (observer->type == VU_OBSERVER_DEVICE_POSE_TYPE && observer->active)
+        {
+            return observer.get();
+        }
+    }
+    return nullptr;
+}
+
+void
+fillState(VuEngine* engine, const StreamFrame& frame, int64_t frameIndex, VuState* state)
+{
+    state->hasCameraFrame = true;
+    state->cameraFrame.index = frameIndex;
+    state->cameraFrame.timestamp = frame.timestamp;
+
+    // Render state
+    const float width = static_cast<float>(engine->resolution.data[0]);
+    const float height = static_cast<float>(engine->resolution.data[1]);
+    state->renderState.viewport.data[0] = 0;
+    state->renderState.viewport.data[1] = 0;
+    state->renderState.viewport.data[2] = engine->resolution.data[0];
+    state->renderState.viewport.data[3] = engine->resolution.data[1];
+    state->renderState.vbProjectionMatrix = toVu(glm::mat4(1.0f));
+    state->renderState.vbMesh = engine->hasRenderViewConfig ? &engine->mesh : nullptr;
+    state->renderState.viewMatrix = toVu(glm::inverse(toGlm(frame.devicePose)));
+    state->renderState.projectionMatrix =
+        toVu(glm::perspective(glm::radians(60.0f), height > 0.0f ? width / height : 1.0f, engine->nearPlane, engine->farPlane));
+
+    // Device pose observation
+    state->devicePose.type = VU_OBSERVATION_DEVICE_POSE_TYPE;
+    state->devicePose.observer = findDevicePoseObserver(engine);
+    state->devicePose.poseInfo.poseStatus = frame.devicePoseStatus;
+    state->devicePose.poseInfo.pose = frame.devicePose;
+    state->devicePose.statusInfo = frame.deviceStatusInfo;
+
+    // Image target observations, capped like the real engine
+    state->numImageTargets = 0;
+    for (const auto& target : frame.targets)
+    {
+        if (state->numImageTargets == engine->maxSimultaneousTrackedImages || state->numImageTargets == MAX_OBSERVATIONS)
+        {
+            break;
+        }
+        const VuObserver* observer = findActiveImageTarget(engine, target.name);
+        if (observer == nullptr)
+        {
+            continue;
+        }
+        VuObservation& observation = state->imageTargets[state->numImageTargets++];
+        observation.type = VU_OBSERVATION_IMAGE_TARGET_TYPE;
+        observation.observer = observer;
+        observation.poseInfo.poseStatus = target.poseStatus;
+        observation.poseInfo.pose = target.pose;
+        observation.statusInfo = target.poseStatus == VU_OBSERVATION_POSE_STATUS_NO_POSE ? VU_IMAGE_TARGET_OBSERVATION_STATUS_INFO_NOT_OBSERVED
+                                                                                         : VU_IMAGE_TARGET_OBSERVATION_STATUS_INFO_NORMAL;
+    }
+}
+}
+
+
+/*===============================================================================
+ Fake engine control API
+ ===============================================================================*/
+
+VuResult
+vuFakeEngineLoadStream(const char* path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        LOG("FakeVuforiaEngine: cannot open stream %s", path);
+        return VU_FAILED;
+    }
+
+    std::vector<StreamFrame> stream;
+    std::string text;
+    int lineNumber = 0;
+    while (std::getline(file, text))
+    {
+        lineNumber++;
+        std::istringstream line(text);
+        std::string record;
+        if (!(line >> record) || record[0] == '#')
+        {
+            continue;
+        }
+
+        bool ok = true;
+        if (record == "frame")
+        {
+            stream.emplace_back();
+            stream.back().devicePose = toVu(glm::mat4(1.0f));
+            ok = static_cast<bool>(line >> stream.back().timestamp);
+        }
+        else if (stream.empty())
+        {
+            ok = false;
+        }
+        else if (record == "device")
+        {
+            std::string status, info;
+            ok = (line >> status >> info) && lookup(POSE_STATUS_NAMES, status, stream.back().devicePoseStatus) &&
+                 lookup(DEVICE_STATUS_INFO_NAMES, info, stream.back().deviceStatusInfo) && readPose(line, stream.back().devicePose);
+        }
+        else if (record == "target")
+        {
+            StreamTarget target;
+            std::string status;
+            ok = (line >> target.name >> status) && lookup(POSE_STATUS_NAMES, status, target.poseStatus) && readPose(line, target.pose);
+            if (ok)
+            {
+                stream.back().targets.push_back(std::move(target));
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            LOG("FakeVuforiaEngine: %s:%d: malformed record", path, lineNumber);
+            return VU_FAILED;
+        }
+    }
+
+    if (stream.empty())
+    {
+        LOG("FakeVuforiaEngine: %s contains no frames", path);
+        return VU_FAILED;
+    }
+
+    gFakeConfig.stream = std::move(stream);
+    LOG("FakeVuforiaEngine: loaded %zu frames from %s", gFakeConfig.stream.size(), path);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuFakeEngineSaveStream(const char* path, int32_t numFrames)
+{
+    if (gFakeConfig.stream.empty() && gEngine == nullptr)
+    {
+        LOG("FakeVuforiaEngine: a synthetic stream can only be saved once the observers are created");
+        return VU_FAILED;
+    }
+
+    std::ofstream file(path);
+    if (!file)
+    {
+        return VU_FAILED;
+    }
+
+    auto writePose = [&file](const VuMatrix44F& pose) {
+        for (float value : pose.data)
+        {
+            file << ' ' << value;
+        }
+        file << '\n';
+    };
+
+    // Enough digits for the poses to round-trip exactly
+    file.precision(9);
+    file << "# VideoPhotoBook fake Vuforia observation stream\n";
+    int32_t count = gFakeConfig.stream.empty() ? numFrames : static_cast<int32_t>(gFakeConfig.stream.size());
+    StreamFrame synthetic;
+    for (int32_t idx = 0; idx < count; idx++)
+    {
+        const StreamFrame* frame = &synthetic;
+        if (gFakeConfig.stream.empty())
+        {
+            fillSyntheticFrame(gEngine, idx, synthetic);
+        }
+        else
+        {
+            frame = &gFakeConfig.stream[idx];
+        }
+
+        file << "frame " << frame->timestamp << '\n';
+        file << "device " << nameOf(POSE_STATUS_NAMES, frame->devicePoseStatus) << ' '
+             << nameOf(DEVICE_STATUS_INFO_NAMES, frame->deviceStatusInfo);
+        writePose(frame->devicePose);
+        for (const auto& target : frame->targets)
+        {
+            file << "target " << target.name << ' ' << nameOf(POSE_STATUS_NAMES, target.poseStatus);
+            writePose(target.pose);
+        }
+    }
+    return file ? VU_SUCCESS : VU_FAILED;
+}
+
+
+void
+vuFakeEngineSetSyntheticStream(int32_t numTargets)
+{
+    gFakeConfig.stream.clear();
+    gFakeConfig.syntheticTargets = numTargets;
+}
+
+
+void
+vuFakeEngineSetCameraFrameRepeat(int32_t acquiresPerFrame)
+{
+    gFakeConfig.cameraFrameRepeat = std::max(acquiresPerFrame, 1);
+}
+
+
+void
+vuFakeEngineSetCaptureAge(int64_t captureAgeNs)
+{
+    gFakeConfig.captureAgeNs = captureAgeNs;
+}
+
+
+void
+vuFakeEngineSetAssetDirectory(const char* path)
+{
+    gFakeConfig.assetDirectory = path;
+}
+
+
+int64_t
+vuFakeEngineGetAcquiredStateCount()
+{
+    return gEngine != nullptr ? gEngine->acquiredStates : 0;
+}
+
+
+/*===============================================================================
+ Engine configuration
+ ===============================================================================*/
+
+VuResult
+vuEngineConfigSetCreate(VuEngineConfigSet** configSet)
+{
+    *configSet = new VuEngineConfigSet;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuEngineConfigSetDestroy(VuEngineConfigSet* configSet)
+{
+    delete configSet;
+    return VU_SUCCESS;
+}
+
+
+VuLicenseConfig
+vuLicenseConfigDefault()
+{
+    VuLicenseConfig config;
+    config.key = "";
+    return config;
+}
+
+
+VuResult
+vuEngineConfigSetAddLicenseConfig(VuEngineConfigSet* configSet, const VuLicenseConfig* config)
+{
+    if (config->key == nullptr)
+    {
+        return VU_FAILED;
+    }
+    configSet->hasLicenseConfig = true;
+    return VU_SUCCESS;
+}
+
+
+VuRenderConfig
+vuRenderConfigDefault()
+{
+    VuRenderConfig config;
+    config.vbRenderBackend = VU_RENDER_VB_BACKEND_DEFAULT;
+    config.vbViewportMode = VU_VIDEOBG_VIEWPORT_MODE_SCALE_TO_FILL;
+    return config;
+}
+
+
+VuResult
+vuEngineConfigSetAddRenderConfig(VuEngineConfigSet* configSet, const VuRenderConfig* config)
+{
+    configSet->renderConfig = *config;
+    return VU_SUCCESS;
+}
+
+
+VuErrorHandlerConfig
+vuErrorHandlerConfigDefault()
+{
+    VuErrorHandlerConfig config;
+    config.errorHandler = nullptr;
+    config.clientData = nullptr;
+    return config;
+}
+
+
+VuResult
+vuEngineConfigSetAddErrorHandlerConfig(VuEngineConfigSet* configSet, const VuErrorHandlerConfig* config)
+{
+    configSet->errorHandlerConfig = *config;
+    return VU_SUCCESS;
+}
+
+
+/*===============================================================================
+ Engine lifecycle
+ ===============================================================================*/
+
+VuResult
+vuEngineCreate(VuEngine** engine, const VuEngineConfigSet* configSet, VuErrorCode* errorCode)
+{
+    if (gEngine != nullptr || configSet == nullptr)
+    {
+        if (errorCode != nullptr)
+        {
+            *errorCode = VU_ENGINE_CREATION_ERROR_INITIALIZATION;
+        }
+        return VU_FAILED;
+    }
+
+    if (gFakeConfig.stream.empty() && gFakeConfig.syntheticTargets < 0)
+    {
+        if (const char* streamPath = getenv("VPB_FAKE_VUFORIA_STREAM"))
+        {
+            vuFakeEngineLoadStream(streamPath);
+        }
+    }
+
+    gEngine = new VuEngine;
+    gEngine->cameraController.engine = gEngine;
+    gEngine->renderController.engine = gEngine;
+    gEngine->platformController.engine = gEngine;
+    gEngine->errorHandlerConfig = configSet->errorHandlerConfig;
+    gEngine->mesh.numVertices = 4;
+    gEngine->mesh.pos = gEngine->meshPositions;
+    gEngine->mesh.tex = gEngine->meshTexCoords;
+    gEngine->mesh.normal = nullptr;
+    gEngine->mesh.numFaces = 2;
+    gEngine->mesh.faceIndices = gEngine->meshIndices;
+
+    *engine = gEngine;
+    if (errorCode != nullptr)
+    {
+        *errorCode = VU_ENGINE_CREATION_ERROR_NONE;
+    }
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuEngineDestroy(VuEngine* engine)
+{
+    if (engine == nullptr || engine != gEngine)
+    {
+        return VU_FAILED;
+    }
+    delete engine;
+    gEngine = nullptr;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuEngineStart(VuEngine* engine)
+{
+    if (engine->running)
+    {
+        return VU_FAILED;
+    }
+    engine->running = true;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuEngineStop(VuEngine* engine)
+{
+    if (!engine->running)
+    {
+        return VU_FAILED;
+    }
+    engine->running = false;
+    for (auto& observer : engine->observers)
+    {
+        observer->active = false;
+    }
+    return VU_SUCCESS;
+}
+
+
+VuBool
+vuEngineIsRunning(const VuEngine* engine)
+{
+    return engine->running ? VU_TRUE : VU_FALSE;
+}
+
+
+VuResult
+vuEngineResetWorldTracking(VuEngine* engine)
+{
+    return engine->running ? VU_SUCCESS : VU_FAILED;
+}
+
+
+/*===============================================================================
+ Controllers
+ ===============================================================================*/
+
+VuResult
+vuEngineGetCameraController(const VuEngine* engine, VuController** controller)
+{
+    *controller = const_cast<VuController*>(&engine->cameraController);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuCameraControllerSetActiveVideoMode(VuController* /*controller*/, VuCameraVideoModePreset /*cameraVideoModePreset*/)
+{
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuCameraControllerSetFocusMode(VuController* controller, VuCameraFocusMode /*focusMode*/)
+{
+    return controller->engine->running ? VU_SUCCESS : VU_FAILED;
+}
+
+
+VuResult
+vuEngineGetPlatformController(const VuEngine* engine, VuController** controller)
+{
+    *controller = const_cast<VuController*>(&engine->platformController);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuPlatformControllerConvertPlatformViewOrientation(const VuController* /*controller*/, const void* /*platformOrientation*/,
+                                                   VuViewOrientation* vuOrientation)
+{
+    // There is no platform view on the host, every descriptor maps to portrait
+    *vuOrientation = VU_VIEW_ORIENTATION_PORTRAIT;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuPlatformControllerSetViewOrientation(VuController* controller, VuViewOrientation orientation)
+{
+    controller->engine->viewOrientation = orientation;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuPlatformControllerGetFusionProviderPlatformType(const VuController* /*controller*/, VuFusionProviderPlatformType* fusionProviderPlatformType)
+{
+    *fusionProviderPlatformType = VU_FUSION_PROVIDER_PLATFORM_TYPE_UNKNOWN;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuEngineGetRenderController(const VuEngine* engine, VuController** controller)
+{
+    *controller = const_cast<VuController*>(&engine->renderController);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuRenderControllerSetRenderViewConfig(VuController* controller, const VuRenderViewConfig* renderViewConfig)
+{
+    if (renderViewConfig->resolution.data[0] <= 0 || renderViewConfig->resolution.data[1] <= 0)
+    {
+        return VU_FAILED;
+    }
+    controller->engine->resolution = renderViewConfig->resolution;
+    controller->engine->hasRenderViewConfig = true;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuRenderControllerGetVideoBackgroundViewInfo(const VuController* controller, VuVideoBackgroundViewInfo* vbViewInfo)
+{
+    const VuEngine* engine = controller->engine;
+    if (!engine->hasRenderViewConfig)
+    {
+        return VU_FAILED;
+    }
+    vbViewInfo->viewport.data[0] = 0;
+    vbViewInfo->viewport.data[1] = 0;
+    vbViewInfo->viewport.data[2] = engine->resolution.data[0];
+    vbViewInfo->viewport.data[3] = engine->resolution.data[1];
+    vbViewInfo->cameraImageSize = engine->resolution;
+    vbViewInfo->vBTextureSize = engine->resolution;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuRenderControllerUpdateVideoBackgroundTexture(VuController* /*controller*/, const VuState* state,
+                                               const VuRenderVideoBackgroundData* /*renderData*/)
+{
+    // Nothing to upload, there is no camera image on the host
+    return state != nullptr && state->hasCameraFrame ? VU_SUCCESS : VU_FAILED;
+}
+
+
+VuResult
+vuRenderControllerSetProjectionMatrixNearFar(VuController* controller, float nearPlane, float farPlane)
+{
+    if (nearPlane <= 0.0f || farPlane <= nearPlane)
+    {
+        return VU_FAILED;
+    }
+    controller->engine->nearPlane = nearPlane;
+    controller->engine->farPlane = farPlane;
+    return VU_SUCCESS;
+}
+
+
+/*===============================================================================
+ Observers
+ ===============================================================================*/
+
+int32_t
+vuObserverGetId(const VuObserver* observer)
+{
+    return observer->id;
+}
+
+
+VuResult
+vuObserverActivate(VuObserver* observer)
+{
+    observer->active = true;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuObserverDeactivate(VuObserver* observer)
+{
+    observer->active = false;
+    return VU_SUCCESS;
+}
+
+
+VuBool
+vuObserverIsActivated(const VuObserver* observer)
+{
+    return observer->active ? VU_TRUE : VU_FALSE;
+}
+
+
+VuResult
+vuObserverDestroy(VuObserver* observer)
+{
+    auto& observers = observer->engine->observers;
+    for (auto it = observers.begin(); it != observers.end(); ++it)
+    {
+        if (it->get() == observer)
+        {
+            observers.erase(it);
+            return VU_SUCCESS;
+        }
+    }
+    return VU_FAILED;
+}
+
+
+VuDevicePoseConfig
+vuDevicePoseConfigDefault()
+{
+    VuDevicePoseConfig config;
+    config.activate = VU_TRUE;
+    config.staticMode = VU_FALSE;
+    return config;
+}
+
+
+VuResult
+vuEngineCreateDevicePoseObserver(VuEngine* engine, VuObserver** observer, const VuDevicePoseConfig* config,
+                                 VuDevicePoseCreationError* errorCode)
+{
+    auto newObserver = std::make_unique<VuObserver>();
+    newObserver->engine = engine;
+    newObserver->id = engine->nextObserverId++;
+    newObserver->type = VU_OBSERVER_DEVICE_POSE_TYPE;
+    newObserver->active = config->activate == VU_TRUE;
+
+    *observer = newObserver.get();
+    engine->observers.push_back(std::move(newObserver));
+    if (errorCode != nullptr)
+    {
+        *errorCode = VU_DEVICE_POSE_CREATION_ERROR_NONE;
+    }
+    return VU_SUCCESS;
+}
+
+
+VuImageTargetConfig
+vuImageTargetConfigDefault()
+{
+    VuImageTargetConfig config;
+    config.databasePath = nullptr;
+    config.targetName = nullptr;
+    config.activate = VU_TRUE;
+    config.scale = 1.0f;
+    config.poseOffset = toVu(glm::mat4(1.0f));
+    return config;
+}
+
+
+VuResult
+vuEngineCreateImageTargetObserver(VuEngine* engine, VuObserver** observer, const VuImageTargetConfig* config,
+                                  VuImageTargetCreationError* errorCode)
+{
+    if (config->databasePath == nullptr || config->targetName == nullptr)
+    {
+        if (errorCode != nullptr)
+        {
+            *errorCode = VU_IMAGE_TARGET_CREATION_ERROR_INTERNAL;
+        }
+        return VU_FAILED;
+    }
+
+    auto newObserver = std::make_unique<VuObserver>();
+    newObserver->engine = engine;
+    newObserver->id = engine->nextObserverId++;
+    newObserver->type = VU_OBSERVER_IMAGE_TARGET_TYPE;
+    newObserver->targetName = config->targetName;
+    newObserver->uniqueId = std::string(config->databasePath) + ":" + config->targetName;
+    newObserver->active = config->activate == VU_TRUE;
+    if (!readTargetSize(config->databasePath, config->targetName, newObserver->targetSize))
+    {
+        LOG("FakeVuforiaEngine: no size for %s in %s, assuming 10cm", config->targetName, config->databasePath);
+        newObserver->targetSize.data[0] = 0.1f;
+        newObserver->targetSize.data[1] = 0.1f;
+    }
+    newObserver->targetSize.data[0] *= config->scale;
+    newObserver->targetSize.data[1] *= config->scale;
+
+    *observer = newObserver.get();
+    engine->observers.push_back(std::move(newObserver));
+    if (errorCode != nullptr)
+    {
+        *errorCode = VU_IMAGE_TARGET_CREATION_ERROR_NONE;
+    }
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuImageTargetObserverGetTargetUniqueId(const VuObserver* observer, const char** targetId)
+{
+    if (observer->type != VU_OBSERVER_IMAGE_TARGET_TYPE)
+    {
+        return VU_FAILED;
+    }
+    *targetId = observer->uniqueId.c_str();
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuImageTargetObserverGetTargetName(const VuObserver* observer, const char** targetName)
+{
+    if (observer->type != VU_OBSERVER_IMAGE_TARGET_TYPE)
+    {
+        return VU_FAILED;
+    }
+    *targetName = observer->targetName.c_str();
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuImageTargetObserverGetTargetSize(const VuObserver* observer, VuVector2F* size)
+{
+    if (observer->type != VU_OBSERVER_IMAGE_TARGET_TYPE)
+    {
+        return VU_FAILED;
+    }
+    *size = observer->targetSize;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuEngineSetMaximumSimultaneousTrackedImages(VuEngine* engine, int32_t maxNumberOfTargets)
+{
+    if (maxNumberOfTargets < 1)
+    {
+        return VU_FAILED;
+    }
+    engine->maxSimultaneousTrackedImages = maxNumberOfTargets;
+    return VU_SUCCESS;
+}
+
+
+/*===============================================================================
+ State and observations
+ ===============================================================================*/
+
+VuResult
+vuEngineAcquireLatestState(const VuEngine* engine, VuState** state)
+{
+    VuEngine* mutableEngine = const_cast<VuEngine*>(engine);
+
+    VuState* freeState = nullptr;
+    for (auto& pooled : mutableEngine->states)
+    {
+        if (pooled.refCount == 0)
+        {
+            freeState = &pooled;
+            break;
+        }
+    }
+    if (freeState == nullptr)
+    {
+        LOG("FakeVuforiaEngine: all %d states are held by the client", STATE_POOL_SIZE);
+        return VU_FAILED;
+    }
+
+    const int64_t frameIndex = mutableEngine->acquiredStates++ / gFakeConfig.cameraFrameRepeat;
+    if (gFakeConfig.stream.empty())
+    {
+        // Reused across calls so that the steady state does not allocate
+        static StreamFrame syntheticFrame;
+        fillSyntheticFrame(engine, frameIndex, syntheticFrame);
+        fillState(mutableEngine, syntheticFrame, frameIndex, freeState);
+    }
+    else
+    {
+        const auto& frame = gFakeConfig.stream[frameIndex % gFakeConfig.stream.size()];
+        fillState(mutableEngine, frame, frameIndex, freeState);
+    }
+
+    // Camera clock: steady_clock as on Android, stamped once per camera frame
+    if (gFakeConfig.captureAgeNs >= 0)
+    {
+        if (frameIndex != mutableEngine->stampedFrameIndex)
+        {
+            const auto now = std::chrono::steady_clock::now().time_since_epoch();
+            mutableEngine->stampedFrameIndex = frameIndex;
+            mutableEngine->stampedTimestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count() - gFakeConfig.captureAgeNs;
+        }
+        freeState->cameraFrame.timestamp = mutableEngine->stampedTimestamp;
+    }
+
+    freeState->refCount = 1;
+    *state = freeState;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuStateRelease(VuState* state)
+{
+    if (state == nullptr || state->refCount <= 0)
+    {
+        return VU_FAILED;
+    }
+    state->refCount--;
+    return VU_SUCCESS;
+}
+
+
+VuBool
+vuStateHasCameraFrame(const VuState* state)
+{
+    return state->hasCameraFrame ? VU_TRUE : VU_FALSE;
+}
+
+
+VuResult
+vuStateGetCameraFrame(const VuState* state, VuCameraFrame** cameraFrame)
+{
+    if (!state->hasCameraFrame)
+    {
+        return VU_FAILED;
+    }
+    *cameraFrame = const_cast<VuCameraFrame*>(&state->cameraFrame);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuCameraFrameGetIndex(const VuCameraFrame* cameraFrame, int64_t* index)
+{
+    *index = cameraFrame->index;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuCameraFrameGetTimestamp(const VuCameraFrame* cameraFrame, int64_t* timestamp)
+{
+    *timestamp = cameraFrame->timestamp;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuStateGetRenderState(const VuState* state, VuRenderState* renderState)
+{
+    *renderState = state->renderState;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuObservationListCreate(VuObservationList** list)
+{
+    *list = new VuObservationList;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuObservationListGetSize(const VuObservationList* list, int32_t* listSize)
+{
+    *listSize = list->size;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuObservationListGetElement(const VuObservationList* list, int32_t element, VuObservation** observation)
+{
+    if (element < 0 || element >= list->size)
+    {
+        return VU_FAILED;
+    }
+    *observation = const_cast<VuObservation*>(list->elements[element]);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuObservationListDestroy(VuObservationList* list)
+{
+    delete list;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuStateGetImageTargetObservations(const VuState* state, VuObservationList* list)
+{
+    list->size = 0;
+    for (int32_t idx = 0; idx < state->numImageTargets; idx++)
+    {
+        list->elements[list->size++] = &state->imageTargets[idx];
+    }
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuStateGetDevicePoseObservations(const VuState* state, VuObservationList* list)
+{
+    list->size = 0;
+    if (state->devicePose.observer != nullptr)
+    {
+        list->elements[list->size++] = &state->devicePose;
+    }
+    return VU_SUCCESS;
+}
+
+
+VuBool
+vuObservationIsType(const VuObservation* observation, VuObservationType observationType)
+{
+    return observation->type == observationType ? VU_TRUE : VU_FALSE;
+}
+
+
+int32_t
+vuObservationGetObserverId(const VuObservation* observation)
+{
+    return observation->observer->id;
+}
+
+
+VuBool
+vuObservationHasPoseInfo(const VuObservation* /*observation*/)
+{
+    return VU_TRUE;
+}
+
+
+VuResult
+vuObservationGetPoseInfo(const VuObservation* observation, VuPoseInfo* poseInfo)
+{
+    *poseInfo = observation->poseInfo;
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuImageTargetObservationGetTargetInfo(const VuObservation* observation, VuImageTargetObservationTargetInfo* targetInfo)
+{
+    if (observation->type != VU_OBSERVATION_IMAGE_TARGET_TYPE)
+    {
+        return VU_FAILED;
+    }
+    const VuObserver* observer = observation->observer;
+    targetInfo->uniqueId = observer->uniqueId.c_str();
+    targetInfo->name = observer->targetName.c_str();
+    targetInfo->size = observer->targetSize;
+    targetInfo->bbox.center = VuVector3F{ { 0.0f, 0.0f, 0.0f } };
+    targetInfo->bbox.extent = VuVector3F{ { 0.5f * observer->targetSize.data[0], 0.5f * observer->targetSize.data[1], 0.0f } };
+    targetInfo->poseOffset = toVu(glm::mat4(1.0f));
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuImageTargetObservationGetStatusInfo(const VuObservation* observation, VuImageTargetObservationStatusInfo* statusInfo)
+{
+    if (observation->type != VU_OBSERVATION_IMAGE_TARGET_TYPE)
+    {
+        return VU_FAILED;
+    }
+    *statusInfo = static_cast<VuImageTargetObservationStatusInfo>(observation->statusInfo);
+    return VU_SUCCESS;
+}
+
+
+VuResult
+vuDevicePoseObservationGetStatusInfo(const VuObservation* observation, VuDevicePoseObservationStatusInfo* statusInfo)
+{
+    if (observation->type != VU_OBSERVATION_DEVICE_POSE_TYPE)
+    {
+        return VU_FAILED;
+    }
+    *statusInfo = static_cast<VuDevicePoseObservationStatusInfo>(observation->statusInfo);
+    return VU_SUCCESS;
+}
+
+
+/*===============================================================================
+ Math utilities
+ ===============================================================================*/
+
+VuMatrix44F
+vuIdentityMatrix44F()
+{
+    return toVu(glm::mat4(1.0f));
+}
+
+
+VuMatrix44F
+vuMatrix44FMultiplyMatrix(VuMatrix44F mA, VuMatrix44F mB)
+{
+    return toVu(toGlm(mA) * toGlm(mB));
+}
+
+
+VuMatrix44F
+vuMatrix44FScale(VuVector3F scale, VuMatrix44F m)
+{
+    return toVu(glm::scale(toGlm(m), glm::vec3(scale.data[0], scale.data[1], scale.data[2])));
+}
+
+
+VuMatrix44F
+vuMatrix44FInverse(VuMatrix44F m)
+{
+    return toVu(glm::inverse(toGlm(m)));
+}
+
+
+VuMatrix44F
+vuMatrix44FTranspose(VuMatrix44F m)
+{
+    return toVu(glm::transpose(toGlm(m)));
+}
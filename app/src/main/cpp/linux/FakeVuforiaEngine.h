@@ -0,0 +1,76 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#ifndef __FAKEVUFORIAENGINE_H__
+#define __FAKEVUFORIAENGINE_H__
+
+#include <VuforiaEngine/VuforiaEngine.h>
+
+/// Control API of the Linux stand-in for libVuforiaEngine.
+/**
+ * The fake engine implements the subset of the Vuforia Engine C API used by AppController and the
+ * render loop. Instead of a camera it plays back an observation stream, one stream frame per
+ * vuEngineAcquireLatestState call (or per vuFakeEngineSetCameraFrameRepeat calls), looping at the end of the stream.
+ *
+ * Streams are plain text, one record per line ('#' starts a comment):
+ *
+ *     frame <timestamp ns>
+ *     device <pose status> <status info> <16 floats, column-major pose>
+ *     target <target name> <pose status> <16 floats, column-major pose>
+ *
+ * Pose status is one of NO_POSE, LIMITED, TRACKED, EXTENDED_TRACKED and the device status info one of
+ * NORMAL, NOT_OBSERVED, UNKNOWN, INITIALIZING, RELOCALIZING, EXCESSIVE_MOTION, INSUFFICIENT_FEATURES,
+ * INSUFFICIENT_LIGHT. A frame without a device record reports an identity device pose.
+ * Recorded sessions use the same format, see vuFakeEngineSaveStream.
+ *
+ * By default the camera frames are not stamped with the stream timestamps but with steady_clock, as on
+ * Android where the camera clock is CLOCK_MONOTONIC, see vuFakeEngineSetCaptureAge.
+ *
+ * If no stream is configured the VPB_FAKE_VUFORIA_STREAM environment variable is consulted, and
+ * failing that a synthetic stream with all created image targets in view is generated.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Load an observation stream from a file. Must be called before vuEngineCreate.
+VU_API VuResult VU_API_CALL vuFakeEngineLoadStream(const char* path);
+
+/// Write the currently configured stream to a file (numFrames frames for a synthetic stream)
+VU_API VuResult VU_API_CALL vuFakeEngineSaveStream(const char* path, int32_t numFrames);
+
+/// Generate a synthetic stream where numTargets image targets (in creation order) are tracked
+/**
+ * The targets are laid out side by side in front of the camera and slowly wobble so that every frame
+ * carries a distinct pose. Camera frames are 33ms apart.
+ */
+VU_API void VU_API_CALL vuFakeEngineSetSyntheticStream(int32_t numTargets);
+
+/// Hand out every camera frame for acquiresPerFrame vuEngineAcquireLatestState calls (default 1)
+/**
+ * Simulates a display running faster than the camera, e.g. 2 for a 60Hz display with a 30Hz camera: as
+ * with the real engine, the repeated states carry the same camera frame index and timestamp.
+ */
+VU_API void VU_API_CALL vuFakeEngineSetCameraFrameRepeat(int32_t acquiresPerFrame);
+
+/// Stamp every camera frame captureAgeNs before the steady_clock time of its first acquire (default 20ms)
+/**
+ * Gives the camera-to-display latency (LatencyStats CAMERA_AGE and TOTAL) something to measure on the
+ * host. A negative age stamps the frames with the stream timestamps instead, which the stream poses
+ * move by: needed to extrapolate the poses when the frames are acquired faster than in real time.
+ */
+VU_API void VU_API_CALL vuFakeEngineSetCaptureAge(int64_t captureAgeNs);
+
+/// Directory against which image target database paths are resolved (to read the target sizes)
+VU_API void VU_API_CALL vuFakeEngineSetAssetDirectory(const char* path);
+
+/// Number of states acquired since the engine was created
+VU_API int64_t VU_API_CALL vuFakeEngineGetAcquiredStateCount();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __FAKEVUFORIAENGINE_H__
@@ -0,0 +1,219 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "CpuTopology.h"
+#include "Log.h"
+#include "ThreadRoles.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/// Render thread jitter with and without ThreadRoles, under CPU load from other threads.
+/**
+ * A frame loop stands in for the GL thread: it sleeps until the next vsync deadline, does a fixed
+ * amount of work (calibrated to -w ms on an idle machine) and records how late it woke up and how late
+ * the work finished. Noise threads, standing in for coroutines and decoder threads, spin on the CPUs
+ * meanwhile. The loop runs twice: once with every thread left as created, once with the frame loop as
+ * ThreadRole::RENDER and the noise as ThreadRole::BACKGROUND. Percentiles of both runs and the CPU
+ * time per role of the second one (ThreadRoles::formatUsage) are printed.
+ *
+ * Raising the render priority needs CAP_SYS_NICE on Linux (root), without it only the noise is lowered.
+ * Fails if the role API does not work: a thread that burned CPU under a role must be counted under it.
+ *
+ * usage: vpb_jitterbench [-s seconds per run] [-n noise threads] [-p frame period ms] [-w frame work ms]
+ */
+
+namespace
+{
+struct JitterOptions
+{
+    float seconds{ 3.0f };
+    /// -1: two per CPU
+    int noiseThreads{ -1 };
+    float periodMs{ 16.667f };
+    float workMs{ 4.0f };
+};
+
+/// Wake-up and finish lateness of one run (ms), sorted
+struct JitterResult
+{
+    std::vector<float> wakeLate;
+    std::vector<float> finishLate;
+    /// ThreadRoles::formatUsage() at the end of the run, while all its threads are alive
+    std::string usage;
+};
+
+volatile uint64_t gSink;
+
+/// Work of a frame: a dependent multiply chain the compiler cannot shorten
+void
+spinWork(uint64_t iterations)
+{
+    uint64_t value = 1;
+    for (uint64_t idx = 0; idx < iterations; idx++)
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+    gSink = value;
+}
+
+/// Iterations of spinWork that take ms on this machine without load
+uint64_t
+calibrateWork(float ms)
+{
+    constexpr uint64_t PROBE_ITERATIONS = 1 << 22;
+    double bestNs = 1e30;
+    for (int run = 0; run < 5; run++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        spinWork(PROBE_ITERATIONS);
+        bestNs = std::min(bestNs, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    return static_cast<uint64_t>(PROBE_ITERATIONS * (ms * 1e6 / bestNs));
+}
+
+JitterResult
+runFrames(const JitterOptions& options, uint64_t workIterations, bool useRoles)
+{
+    std::atomic<bool> running{ true };
+    std::vector<std::thread> noise;
+    for (int idx = 0; idx < options.noiseThreads; idx++)
+    {
+        noise.emplace_back([&running, useRoles] {
+            if (useRoles)
+                ThreadRoles::assign(ThreadRole::BACKGROUND);
+            while (running.load(std::memory_order_relaxed))
+                spinWork(10000);
+        });
+    }
+
+    JitterResult result;
+    std::thread frameLoop([&] {
+        if (useRoles)
+            ThreadRoles::assign(ThreadRole::RENDER);
+        const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float, std::milli>(options.periodMs));
+        const int numFrames = static_cast<int>(options.seconds * 1000.0f / options.periodMs);
+        auto deadline = std::chrono::steady_clock::now() + period;
+        for (int frame = 0; frame < numFrames; frame++, deadline += period)
+        {
+            std::this_thread::sleep_until(deadline);
+            const auto woke = std::chrono::steady_clock::now();
+            spinWork(workIterations);
+            const auto finished = std::chrono::steady_clock::now();
+            result.wakeLate.push_back(std::chrono::duration<float, std::milli>(woke - deadline).count());
+            result.finishLate.push_back(std::chrono::duration<float, std::milli>(finished - deadline).count());
+            /* 1周期以上遅れたら次の締め切りを今に合わせる(遅れの連鎖を数えない) */
+            if (finished > deadline + period)
+                deadline = finished - period;
+        }
+        result.usage = ThreadRoles::formatUsage();
+    });
+    frameLoop.join();
+    running = false;
+    for (std::thread& thread : noise)
+        thread.join();
+
+    std::sort(result.wakeLate.begin(), result.wakeLate.end());
+    std::sort(result.finishLate.begin(), result.finishLate.end());
+    return result;
+}
+
+float
+percentile(const std::vector<float>& sorted, float fraction)
+{
+    if (sorted.empty())
+        return 0.0f;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+
+void
+printResult(const char* label, const JitterResult& result, float periodMs)
+{
+    const long missed = std::count_if(result.finishLate.begin(), result.finishLate.end(), [periodMs](float late) { return late > periodMs; });
+    printf("%-12s wake  p50 %7.3f  p99 %7.3f  max %7.3f ms\n", label, percentile(result.wakeLate, 0.5f),
+           percentile(result.wakeLate, 0.99f), result.wakeLate.empty() ? 0.0f : result.wakeLate.back());
+    printf("%-12s done  p50 %7.3f  p99 %7.3f  max %7.3f ms, %ld of %zu frames past the next vsync\n", "", percentile(result.finishLate, 0.5f),
+           percentile(result.finishLate, 0.99f), result.finishLate.empty() ? 0.0f : result.finishLate.back(), missed, result.finishLate.size());
+}
+
+/// A thread that burns CPU under a role is counted under that role
+bool
+checkRoleUsage()
+{
+    std::thread worker([] {
+        ThreadRoles::assign(ThreadRole::WORKER);
+        const auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+        while (std::chrono::steady_clock::now() < end)
+            spinWork(10000);
+
+        ThreadRoles::Usage usage[ThreadRoles::ROLE_COUNT + 1];
+        ThreadRoles::getUsage(usage);
+        const ThreadRoles::Usage& workers = usage[static_cast<int>(ThreadRole::WORKER)];
+        gSink = workers.numThreads >= 1 && workers.cpuSeconds >= 0.1 && ThreadRoles::getCurrentRole() == ThreadRole::WORKER;
+    });
+    worker.join();
+    return gSink != 0;
+}
+
+bool
+parseOptions(int argc, char** argv, JitterOptions& options)
+{
+    for (int idx = 1; idx + 1 < argc; idx += 2)
+    {
+        const char* value = argv[idx + 1];
+        if (strcmp(argv[idx], "-s") == 0)
+            options.seconds = static_cast<float>(atof(value));
+        else if (strcmp(argv[idx], "-n") == 0)
+            options.noiseThreads = atoi(value);
+        else if (strcmp(argv[idx], "-p") == 0)
+            options.periodMs = static_cast<float>(atof(value));
+        else if (strcmp(argv[idx], "-w") == 0)
+            options.workMs = static_cast<float>(atof(value));
+        else
+            return false;
+    }
+    return (argc % 2) == 1 && options.seconds > 0.0f && options.periodMs > 0.0f && options.workMs >= 0.0f;
+}
+}
+
+
+int
+main(int argc, char** argv)
+{
+    JitterOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        LOG("usage: %s [-s seconds per run] [-n noise threads] [-p frame period ms] [-w frame work ms]", argv[0]);
+        return 1;
+    }
+    const CpuTopology& topology = CpuTopology::get();
+    if (options.noiseThreads < 0)
+        options.noiseThreads = 2 * topology.numCpus;
+
+    if (!checkRoleUsage())
+    {
+        LOG("ThreadRoles: the CPU time of a worker thread was not counted under its role");
+        return 1;
+    }
+
+    const uint64_t workIterations = calibrateWork(options.workMs);
+    printf("%d cpus (%d big, %d little), %d noise threads, %.2f ms frames with %.2f ms of work, %.1f s per run\n", topology.numCpus,
+           topology.numBigCpus, topology.numLittleCpus, options.noiseThreads, options.periodMs, options.workMs, options.seconds);
+
+    const JitterResult unassigned = runFrames(options, workIterations, false);
+    printResult("no roles", unassigned, options.periodMs);
+    const JitterResult assigned = runFrames(options, workIterations, true);
+    printResult("ThreadRoles", assigned, options.periodMs);
+    printf("p99 finish lateness %.2fx lower with roles\n",
+           percentile(unassigned.finishLate, 0.99f) / std::max(percentile(assigned.finishLate, 0.99f), 1e-3f));
+
+    printf("%s", assigned.usage.c_str());
+    return 0;
+}
@@ -0,0 +1,539 @@
+/*===============================================================================
+Copyright (c) 2025 Jun. All rights reserved.
+===============================================================================*/
+
+#include "FakeVuforiaEngine.h"
+
+#include "AllocationTracker.h"
+#include "AppController.h"
+#include "AssetSource.h"
+#include "FrameLoop.h"
+#include "FrameMetrics.h"
+#include "FrameResult.h"
+#include "HitTest.h"
+#include "InitPipeline.h"
+#include "JobSystem.h"
+#include "LatencyStats.h"
+#include "Log.h"
+#include "QuadGeometry.h"
+#include "RayHitTester.h"
+#include "StartupTimeline.h"
+#include "ThreadRoles.h"
+#include "TrackingThread.h"
+#include "Tracer.h"
+
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/// Headless replay of the renderFrame path against the fake Vuforia Engine.
+/**
+ * Runs initAR/startAR/configureRendering and then, per frame, FrameLoop::renderFrame as the renderFrame JNI
+ * entry does: updateTrackingFrame (or the latest frame of the TrackingThread with -T 1), prepareToRender and
+ * the target loop with the hit test quad update. The draws go to a FrameRenderer without GL, so the timings
+ * are the CPU cost of the frame bookkeeping.
+ *
+ * With -p the target poses are extrapolated by the given number of camera frames as renderFrame does with
+ * setPosePrediction, and the overlay lag is measured: the pose drawn for camera frame i (as tracked and as
+ * predicted) is compared with the pose tracked at frame i + latency frames, i.e. the pose the target has
+ * when the overlay reaches the display. Errors are the target center offset in screen pixels and the
+ * rotation in degrees. With -T 1 only the camera frames the render thread picked up are compared. The poses
+ * drawn without a motion estimate (not extrapolated) are counted too. The replay runs faster than the camera,
+ * so -p stamps the camera frames with the stream timestamps the poses move by.
+ *
+ * -c renders every camera frame that many times, as a display faster than the camera does; the repeated
+ * frames must keep the motion of their camera frame.
+ *
+ * The frame stages are also recorded in LatencyStats as renderFrame does and their percentiles printed,
+ * -l writes them to a file with LatencyStats::dumpToFile. The fake engine stamps the camera frames from
+ * steady_clock 20ms before their first acquire (except with -p), so camera_age and total are measured too.
+ *
+ * The replay thread runs as ThreadRole::RENDER, the TrackingThread and the JobSystem workers take their
+ * roles as on the device, and the CPU time per role is printed at the end.
+ *
+ * FrameMetrics is filled as renderFrame and checkHit do (without the GL counters) and printed at the end.
+ *
+ * -j writes the trace events of the run (AppController, TrackingThread and the replay frames) as Chrome
+ * trace JSON, for chrome://tracing or ui.perfetto.dev. Needs the VPB_ENABLE_TRACING build option (default on Linux).
+ *
+ * Startup runs as on the device: the InitPipeline maps (PosixAssetSource) and parses the model and the target
+ * manifest from the asset directory on a JobSystem (no image decoder on Linux, the textures are skipped) while initAR creates the
+ * engine, and the StartupTimeline of both is printed once the pipeline results are in.
+ *
+ * With -z the allocations of every frame (render path and hit test) are counted and the run fails if
+ * any frame after the warm-up frames allocates. Needs the VPB_TRACK_ALLOCATIONS build option (default on Linux).
+ *
+ * usage: vpb_replay [-f frames] [-t synthetic targets] [-s stream file] [-r record file] [-w width] [-h height]
+ *                   [-z warm-up frames] [-T 0|1] [-p latency frames] [-c frames per camera frame]
+ *                   [-l latency stats file] [-j trace file]
+ */
+
+namespace
+{
+constexpr int DEFAULT_FRAMES = 10000;
+
+/// Video size used for the playback quad, the sample videos are 1080p portrait
+constexpr float VIDEO_WIDTH = 1080.0f;
+constexpr float VIDEO_HEIGHT = 1920.0f;
+
+/// Camera frame interval of the fake engine timestamps (30 fps)
+constexpr float CAMERA_FRAME_SECONDS = 1.0f / 30.0f;
+
+struct ReplayOptions
+{
+    int frames{ DEFAULT_FRAMES };
+    int syntheticTargets{ -1 };
+    const char* streamPath{ nullptr };
+    const char* recordPath{ nullptr };
+    int width{ 1080 };
+    int height{ 2400 };
+    /// -z: fail if a frame after this many warm-up frames allocates, -1 to only report
+    int warmupFrames{ -1 };
+    /// -T 1: compute the poses on a TrackingThread, the timings are then the render thread side only
+    bool trackingThread{ false };
+    /// -p: motion-to-photon latency in camera frames to predict and measure, 0 for no prediction
+    int predictionFrames{ 0 };
+    /// -c: frames rendered per camera frame (vuFakeEngineSetCameraFrameRepeat), 2 for a 60Hz display with a 30Hz camera
+    int cameraFrameRepeat{ 1 };
+    /// -l: write the LatencyStats of the run to this file
+    const char* latencyPath{ nullptr };
+    /// -j: write the trace events to this file
+    const char* tracePath{ nullptr };
+};
+
+/// Poses drawn for one camera frame, kept until the frame they are compared with
+struct LagSample
+{
+    int64_t cameraFrameIndex{ -1 };
+    int numTargets{ 0 };
+    int32_t targetIds[TargetRegistry::MAX_TARGETS]{};
+    VuMatrix44F tracked[TargetRegistry::MAX_TARGETS]{};
+    VuMatrix44F predicted[TargetRegistry::MAX_TARGETS]{};
+};
+
+/// Screen position (pixels from the center) of the target origin
+glm::vec2
+projectTargetCenter(const VuMatrix44F& projection, const VuMatrix44F& modelView, float screenWidth, float screenHeight)
+{
+    const glm::vec4 clip = glm::make_mat4(projection.data) * glm::make_mat4(modelView.data) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    return glm::vec2(clip.x / clip.w * 0.5f * screenWidth, clip.y / clip.w * 0.5f * screenHeight);
+}
+
+/// Angle of the rotation between two model-view matrices in degrees
+float
+rotationErrorDegrees(const VuMatrix44F& a, const VuMatrix44F& b)
+{
+    const glm::mat3 delta = glm::mat3(glm::make_mat4(a.data)) * glm::transpose(glm::mat3(glm::make_mat4(b.data)));
+    const float cosAngle = std::clamp(0.5f * (delta[0][0] + delta[1][1] + delta[2][2] - 1.0f), -1.0f, 1.0f);
+    return glm::degrees(std::acos(cosAngle));
+}
+
+/// Mean and p99 of errors (sorts errors)
+void
+logErrors(const char* label, std::vector<float>& errors, const char* unit)
+{
+    if (errors.empty())
+        return;
+    double total = 0.0;
+    for (float error : errors)
+        total += error;
+    std::sort(errors.begin(), errors.end());
+    LOG("  %-10s mean %.3f %s, p99 %.3f %s, max %.3f %s", label, total / errors.size(), unit,
+        errors[std::min(errors.size() - 1, static_cast<size_t>(0.99 * errors.size()))], unit, errors.back(), unit);
+}
+
+/// FrameRenderer without GL for FrameLoop: lays the video quad out as GLESRenderer does for the sample videos
+/**
+ * With lag samples set, the poses FrameLoop asks to draw for a camera frame (as tracked and as predicted)
+ * are kept in the sample of that frame for the -p lag measurement.
+ */
+class ReplayRenderer : public FrameRenderer
+{
+public:
+    ReplayRenderer(float screenWidth, float screenHeight, std::vector<LagSample>* lagSamples)
+        : mScreenWidth(screenWidth), mScreenHeight(screenHeight), mLagSamples(lagSamples)
+    {
+    }
+
+    /// Sample filled by the last frame, nullptr if it drew no camera frame or there are no lag samples
+    const LagSample* getLagSample() const { return mLagSample; }
+
+    /// Projection of the last camera frame drawn
+    const VuMatrix44F& getProjection() const { return mProjection; }
+
+    /// Target poses drawn so far, and how many of them had no motion to extrapolate with
+    long getDrawnPoses() const { return mDrawnPoses; }
+    long getPosesWithoutMotion() const { return mPosesWithoutMotion; }
+
+    void beginFrame() override { mLagSample = nullptr; }
+
+    void renderVideoBackground(const AppController::TrackingFrame& frame, const double* /*viewport*/, int /*textureUnit*/) override
+    {
+        mProjection = frame.renderState.projectionMatrix;
+        if (mLagSamples == nullptr)
+            return;
+        mLagSample = &(*mLagSamples)[frame.cameraFrameIndex % mLagSamples->size()];
+        mLagSample->cameraFrameIndex = frame.cameraFrameIndex;
+        mLagSample->numTargets = 0;
+    }
+
+    VideoQuad renderVideoPlayback(const AppController::TrackingFrame::Target& target, const VuMatrix44F& /*projectionMatrix*/,
+                                  const VuMatrix44F& modelViewMatrix, const VuMatrix44F& /*scaledModelViewMatrix*/) override
+    {
+        recordPose(target, modelViewMatrix);
+        VideoQuad quad;
+        quad.halfExtent = computeVideoQuadHalfExtent(false, VIDEO_WIDTH, VIDEO_HEIGHT, mScreenWidth, mScreenHeight,
+                                                     glm::vec2(target.markerSize.data[0], target.markerSize.data[1]));
+        return quad;
+    }
+
+    void queuePause(const AppController::TrackingFrame::Target& target, const VuMatrix44F& /*projectionMatrix*/,
+                    const VuMatrix44F& modelViewMatrix, const VuMatrix44F& /*scaledModelViewMatrix*/) override
+    {
+        recordPose(target, modelViewMatrix);
+    }
+
+    void renderPauses() override {}
+
+    bool renderHud(HudOverlay& /*hud*/) override { return false; }
+
+    Counters getCounters() const override { return Counters(); }
+
+private:
+    void recordPose(const AppController::TrackingFrame::Target& target, const VuMatrix44F& modelViewMatrix)
+    {
+        mDrawnPoses++;
+        if (!target.motion.valid)
+            mPosesWithoutMotion++;
+        if (mLagSample == nullptr || mLagSample->numTargets == TargetRegistry::MAX_TARGETS)
+            return;
+        const int idx = mLagSample->numTargets++;
+        mLagSample->targetIds[idx] = target.targetId;
+        mLagSample->tracked[idx] = target.modelView;
+        mLagSample->predicted[idx] = modelViewMatrix;
+    }
+
+    float mScreenWidth;
+    float mScreenHeight;
+    std::vector<LagSample>* mLagSamples;
+    LagSample* mLagSample{ nullptr };
+    VuMatrix44F mProjection{};
+    long mDrawnPoses{ 0 };
+    long mPosesWithoutMotion{ 0 };
+};
+
+bool
+parseOptions(int argc, char** argv, ReplayOptions& options)
+{
+    for (int idx = 1; idx + 1 < argc; idx += 2)
+    {
+        const char* value = argv[idx + 1];
+        if (strcmp(argv[idx], "-f") == 0)
+            options.frames = atoi(value);
+        else if (strcmp(argv[idx], "-t") == 0)
+            options.syntheticTargets = atoi(value);
+        else if (strcmp(argv[idx], "-s") == 0)
+            options.streamPath = value;
+        else if (strcmp(argv[idx], "-r") == 0)
+            options.recordPath = value;
+        else if (strcmp(argv[idx], "-w") == 0)
+            options.width = atoi(value);
+        else if (strcmp(argv[idx], "-h") == 0)
+            options.height = atoi(value);
+        else if (strcmp(argv[idx], "-z") == 0)
+            options.warmupFrames = atoi(value);
+        else if (strcmp(argv[idx], "-T") == 0)
+            options.trackingThread = atoi(value) != 0;
+        else if (strcmp(argv[idx], "-p") == 0)
+            options.predictionFrames = atoi(value);
+        else if (strcmp(argv[idx], "-c") == 0)
+            options.cameraFrameRepeat = atoi(value);
+        else if (strcmp(argv[idx], "-l") == 0)
+            options.latencyPath = value;
+        else if (strcmp(argv[idx], "-j") == 0)
+            options.tracePath = value;
+        else
+            return false;
+    }
+    const float horizon = options.predictionFrames * CAMERA_FRAME_SECONDS;
+    return (argc % 2) == 1 && options.frames > 0 && options.width > 0 && options.height > 0 && options.predictionFrames >= 0 && options.cameraFrameRepeat > 0 &&
+           horizon <= PosePredictor::MAX_HORIZON_SECONDS + 1e-3f;
+}
+}
+
+
+int
+main(int argc, char** argv)
+{
+    ReplayOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        LOG("usage: %s [-f frames] [-t synthetic targets] [-s stream file] [-r record file] [-w width] [-h height] [-z warm-up frames] [-T 0|1] [-p latency frames] [-c frames per camera frame] [-l latency stats file] [-j trace file]", argv[0]);
+        return 1;
+    }
+
+    VPB_TRACE_THREAD_NAME("Replay");
+    ThreadRoles::assign(ThreadRole::RENDER);
+    vuFakeEngineSetAssetDirectory(VPB_ASSET_DIR);
+    vuFakeEngineSetCameraFrameRepeat(options.cameraFrameRepeat);
+    if (options.predictionFrames > 0)
+    {
+        vuFakeEngineSetCaptureAge(-1);
+    }
+    if (options.streamPath != nullptr)
+    {
+        if (vuFakeEngineLoadStream(options.streamPath) != VU_SUCCESS)
+        {
+            return 1;
+        }
+    }
+    else if (options.syntheticTargets >= 0)
+    {
+        vuFakeEngineSetSyntheticStream(options.syntheticTargets);
+    }
+
+    /* 端末と同じく、アセットの読み込みをエンジン生成と並行して始める */
+    JobSystem jobs;
+    StartupTimeline startupTimeline;
+    InitPipeline initPipeline(startupTimeline, jobs);
+    InitPipeline::Platform platform;
+    platform.assets = std::make_shared<PosixAssetSource>(VPB_ASSET_DIR);
+    initPipeline.start(platform);
+
+    AppController controller;
+    bool initDone = false;
+    AppController::InitConfig initConfig;
+    initConfig.timeline = &startupTimeline;
+    initConfig.errorMessageCallback = [](const char* errorString) { LOG("Init error: %s", errorString); };
+    initConfig.vuforiaEngineErrorCallback = [](VuErrorCode errorCode) { LOG("Engine error: %d", errorCode); };
+    initConfig.initDoneCallback = [&initDone]() { initDone = true; };
+    {
+        StartupTimeline::Scope phase(startupTimeline, "initAR");
+        controller.initAR(initConfig, AppController::IMAGE_TARGET_ID);
+    }
+    const InitPipeline::Model* model;
+    const std::vector<std::string>* manifestTargetNames;
+    {
+        StartupTimeline::Scope phase(startupTimeline, "wait for startup assets");
+        model = initPipeline.getModel();
+        manifestTargetNames = initPipeline.getManifestTargetNames();
+    }
+    if (model == nullptr || manifestTargetNames == nullptr)
+    {
+        LOG("Failed to load the startup assets from %s", VPB_ASSET_DIR);
+        return 1;
+    }
+    LOG("Startup: model %d vertices, %zu manifest targets", model->numVertices, manifestTargetNames->size());
+
+    if (!initDone || !controller.startAR() || !controller.configureRendering(options.width, options.height, nullptr))
+    {
+        LOG("Failed to start the fake engine");
+        return 1;
+    }
+
+    if (options.recordPath != nullptr)
+    {
+        VuResult result = vuFakeEngineSaveStream(options.recordPath, options.frames);
+        LOG("%s %s", result == VU_SUCCESS ? "Recorded stream to" : "Failed to record stream to", options.recordPath);
+        controller.deinitAR();
+        return result == VU_SUCCESS ? 0 : 1;
+    }
+
+    const float screenWidth = static_cast<float>(options.width);
+    const float screenHeight = static_cast<float>(options.height);
+    const glm::vec2 touchPoint = screenToNdc(0.5f * screenWidth, 0.5f * screenHeight, screenWidth, screenHeight);
+
+    TrackingThread trackingThread;
+    if (options.trackingThread)
+    {
+        trackingThread.start(controller);
+    }
+
+    /* 描画時刻までの遅れは実時間でなくカメラフレーム数で固定し、結果を再現可能にする */
+    const float predictionHorizon = options.predictionFrames * CAMERA_FRAME_SECONDS;
+    controller.setPosePrediction(options.predictionFrames > 0, 0);
+    std::vector<LagSample> lagSamples(options.predictionFrames + 1);
+    std::vector<float> trackedPixelErrors, predictedPixelErrors, trackedAngleErrors, predictedAngleErrors;
+    if (options.predictionFrames > 0)
+    {
+        const size_t maxErrors = static_cast<size_t>(options.frames) * TargetRegistry::MAX_TARGETS;
+        for (std::vector<float>* errors : { &trackedPixelErrors, &predictedPixelErrors, &trackedAngleErrors, &predictedAngleErrors })
+            errors->reserve(maxErrors);
+    }
+    FrameMetrics metrics{};
+    FrameMetricsRecorder metricsRecorder(metrics);
+
+    /* 端末のrenderFrameと同じFrameLoopを、GLを呼ばないレンダラーで回す */
+    FrameLoop frameLoop(controller, trackingThread, metricsRecorder, &startupTimeline);
+    if (options.predictionFrames > 0)
+    {
+        frameLoop.setFixedPredictionHorizon(predictionHorizon);
+    }
+    ReplayRenderer renderer(screenWidth, screenHeight, options.predictionFrames > 0 ? &lagSamples : nullptr);
+    LatencyStats& latencyStats = frameLoop.getLatencyStats();
+
+    FrameResult frameResult{};
+    int32_t nowPlayingId = NO_TARGET_ID;
+    std::vector<double> frameTimes(options.frames);
+    long observationCount = 0;
+    long hitCount = 0;
+    long allocatingFrames = 0;
+
+    for (int frame = 0; frame < options.frames; frame++)
+    {
+        if (options.trackingThread)
+        {
+            /* 描画側がCPUを占有しないように、vsync待ちの代わりに少し寝る */
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        {
+            VPB_TRACE_SCOPE("Replay frame");
+            const int32_t playingId = frameLoop.renderFrame(renderer, nowPlayingId, frameResult);
+            /* Kotlin側と同じく、最初に再生したターゲットで再生し続ける */
+            if (nowPlayingId == NO_TARGET_ID)
+                nowPlayingId = playingId;
+            observationCount += frameResult.numTracked;
+        }
+        const AllocationCounts renderAllocations = frameLoop.getFrameAllocations();
+        const LagSample* lagSample = renderer.getLagSample();
+
+        AllocationCounts hitAllocations;
+        {
+            AllocationScope hitScope(AllocationTag::CHECK_HIT);
+            VPB_TRACE_SCOPE("Replay checkHit");
+            RayHitTester::Hit hit;
+            const int64_t hitStart = LatencyStats::now();
+            if (frameLoop.getHitTester().hitTest(touchPoint, hit))
+            {
+                hitCount++;
+            }
+            metricsRecorder.recordHitTest(LatencyStats::now() - hitStart);
+            hitAllocations = hitScope.getCounts();
+        }
+
+        if (frame >= options.warmupFrames && renderAllocations.allocations + hitAllocations.allocations > 0)
+        {
+            if (allocatingFrames == 0)
+            {
+                LOG("Frame %d allocated: renderFrame %llu (%llu bytes), checkHit %llu (%llu bytes)", frame,
+                    static_cast<unsigned long long>(renderAllocations.allocations),
+                    static_cast<unsigned long long>(renderAllocations.bytes),
+                    static_cast<unsigned long long>(hitAllocations.allocations),
+                    static_cast<unsigned long long>(hitAllocations.bytes));
+            }
+            allocatingFrames++;
+        }
+
+        frameTimes[frame] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        /* この時点の姿勢を、latency frames 前に描いた姿勢(予測なし/あり)と比べる */
+        if (lagSample != nullptr && frame >= options.predictionFrames)
+        {
+            const LagSample& drawn = lagSamples[(lagSample->cameraFrameIndex - options.predictionFrames) % lagSamples.size()];
+            if (drawn.cameraFrameIndex != lagSample->cameraFrameIndex - options.predictionFrames)
+                continue;
+            for (int idx = 0; idx < lagSample->numTargets; idx++)
+            {
+                const int drawnIdx = std::find(drawn.targetIds, drawn.targetIds + drawn.numTargets, lagSample->targetIds[idx]) - drawn.targetIds;
+                if (drawnIdx == drawn.numTargets)
+                    continue;
+                const VuMatrix44F& actual = lagSample->tracked[idx];
+                const glm::vec2 actualCenter = projectTargetCenter(renderer.getProjection(), actual, screenWidth, screenHeight);
+                trackedPixelErrors.push_back(glm::distance(actualCenter, projectTargetCenter(renderer.getProjection(), drawn.tracked[drawnIdx], screenWidth, screenHeight)));
+                predictedPixelErrors.push_back(glm::distance(actualCenter, projectTargetCenter(renderer.getProjection(), drawn.predicted[drawnIdx], screenWidth, screenHeight)));
+                trackedAngleErrors.push_back(rotationErrorDegrees(actual, drawn.tracked[drawnIdx]));
+                predictedAngleErrors.push_back(rotationErrorDegrees(actual, drawn.predicted[drawnIdx]));
+            }
+        }
+    }
+
+    /* スレッドが生きているうちに役割ごとのCPU時間を取る */
+    const std::string roleUsage = ThreadRoles::formatUsage();
+    trackingThread.stop();
+    const int64_t acquiredStates = vuFakeEngineGetAcquiredStateCount();
+    controller.deinitAR();
+
+    if (options.tracePath != nullptr)
+    {
+        const bool written = Tracer::writeChromeTrace(options.tracePath);
+        LOG("%s %s", written ? "Wrote trace to" : "Failed to write trace to", options.tracePath);
+    }
+
+    double total = 0.0;
+    for (double time : frameTimes)
+    {
+        total += time;
+    }
+    std::sort(frameTimes.begin(), frameTimes.end());
+    auto percentile = [&frameTimes](double p) {
+        return frameTimes[std::min(frameTimes.size() - 1, static_cast<size_t>(p * frameTimes.size()))];
+    };
+
+    LOG("%d frames, %.2f observations/frame, center hit in %ld frames", options.frames,
+        static_cast<double>(observationCount) / options.frames, hitCount);
+    if (options.trackingThread)
+    {
+        LOG("tracking thread published %llu frames, %lld states acquired", static_cast<unsigned long long>(trackingThread.getPublishedFrames()),
+            static_cast<long long>(acquiredStates));
+    }
+    LOG("CPU time per thread role:\n%s", roleUsage.c_str());
+    if (options.predictionFrames > 0)
+    {
+        LOG("overlay lag over %d camera frames (%.1f ms), %zu target poses:", options.predictionFrames,
+            predictionHorizon * 1000.0f, trackedPixelErrors.size());
+        logErrors("tracked", trackedPixelErrors, "px");
+        logErrors("predicted", predictedPixelErrors, "px");
+        logErrors("tracked", trackedAngleErrors, "deg");
+        logErrors("predicted", predictedAngleErrors, "deg");
+        LOG("  %ld of %ld drawn target poses without a motion estimate", renderer.getPosesWithoutMotion(), renderer.getDrawnPoses());
+    }
+    LOG("stage latency over the last %d frames (us), camera_age/total from the acquire in %llu of %llu frames:", LatencyStats::WINDOW_SIZE,
+        static_cast<unsigned long long>(latencyStats.getAcquireTimeFrameCount()), static_cast<unsigned long long>(latencyStats.getFrameCount()));
+    for (int stage = 0; stage < LatencyStats::STAGE_COUNT; stage++)
+    {
+        const LatencyStats::Percentiles percentiles = latencyStats.getPercentiles(static_cast<LatencyStats::Stage>(stage));
+        LOG("  %-12s count %3d, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f", LatencyStats::getStageName(static_cast<LatencyStats::Stage>(stage)),
+            percentiles.count, percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max);
+    }
+    if (options.latencyPath != nullptr && !latencyStats.dumpToFile(options.latencyPath))
+    {
+        LOG("Failed to write the latency stats to %s", options.latencyPath);
+    }
+    LOG("metrics: %d frames, %d dropped, %d skipped, %.2f targets/frame, hit test last %d ns max %d ns over %d", metrics.frameCount,
+        metrics.droppedFrames, metrics.skippedFrames, metrics.frameCount > 0 ? static_cast<double>(metrics.trackedTargetsTotal) / metrics.frameCount : 0.0,
+        metrics.hitTestLastNs, metrics.hitTestMaxNs, metrics.hitTestCount);
+    LOG("frame time histogram (%d us buckets):", FrameMetrics::FRAME_TIME_BUCKET_US);
+    for (int bucket = 0; bucket < FrameMetrics::FRAME_TIME_BUCKETS; bucket++)
+    {
+        if (metrics.frameTimeHistogram[bucket] != 0)
+            LOG("  %5d us%s %d", bucket * FrameMetrics::FRAME_TIME_BUCKET_US, bucket == FrameMetrics::FRAME_TIME_BUCKETS - 1 ? "+" : " ",
+                metrics.frameTimeHistogram[bucket]);
+    }
+    LOG("frame CPU time: mean %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us", total / options.frames, percentile(0.50),
+        percentile(0.99), frameTimes.back());
+
+    if (!isAllocationTrackingEnabled())
+    {
+        LOG("allocations: not tracked (build with VPB_TRACK_ALLOCATIONS)");
+        return options.warmupFrames >= 0 ? 1 : 0;
+    }
+    AllocationCounts renderTotal = getTagAllocationCounts(AllocationTag::RENDER_FRAME);
+    AllocationCounts hitTotal = getTagAllocationCounts(AllocationTag::CHECK_HIT);
+    LOG("allocations: renderFrame %llu (%llu bytes), checkHit %llu (%llu bytes), %ld frames allocated after frame %d",
+        static_cast<unsigned long long>(renderTotal.allocations), static_cast<unsigned long long>(renderTotal.bytes),
+        static_cast<unsigned long long>(hitTotal.allocations), static_cast<unsigned long long>(hitTotal.bytes),
+        allocatingFrames, std::max(options.warmupFrames, 0));
+    return (options.warmupFrames >= 0 && allocatingFrames > 0) ? 1 : 0;
+}
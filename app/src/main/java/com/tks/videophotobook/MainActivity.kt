@@ -1,11 +1,8 @@
 package com.tks.videophotobook
 
 import android.Manifest
-import android.content.Context
 import android.content.pm.PackageManager
 import android.content.res.Configuration
-import android.graphics.Bitmap
-import android.graphics.BitmapFactory
 import android.graphics.PixelFormat
 import android.graphics.SurfaceTexture
 import android.net.Uri
@@ -38,14 +35,14 @@ import androidx.media3.common.util.UnstableApi
 import androidx.media3.exoplayer.ExoPlayer
 import com.tks.videophotobook.databinding.ActivityMainBinding
 import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.async
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withContext
-import org.xmlpull.v1.XmlPullParser
-import org.xmlpull.v1.XmlPullParserFactory
 import java.io.File
-import java.io.IOException
 import java.nio.ByteBuffer
+import java.nio.ByteOrder
 import java.util.Timer
 import java.util.concurrent.CountDownLatch
 import javax.microedition.khronos.egl.EGLConfig
@@ -54,12 +51,28 @@ import kotlin.concurrent.schedule
 
 const val IMAGE_TARGET_ID = 0
 const val MODEL_TARGET_ID = 1
+/* 姿勢計算を描画スレッドから切り離す (setTrackingThreadEnabled) */
+const val USE_TRACKING_THREAD = false
+/* 重ね合わせの遅れをターゲットの姿勢予測で補う (setPosePrediction) */
+const val USE_POSE_PREDICTION = false
+const val POSE_PREDICTION_LATENCY_MS = 33
+/* 遅延の統計の書き出し先 (filesDir 配下, dumpLatencyStats) */
+const val LATENCY_STATS_FILE = "latency_stats.txt"
+/* トレースの書き出し先 (filesDir 配下, dumpTrace。デバッグビルドのみ) */
+const val TRACE_FILE = "trace.json"
+/* 性能HUDを最初から表示する (setHudEnabled。長押しで切り替え) */
+const val SHOW_HUD = false
+/* 起動フェーズのタイムラインの書き出し先 (filesDir 配下, dumpStartupTimeline) */
+const val STARTUP_TIMELINE_FILE = "startup_timeline.txt"
 val REQUIRED_PERMISSIONS = arrayOf(Manifest.permission.CAMERA)
 
 class MainActivity : AppCompatActivity() {
     private val mp4UriMap = mutableMapOf<String, Uri>()
+    /* mp4のキャッシュへのコピーとmp4UriMapの生成(I/Oスレッド)。switchMedia()は完了を待ってから使う */
+    private lateinit var _mediaSetup: Deferred<Unit>
     private lateinit var _binding: ActivityMainBinding
     private var isFullScreenMode = false
+    private var isHudShown = SHOW_HUD
     private var mVuforiaStarted = false
     private var mSurfaceChanged = false
     private var mWindowDisplayRotation = Surface.ROTATION_0
@@ -71,10 +84,23 @@ class MainActivity : AppCompatActivity() {
     private var _exoPlayer_isPlaying = false
     private lateinit var _surfaceTexture: SurfaceTexture
     private lateinit var _surface: Surface
-    private var _nowPlayingTarget: String = ""
+    @Volatile private var _nowPlayingId: Int = NO_TARGET_ID
+    /* ターゲットID順のターゲット名(initDone()で一度だけ取得) */
+    @Volatile private var _targetNames: Array<String> = emptyArray()
+    /* renderFrameIds()の結果をC++側が書き込むバッファ */
+    private val _frameResult: ByteBuffer = ByteBuffer.allocateDirect(FRAME_RESULT_SIZE).order(ByteOrder.nativeOrder())
+    private val _frameMetrics: ByteBuffer by lazy { getMetricsBuffer().order(ByteOrder.nativeOrder()) }
+    private val _frameMetricsSnapshot = IntArray(FRAME_METRICS_SIZE / 4)
 
     override fun onCreate(savedInstanceState: Bundle?) {
         super.onCreate(savedInstanceState)
+        val onCreatePhase = beginStartupPhase("onCreate")
+
+        /* モデル・テクスチャ・マニフェストの読み込みは、エンジン生成やGLの準備と並行してネイティブのワーカーで行う */
+        startInitPipeline(assets)
+        _mediaSetup = lifecycleScope.async(Dispatchers.IO) {
+            startupPhase("prepare media") { prepareMedia() }
+        }
 
         _binding = ActivityMainBinding.inflate(layoutInflater)
         setContentView(_binding.root)
@@ -92,6 +118,7 @@ class MainActivity : AppCompatActivity() {
         _binding.viwGlsurface.setRenderer(object : GLSurfaceView.Renderer {
             override fun onSurfaceCreated(gl: GL10, config: EGLConfig) {
                 initRendering()
+                setFrameResultBuffer(_frameResult)
             }
 
             @UnstableApi
@@ -100,58 +127,10 @@ class MainActivity : AppCompatActivity() {
                 mWidth = width
                 mHeight = height
 
-                // Re-load textures in case they got destroyed
-                val astronautbitmap = loadBitmapFromAssets(this@MainActivity, "ImageTargets/Astronaut.jpg")
-                val astronautTexture: ByteBuffer? = astronautbitmap?.let { bitmap ->
-                                                        ByteBuffer.allocateDirect(bitmap.byteCount).apply {
-                                                            bitmap.copyPixelsToBuffer(this)
-                                                            rewind()
-                                                        }
-                                                    }
-                val pausebitmap = loadBitmapFromAssets(this@MainActivity, "pause.png")
-                val pauseTexture: ByteBuffer? = pausebitmap?.let { bitmap ->
-                    ByteBuffer.allocateDirect(bitmap.byteCount).apply {
-                        bitmap.copyPixelsToBuffer(this)
-                        rewind()
-                    }
-                }
-
-                if (astronautTexture != null && pauseTexture != null) {
-                    setTextures(astronautbitmap.width, astronautbitmap.height, astronautTexture,
-                                pausebitmap.width, pausebitmap.height, pauseTexture)
-                } else {
-                    Log.e("VuforiaSample", "Failed to load astronaut or lander texture")
-                }
-
                 val textureId = initVideoTexture()
                 if (textureId < 0)
                     throw RuntimeException("Failed to create native texture")
 
-                /* mp4ファイルをキャッシュ領域にコピー */
-                val mp4Files = assets.list("")?.filter { it.endsWith(".mp4") } ?: emptyList()
-                for (fileName in mp4Files) {
-                    val outFile = File( externalCacheDir ?: cacheDir, fileName)
-                    assets.open(fileName).use { input ->
-                        outFile.outputStream().use { output ->
-                            input.copyTo(output)
-                        }
-                    }
-                }
-                Log.e("aaaaa", "copy to cache(${externalCacheDir ?: cacheDir}) mp4Files=$mp4Files")
-
-                /* map(key:targetName,val:uri)を生成 */
-                val cacheMp4Files = (externalCacheDir ?: cacheDir).listFiles { _, name -> name.endsWith(".mp4") }?.sortedBy { it.name } ?: emptyList()
-                /* cache配下のmp4ファイルURIリストを生成 */
-                val uris = cacheMp4Files.map { file -> FileProvider.getUriForFile(this@MainActivity, "${packageName}.fileprovider", file) }
-                /* assets配下のxmlファイルからTargetName一覧を生成 */
-                val xmlfiles = assets.list("")?.filter { it.endsWith(".xml") } ?: emptyList()
-                val targetNames = parseXmlFromAssets(this@MainActivity, xmlfiles[0]).sortedBy { it } /* TargetName一覧をソートしておく */
-                /* targetNameとuriがペアのmapを生成 */
-                for ((targetName, uri) in targetNames.zip(uris)) {
-                    mp4UriMap[targetName] = uri
-                    Log.d("aaaaa", "    pair : targetName=$targetName, uri=$uri")
-                }
-
                 /* Create the ExoPlayer */
                 CoroutineScope(Dispatchers.Main).launch {
                     /* Create the ExoPlayer */
@@ -206,23 +185,23 @@ class MainActivity : AppCompatActivity() {
                     }
 
                     // OpenGL rendering of Video Background and augmentations is implemented in native code
-                    val delectedTarget = renderFrame(_nowPlayingTarget)
-                    if(delectedTarget == "waiting...") return
+                    val delectedId = renderFrameIds(_nowPlayingId)
+                    if(delectedId == FRAME_WAITING_ID) return
 
-                    if(_nowPlayingTarget!="" && delectedTarget!="")
-                        Log.d("aaaaa", "!!! Detected Target Changed !!! targetName=$_nowPlayingTarget -> $delectedTarget")
+                    if(_nowPlayingId!=NO_TARGET_ID && delectedId!=NO_TARGET_ID && _nowPlayingId!=delectedId)
+                        Log.d("aaaaa", "!!! Detected Target Changed !!! targetName=${_targetNames[_nowPlayingId]} -> ${_targetNames[delectedId]}")
 
-                    if(_nowPlayingTarget!="" && delectedTarget=="") {
-                        _nowPlayingTarget = delectedTarget
+                    if(_nowPlayingId!=NO_TARGET_ID && delectedId==NO_TARGET_ID) {
+                        _nowPlayingId = delectedId
                         CoroutineScope(Dispatchers.Main).launch {
                             _exoPlayer.pause()
                         }
                     }
-                    else if(_nowPlayingTarget != delectedTarget) {
-                        _nowPlayingTarget = delectedTarget
+                    else if(_nowPlayingId != delectedId) {
+                        _nowPlayingId = delectedId
                         /* 新規Targetを再生 */
                         val latch = CountDownLatch(1)
-                        switchMedia(delectedTarget, latch)
+                        switchMedia(_targetNames[delectedId], latch)
                         /* 完了待ち(無限待機) */
                         try {latch.await()} catch (e: InterruptedException) {}
                         /* loadingIndicatorは非表示に */
@@ -252,11 +231,11 @@ class MainActivity : AppCompatActivity() {
         gestureDetector = GestureDetector(this, object : GestureDetector.SimpleOnGestureListener() {
             @UnstableApi
             override fun onSingleTapConfirmed(e: MotionEvent): Boolean {
-                val targetName = checkHit(e.x, e.y,_binding.viwGlsurface.width.toFloat(), _binding.viwGlsurface.height.toFloat())
-                if(targetName != _nowPlayingTarget && targetName != "") {
+                val targetId = checkHitId(e.x, e.y,_binding.viwGlsurface.width.toFloat(), _binding.viwGlsurface.height.toFloat())
+                if(targetId != _nowPlayingId && targetId != NO_TARGET_ID) {
                     /* 動画差し替え */
-                    _nowPlayingTarget = targetName
-                    switchMedia(targetName)
+                    _nowPlayingId = targetId
+                    switchMedia(_targetNames[targetId])
                 }
                 else {
                     /* 再生/停止/早送り/巻戻しコントローラ表示/非表示 */
@@ -276,11 +255,11 @@ class MainActivity : AppCompatActivity() {
             @UnstableApi
             override fun onDoubleTap(e: MotionEvent): Boolean {
                 super.onDoubleTap(e)
-                val targetName = checkHit(e.x, e.y,_binding.viwGlsurface.width.toFloat(), _binding.viwGlsurface.height.toFloat())
-                if(targetName != _nowPlayingTarget && targetName != "") {
+                val targetId = checkHitId(e.x, e.y,_binding.viwGlsurface.width.toFloat(), _binding.viwGlsurface.height.toFloat())
+                if(targetId != _nowPlayingId && targetId != NO_TARGET_ID) {
                     /* 動画差し替え */
-                    _nowPlayingTarget = targetName
-                    switchMedia(targetName)
+                    _nowPlayingId = targetId
+                    switchMedia(_targetNames[targetId])
                 }
                 else {
                     /* フルスクリーンモード切替 */
@@ -289,6 +268,12 @@ class MainActivity : AppCompatActivity() {
                 }
                 return true
             }
+
+            override fun onLongPress(e: MotionEvent) {
+                /* 性能HUD表示切替 */
+                isHudShown = !isHudShown
+                setHudEnabled(isHudShown)
+            }
         })
 
         onBackPressedDispatcher.addCallback(this) {
@@ -299,20 +284,55 @@ class MainActivity : AppCompatActivity() {
             mVuforiaStarted = false
             deinitAR()
         }
+        endStartupPhase(onCreatePhase)
+    }
+
+    /* mp4ファイルをキャッシュ領域にコピーし(同じサイズでコピー済みなら省く)、map(key:targetName,val:uri)を生成 */
+    private fun prepareMedia() {
+        val mediaDir = externalCacheDir ?: cacheDir
+        val mp4Files = assets.list("")?.filter { it.endsWith(".mp4") } ?: emptyList()
+        for (fileName in mp4Files) {
+            val outFile = File(mediaDir, fileName)
+            assets.openFd(fileName).use { fd ->
+                if (outFile.length() == fd.length)
+                    return@use
+                fd.createInputStream().use { input ->
+                    outFile.outputStream().use { output ->
+                        input.copyTo(output)
+                    }
+                }
+            }
+        }
+        Log.d("aaaaa", "copy to cache($mediaDir) mp4Files=$mp4Files")
+
+        /* cache配下のmp4ファイルURIリストを生成 */
+        val cacheMp4Files = mediaDir.listFiles { _, name -> name.endsWith(".mp4") }?.sortedBy { it.name } ?: emptyList()
+        val uris = cacheMp4Files.map { file -> FileProvider.getUriForFile(this@MainActivity, "${packageName}.fileprovider", file) }
+        /* TargetName一覧はネイティブで読んだデータセットXMLから(ソートしておく) */
+        val targetNames = getManifestTargetNames().sortedBy { it }
+        /* targetNameとuriがペアのmapを生成 (読むのは_mediaSetupの完了を待った後だけ) */
+        for ((targetName, uri) in targetNames.zip(uris)) {
+            mp4UriMap[targetName] = uri
+            Log.d("aaaaa", "    pair : targetName=$targetName, uri=$uri")
+        }
     }
 
     /* 指定Target動画に差替え */
     private fun switchMedia(target: String) {
-        _exoPlayer.stop()
-        _exoPlayer.clearMediaItems()
-        val mediaItem = MediaItem.fromUri(mp4UriMap[target]!!)
-        _exoPlayer.setMediaItem(mediaItem)
-        _exoPlayer.prepare()
-        _exoPlayer.playWhenReady = true
+        lifecycleScope.launch(Dispatchers.Main) {
+            _mediaSetup.await()
+            _exoPlayer.stop()
+            _exoPlayer.clearMediaItems()
+            val mediaItem = MediaItem.fromUri(mp4UriMap[target]!!)
+            _exoPlayer.setMediaItem(mediaItem)
+            _exoPlayer.prepare()
+            _exoPlayer.playWhenReady = true
+        }
     }
 
     private fun switchMedia(target: String, latch: CountDownLatch) {
         CoroutineScope(Dispatchers.Main).launch {
+            _mediaSetup.await()
             _exoPlayer.stop()
             _exoPlayer.clearMediaItems()
             val mediaItem = MediaItem.fromUri(mp4UriMap[target]!!)
@@ -374,6 +394,26 @@ class MainActivity : AppCompatActivity() {
     override fun onPause() {
         super.onPause()
         stopAR()
+        if (readFrameMetrics(_frameMetrics, _frameMetricsSnapshot)) {
+            val m = _frameMetricsSnapshot
+            Log.d("aaaaa", "frames=${m[FRAME_METRICS_FRAME_COUNT_OFFSET / 4]} dropped=${m[FRAME_METRICS_DROPPED_FRAMES_OFFSET / 4]} skipped=${m[FRAME_METRICS_SKIPPED_FRAMES_OFFSET / 4]}" +
+                    " drawCalls=${m[FRAME_METRICS_DRAW_CALLS_OFFSET / 4]} glAvoided=${m[FRAME_METRICS_GL_CALLS_AVOIDED_TOTAL_OFFSET / 4]} hitTestMax=${m[FRAME_METRICS_HIT_TEST_MAX_NS_OFFSET / 4]}ns")
+        }
+        /* 実機の遅延を後から回収できるように、一時停止のたびに書き出す(ファイル書き込みと/procの走査はUIスレッドでしない) */
+        lifecycleScope.launch(Dispatchers.IO) {
+            val latencyStats = getLatencyStats()
+            val total = LATENCY_STATS_STAGE_TOTAL * LATENCY_STATS_VALUES_PER_STAGE
+            Log.d("aaaaa", "camera-to-display latency: frames=${latencyStats[total + LATENCY_STATS_COUNT].toInt()} p50=${latencyStats[total + LATENCY_STATS_P50]}us" +
+                    " p95=${latencyStats[total + LATENCY_STATS_P95]}us p99=${latencyStats[total + LATENCY_STATS_P99]}us")
+            dumpLatencyStats(File(filesDir, LATENCY_STATS_FILE).absolutePath)
+            val roleUsage = getThreadRoleUsage()
+            Log.d("aaaaa", "CPU time: " + listOf("render", "tracking", "worker", "background", "other").mapIndexed { role, name ->
+                "$name=${"%.2f".format(roleUsage[role * 2 + 1])}s/${roleUsage[role * 2].toInt()}"
+            }.joinToString(" "))
+            dumpStartupTimeline(File(filesDir, STARTUP_TIMELINE_FILE).absolutePath)
+        }
+        if (dumpTrace(File(filesDir, TRACE_FILE).absolutePath))
+            Log.d("aaaaa", "writing trace to ${File(filesDir, TRACE_FILE).absolutePath}")
     }
 
     override fun onDestroy() {
@@ -432,6 +472,10 @@ class MainActivity : AppCompatActivity() {
 
     @Suppress("unused")
     private fun initDone() {
+        _targetNames = getTargetNames()
+        setTrackingThreadEnabled(USE_TRACKING_THREAD)
+        setPosePrediction(USE_POSE_PREDICTION, POSE_PREDICTION_LATENCY_MS)
+        setHudEnabled(isHudShown)
         mVuforiaStarted = startAR()
         if (!mVuforiaStarted) {
             Log.e("VuforiaSample", "Failed to start AR")
@@ -450,32 +494,3 @@ class MainActivity : AppCompatActivity() {
         }
     }
 }
-
-fun loadBitmapFromAssets(context: Context, fileName: String): Bitmap? {
-    return try {
-        val inputStream = context.assets.open(fileName)
-        BitmapFactory.decodeStream(inputStream)
-    } catch (e: IOException) {
-        e.printStackTrace()
-        null
-    }
-}
-
-fun parseXmlFromAssets(context: Context, fileName: String): List<String> {
-    val result = mutableListOf<String>()
-    val inputStream = context.assets.open(fileName)
-    val factory = XmlPullParserFactory.newInstance()
-    val parser = factory.newPullParser()
-    parser.setInput(inputStream, null)
-
-    var eventType = parser.eventType
-    while (eventType != XmlPullParser.END_DOCUMENT) {
-        if (eventType == XmlPullParser.START_TAG && parser.name == "ImageTarget") {
-            val name = parser.getAttributeValue(null, "name")
-            if (name != null) result.add(name)
-        }
-        eventType = parser.next()
-    }
-    inputStream.close()
-    return result
-}
\ No newline at end of file
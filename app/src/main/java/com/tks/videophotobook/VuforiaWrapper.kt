@@ -2,12 +2,67 @@ package com.tks.videophotobook
 
 import android.app.Activity
 import android.content.res.AssetManager
+import java.lang.invoke.VarHandle
 import java.nio.ByteBuffer
 
+/* ターゲットID (FrameResult.h と同じ値) */
+const val NO_TARGET_ID = -1
+const val FRAME_WAITING_ID = -2
+
+/* setFrameResultBuffer()に渡すDirectByteBufferのレイアウト (FrameResult.h 参照, int32 ネイティブバイトオーダー) */
+const val FRAME_RESULT_MAX_TRACKED = 16
+const val FRAME_RESULT_FRAME_COUNT_OFFSET = 0
+const val FRAME_RESULT_PLAYING_ID_OFFSET = 4
+const val FRAME_RESULT_NUM_TRACKED_OFFSET = 8
+const val FRAME_RESULT_TRACKED_IDS_OFFSET = 12
+const val FRAME_RESULT_SIZE = FRAME_RESULT_TRACKED_IDS_OFFSET + FRAME_RESULT_MAX_TRACKED * 4
+
+/* getMetricsBuffer()が返すDirectByteBufferのレイアウト (FrameMetrics.h 参照, int32 ネイティブバイトオーダー) */
+const val FRAME_METRICS_VERSION = 1
+const val FRAME_METRICS_FRAME_TIME_BUCKETS = 16
+const val FRAME_METRICS_FRAME_TIME_BUCKET_US = 2000
+const val FRAME_METRICS_VERSION_OFFSET = 0
+const val FRAME_METRICS_SEQUENCE_OFFSET = 4
+const val FRAME_METRICS_FRAME_COUNT_OFFSET = 8
+const val FRAME_METRICS_DROPPED_FRAMES_OFFSET = 12
+const val FRAME_METRICS_SKIPPED_FRAMES_OFFSET = 16
+const val FRAME_METRICS_LAST_FRAME_TIME_US_OFFSET = 20
+const val FRAME_METRICS_FRAME_TIME_HISTOGRAM_OFFSET = 24
+const val FRAME_METRICS_TRACKED_TARGETS_OFFSET = FRAME_METRICS_FRAME_TIME_HISTOGRAM_OFFSET + FRAME_METRICS_FRAME_TIME_BUCKETS * 4
+const val FRAME_METRICS_TRACKED_TARGETS_TOTAL_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 4
+const val FRAME_METRICS_DRAW_CALLS_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 8
+const val FRAME_METRICS_GL_CALLS_ISSUED_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 12
+const val FRAME_METRICS_GL_CALLS_AVOIDED_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 16
+const val FRAME_METRICS_GL_CALLS_AVOIDED_TOTAL_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 20
+const val FRAME_METRICS_HIT_TEST_COUNT_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 24
+const val FRAME_METRICS_HIT_TEST_LAST_NS_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 28
+const val FRAME_METRICS_HIT_TEST_MAX_NS_OFFSET = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 32
+const val FRAME_METRICS_SIZE = FRAME_METRICS_TRACKED_TARGETS_OFFSET + 36
+
+/* メトリクスブロックを out (FRAME_METRICS_SIZE / 4 個) にコピーする。JNI呼び出しもメモリ確保もしない。
+   描画スレッドが更新中で揃ったフレームを読めなかったら false (次のポーリングで読み直す)
+   getIntは順序を保証しないので、フィールドの読み出しが2回のsequenceの読み出しの外に出ないようにフェンスで挟む */
+fun readFrameMetrics(metrics: ByteBuffer, out: IntArray): Boolean {
+    repeat(3) {
+        val sequence = metrics.getInt(FRAME_METRICS_SEQUENCE_OFFSET)
+        if (sequence % 2 != 0)
+            return@repeat
+        VarHandle.acquireFence()
+        for (idx in out.indices)
+            out[idx] = metrics.getInt(idx * 4)
+        VarHandle.acquireFence()
+        if (metrics.getInt(FRAME_METRICS_SEQUENCE_OFFSET) == sequence)
+            return true
+    }
+    return false
+}
+
 external fun initRendering()
-external fun setTextures(astronautWidth: Int, astronautHeight: Int, astronautBytes: ByteBuffer, pauseWidth: Int, pauseHeight: Int, pauseBytes: ByteBuffer)
 external fun configureRendering(width: Int, height: Int, orientation: Int, rotation: Int) : Boolean
 external fun renderFrame(nowTargetName: String) : String
+external fun renderFrameIds(nowPlayingId: Int) : Int
+external fun setFrameResultBuffer(buffer: ByteBuffer?)
+external fun getTargetNames() : Array<String>
 external fun deinitRendering()
 external fun initAR(activity: Activity, assetManager: AssetManager, target: Int)
 external fun deinitAR()
@@ -16,7 +71,55 @@ external fun stopAR()
 external fun cameraPerformAutoFocus()
 external fun cameraRestoreAutoFocus()
 external fun checkHit(x: Float, y: Float, screenW: Float, screenH: Float): String
+external fun checkHitId(x: Float, y: Float, screenW: Float, screenH: Float): Int
+/* checkHitId()と同じ判定で、当たった位置の動画テクスチャ座標(左上0,0～右下1,1)をuv[0],uv[1]に返す */
+external fun checkHitUv(x: Float, y: Float, screenW: Float, screenH: Float, uv: FloatArray): Int
 external fun initVideoTexture(): Int
 external fun nativeOnSurfaceChanged(width: Int, height: Int)
 external fun nativeSetVideoSize(width: Int, height: Int)
 external fun setFullScreenMode(isFullScreenMode: Boolean)
+/* true: 姿勢計算を専用スレッドで行い、描画スレッドは最新結果を描くだけにする (startAR前後どちらでも可) */
+external fun setTrackingThreadEnabled(enabled: Boolean)
+/* true: ターゲットの姿勢を表示される時刻まで外挿して描く。displayLatencyMs は実測できない分(撮像→取得, 描画→表示)の遅延 */
+external fun setPosePrediction(enabled: Boolean, displayLatencyMs: Int)
+/* 描画の各段階とカメラ→表示の遅延(直近512フレーム)。ステージ(prepare, observations, draw, finish, frame, camera_age, total)ごとに [count, p50, p95, p99, max] (us) */
+external fun getLatencyStats(): FloatArray
+/* getLatencyStats()の配列のレイアウト (LatencyStats.h 参照)。ステージ i の値は [i * LATENCY_STATS_VALUES_PER_STAGE + LATENCY_STATS_*] */
+const val LATENCY_STATS_STAGE_COUNT = 7
+const val LATENCY_STATS_STAGE_CAMERA_AGE = 5
+const val LATENCY_STATS_STAGE_TOTAL = 6
+const val LATENCY_STATS_VALUES_PER_STAGE = 5
+const val LATENCY_STATS_COUNT = 0
+const val LATENCY_STATS_P50 = 1
+const val LATENCY_STATS_P95 = 2
+const val LATENCY_STATS_P99 = 3
+const val LATENCY_STATS_MAX = 4
+/* 上記と生のサンプルをテキストで path に書き出す */
+external fun dumpLatencyStats(path: String): Boolean
+/* ネイティブのスレッドの役割(render, tracking, worker, background, 役割なし)ごとに [スレッド数, CPU時間(s)]。役割なしにはKotlinやExoPlayerのスレッドも入る */
+external fun getThreadRoleUsage(): FloatArray
+/* 直近のトレースイベントを Chrome/Perfetto 形式の JSON で path に書き出す(ネイティブのワーカーで書くので戻った時点では未完了)。トレース無効のビルド(リリース)では false */
+external fun dumpTrace(path: String): Boolean
+/* true: FPS・フレーム時間のグラフ・各段階の時間・追跡中のターゲットを画面に重ねて表示する (描画スレッドで次のフレームから反映) */
+external fun setHudEnabled(enabled: Boolean)
+/* ネイティブのメトリクスブロック (FRAME_METRICS_*)。一度取得してネイティブバイトオーダーで保持し、readFrameMetrics()でポーリングする */
+external fun getMetricsBuffer(): ByteBuffer
+/* 起動時のアセット読み込み(モデル・テクスチャのデコード・マニフェスト)をワーカースレッドで始める。initARより前に呼ぶ(呼ばなければinitARで始まる) */
+external fun startInitPipeline(assetManager: AssetManager)
+/* データセットXMLのImageTarget名(ファイル順)。読み込みが終わるまで待つのでUIスレッドからは呼ばない */
+external fun getManifestTargetNames(): Array<String>
+/* 起動フェーズの計測。beginStartupPhaseの戻り値をendStartupPhaseに渡す (startupPhase { } を使う) */
+external fun beginStartupPhase(name: String): Int
+external fun endStartupPhase(phase: Int)
+/* 起動フェーズのタイムライン(開始順, 最初のフェーズからのms)をテキストで path に書き出す */
+external fun dumpStartupTimeline(path: String): Boolean
+
+/* block を起動フェーズ name として計測する */
+inline fun <T> startupPhase(name: String, block: () -> T): T {
+    val phase = beginStartupPhase(name)
+    try {
+        return block()
+    } finally {
+        endStartupPhase(phase)
+    }
+}